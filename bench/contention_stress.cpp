@@ -0,0 +1,472 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+// 冷单元上的竞争压力测试：同时释放大量线程，按比例混合 get / reset / reload，
+// 报告吞吐和等待时间分布，用于在多核机器上验证新的同步策略
+//
+// Lazy::reset 不能与同一单元上的 get 并发，因此运行被分成若干轮：每轮先是只有 get 的读取阶段，
+// 读取阶段抽到的 reset / reload 被推迟到之后的重置阶段执行，两个阶段之间用屏障隔开；
+// reload 在重置阶段重置单元，在下一轮读取阶段开始时读取（计入冷读取）
+//
+
+#include <cxxlazy/components/access_trace.h>
+#include <cxxlazy/components/lazy.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace components;
+
+namespace
+{
+    /**
+     * @brief 以 2 的幂为桶边界的延迟直方图（纳秒）
+     */
+    struct Histogram
+    {
+        static constexpr int kBuckets = 48;
+        std::array<std::uint64_t, kBuckets> counts{};
+        std::uint64_t total = 0;
+        std::uint64_t max_ns = 0;
+
+        void record(std::uint64_t ns)
+        {
+            int b = 0;
+            while (b + 1 < kBuckets && (1ULL << (b + 1)) <= ns)
+                ++b;
+            counts[static_cast<std::size_t>(b)]++;
+            total++;
+            max_ns = std::max(max_ns, ns);
+        }
+
+        void merge(const Histogram& other)
+        {
+            for (std::size_t i = 0; i < counts.size(); ++i)
+                counts[i] += other.counts[i];
+            total += other.total;
+            max_ns = std::max(max_ns, other.max_ns);
+        }
+
+        /**
+         * @brief 分位数所在桶的上界
+         */
+        [[nodiscard]] std::uint64_t percentile(double q) const
+        {
+            if (total == 0)
+                return 0;
+            auto target = static_cast<std::uint64_t>(q * static_cast<double>(total));
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < counts.size(); ++i)
+            {
+                seen += counts[i];
+                if (seen > target)
+                    return std::min<std::uint64_t>(max_ns, (2ULL << i) - 1);
+            }
+            return max_ns;
+        }
+    };
+
+    /**
+     * @brief 初始化函数耗时分布
+     */
+    struct InitDistribution
+    {
+        enum class Kind { Fixed, Uniform, Exponential } kind = Kind::Fixed;
+        double a_us = 100.0;
+        double b_us = 100.0;
+        bool spin = false;
+
+        std::chrono::nanoseconds sample(std::mt19937_64& rng) const
+        {
+            double us = a_us;
+            if (kind == Kind::Uniform)
+                us = std::uniform_real_distribution<double>(a_us, b_us)(rng);
+            else if (kind == Kind::Exponential)
+                us = std::exponential_distribution<double>(1.0 / a_us)(rng);
+            return std::chrono::nanoseconds(static_cast<std::int64_t>(us * 1000.0));
+        }
+
+        void run(std::chrono::nanoseconds d) const
+        {
+            if (!spin)
+            {
+                std::this_thread::sleep_for(d);
+                return;
+            }
+            auto end = std::chrono::steady_clock::now() + d;
+            while (std::chrono::steady_clock::now() < end)
+            {
+            }
+        }
+    };
+
+    struct Options
+    {
+        int threads = 256;
+        int cells = 16;
+        int ops = 2000;
+        int rounds = 10;
+        int get_ratio = 90;
+        int reset_ratio = 5;
+        int reload_ratio = 5;
+        InitDistribution init;
+        bool pin = false;
+        std::string json_path;
+        std::string trace_path;
+    };
+
+    /// @brief 每个线程各自的统计，结束后合并
+    struct ThreadStats
+    {
+        Histogram hit;
+        Histogram cold;
+        Histogram reset;
+        std::uint64_t gets = 0;
+        std::uint64_t resets = 0;
+        std::uint64_t reloads = 0;
+    };
+
+    /**
+     * @brief 可重复使用的线程屏障（C++17 没有 std::barrier）
+     */
+    class Barrier
+    {
+    public:
+        explicit Barrier(int count) : count_(count)
+        {
+        }
+
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            const std::uint64_t generation = generation_;
+            if (++arrived_ == count_)
+            {
+                arrived_ = 0;
+                ++generation_;
+                cv_.notify_all();
+                return;
+            }
+            cv_.wait(lock, [&] { return generation_ != generation; });
+        }
+
+    private:
+        std::mutex mtx_;
+        std::condition_variable cv_;
+        const int count_;
+        int arrived_ = 0;
+        std::uint64_t generation_ = 0;
+    };
+
+    [[noreturn]] void usage()
+    {
+        std::cerr << "usage: contention_stress [--threads=N] [--cells=N] [--ops=N] [--rounds=N]\n"
+            "                         [--mix=get:90,reset:5,reload:5]\n"
+            "                         [--init=fixed:US | uniform:US:US | exp:US] [--spin] [--pin]\n"
+            "                         [--json=PATH] [--trace=PATH]\n"
+            "\n"
+            "reset must not run concurrently with get on the same cell, so each of the --rounds rounds\n"
+            "is a get-only phase followed by a reset phase, separated by barriers. reset/reload ops drawn\n"
+            "during a round are deferred to its reset phase; a reload's cold get runs at the start of the\n"
+            "next round. Throughput includes the barrier waits.\n";
+        std::exit(2);
+    }
+
+    InitDistribution parse_init(const std::string& spec)
+    {
+        InitDistribution d;
+        std::vector<std::string> parts;
+        std::stringstream ss(spec);
+        std::string item;
+        while (std::getline(ss, item, ':'))
+            parts.push_back(item);
+        if (parts.size() == 2 && parts[0] == "fixed")
+            d.a_us = d.b_us = std::stod(parts[1]);
+        else if (parts.size() == 3 && parts[0] == "uniform")
+        {
+            d.kind = InitDistribution::Kind::Uniform;
+            d.a_us = std::stod(parts[1]);
+            d.b_us = std::stod(parts[2]);
+        }
+        else if (parts.size() == 2 && parts[0] == "exp")
+        {
+            d.kind = InitDistribution::Kind::Exponential;
+            d.a_us = std::stod(parts[1]);
+        }
+        else
+            usage();
+        return d;
+    }
+
+    void parse_mix(const std::string& spec, Options& o)
+    {
+        o.get_ratio = o.reset_ratio = o.reload_ratio = 0;
+        std::stringstream ss(spec);
+        std::string item;
+        while (std::getline(ss, item, ','))
+        {
+            auto colon = item.find(':');
+            if (colon == std::string::npos)
+                usage();
+            int value = std::atoi(item.c_str() + colon + 1);
+            std::string key = item.substr(0, colon);
+            if (key == "get")
+                o.get_ratio = value;
+            else if (key == "reset")
+                o.reset_ratio = value;
+            else if (key == "reload")
+                o.reload_ratio = value;
+            else
+                usage();
+        }
+        if (o.get_ratio + o.reset_ratio + o.reload_ratio <= 0)
+            usage();
+    }
+
+    Options parse(int argc, char** argv)
+    {
+        Options o;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&](const char* prefix) -> const char* {
+                auto n = std::char_traits<char>::length(prefix);
+                return arg.compare(0, n, prefix) == 0 ? arg.c_str() + n : nullptr;
+            };
+            if (auto v = value("--threads="))
+                o.threads = std::max(1, std::atoi(v));
+            else if (auto v = value("--cells="))
+                o.cells = std::max(1, std::atoi(v));
+            else if (auto v = value("--ops="))
+                o.ops = std::max(1, std::atoi(v));
+            else if (auto v = value("--rounds="))
+                o.rounds = std::max(1, std::atoi(v));
+            else if (auto v = value("--mix="))
+                parse_mix(v, o);
+            else if (auto v = value("--init="))
+                o.init = parse_init(v);
+            else if (auto v = value("--json="))
+                o.json_path = v;
+            else if (auto v = value("--trace="))
+                o.trace_path = v;
+            else if (arg == "--spin")
+                o.init.spin = true;
+            else if (arg == "--pin")
+                o.pin = true;
+            else
+                usage();
+        }
+        return o;
+    }
+
+    void pin_to_cpu(int index)
+    {
+#if defined(__linux__)
+        int cpus = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % cpus, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+    }
+
+    void print_histogram(std::ostream& os, const char* name, const Histogram& h)
+    {
+        os << "  " << name << ": n=" << h.total << " p50=" << h.percentile(0.5) << "ns p90=" << h.percentile(0.9)
+            << "ns p99=" << h.percentile(0.99) << "ns p99.9=" << h.percentile(0.999) << "ns max=" << h.max_ns
+            << "ns\n";
+    }
+
+    void json_histogram(std::ostream& os, const char* name, const Histogram& h)
+    {
+        os << "\"" << name << "\": {\"count\": " << h.total << ", \"p50_ns\": " << h.percentile(0.5)
+            << ", \"p90_ns\": " << h.percentile(0.9) << ", \"p99_ns\": " << h.percentile(0.99)
+            << ", \"p999_ns\": " << h.percentile(0.999) << ", \"max_ns\": " << h.max_ns << ", \"buckets\": [";
+        for (std::size_t i = 0; i < h.counts.size(); ++i)
+            os << (i ? ", " : "") << h.counts[i];
+        os << "]}";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const Options o = parse(argc, argv);
+
+    std::vector<std::unique_ptr<Lazy<std::uint64_t>>> cells;
+    for (int c = 0; c < o.cells; ++c)
+    {
+        cells.push_back(std::make_unique<Lazy<std::uint64_t>>("stress_" + std::to_string(c), [&o, c] {
+            thread_local std::mt19937_64 rng(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            o.init.run(o.init.sample(rng));
+            return static_cast<std::uint64_t>(c);
+        }));
+    }
+
+    std::mutex gate_mtx;
+    std::condition_variable gate;
+    bool go = false;
+    std::atomic<int> ready{0};
+    Barrier phase(o.threads);
+    std::vector<ThreadStats> stats(static_cast<std::size_t>(o.threads));
+
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<std::size_t>(o.threads));
+    for (int t = 0; t < o.threads; ++t)
+    {
+        threads.emplace_back([&, t] {
+            if (o.pin)
+                pin_to_cpu(t);
+            std::mt19937_64 rng(static_cast<std::uint64_t>(t) * 0x9e3779b97f4a7c15ULL + 1);
+            std::uniform_int_distribution<int> pick_cell(0, o.cells - 1);
+            std::uniform_int_distribution<int> pick_op(0, o.get_ratio + o.reset_ratio + o.reload_ratio - 1);
+            auto& s = stats[static_cast<std::size_t>(t)];
+
+            {
+                std::unique_lock<std::mutex> lock(gate_mtx);
+                ready++;
+                gate.wait(lock, [&] { return go; });
+            }
+
+            // 每个阶段只做一类操作：读取阶段只有 get，重置阶段只有 reset，单元不会在被读取时被重置
+            std::vector<Lazy<std::uint64_t>*> pending_resets;
+            std::vector<Lazy<std::uint64_t>*> pending_reloads;
+            std::vector<Lazy<std::uint64_t>*> reload_next;
+            auto cold_get = [&](Lazy<std::uint64_t>& cell) {
+                const auto start = std::chrono::steady_clock::now();
+                volatile std::uint64_t v = cell.get();
+                (void)v;
+                s.cold.record(static_cast<std::uint64_t>((std::chrono::steady_clock::now() - start).count()));
+                s.reloads++;
+            };
+
+            for (int round = 0; round < o.rounds; ++round)
+            {
+                for (auto* cell : reload_next)
+                    cold_get(*cell);
+                reload_next.clear();
+
+                const int ops = o.ops / o.rounds + (round < o.ops % o.rounds ? 1 : 0);
+                for (int i = 0; i < ops; ++i)
+                {
+                    auto& cell = *cells[static_cast<std::size_t>(pick_cell(rng))];
+                    const int op = pick_op(rng);
+                    if (op < o.get_ratio)
+                    {
+                        const auto start = std::chrono::steady_clock::now();
+                        const bool warm = cell.is_initialized();
+                        volatile std::uint64_t v = cell.get();
+                        (void)v;
+                        auto ns = static_cast<std::uint64_t>((std::chrono::steady_clock::now() - start).count());
+                        (warm ? s.hit : s.cold).record(ns);
+                        s.gets++;
+                    }
+                    else if (op < o.get_ratio + o.reset_ratio)
+                        pending_resets.push_back(&cell);
+                    else
+                        pending_reloads.push_back(&cell);
+                }
+                phase.wait();
+
+                for (auto* cell : pending_resets)
+                {
+                    const auto start = std::chrono::steady_clock::now();
+                    cell->reset();
+                    s.reset.record(static_cast<std::uint64_t>((std::chrono::steady_clock::now() - start).count()));
+                    s.resets++;
+                }
+                for (auto* cell : pending_reloads)
+                {
+                    cell->reset();
+                    reload_next.push_back(cell);
+                }
+                pending_resets.clear();
+                pending_reloads.clear();
+                phase.wait();
+            }
+            for (auto* cell : reload_next)
+                cold_get(*cell);
+        });
+    }
+
+    while (ready.load() != o.threads)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (!o.trace_path.empty() && !trace::start(o.trace_path))
+        std::cerr << "contention_stress: cannot trace to " << o.trace_path << "\n";
+    const auto start = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(gate_mtx);
+        go = true;
+    }
+    gate.notify_all();
+    for (auto& t : threads)
+        t.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    trace::stop();
+    if (!o.trace_path.empty() && trace::dropped_events() > 0)
+        std::cerr << "contention_stress: trace dropped " << trace::dropped_events() << " events\n";
+
+    ThreadStats total;
+    for (const auto& s : stats)
+    {
+        total.hit.merge(s.hit);
+        total.cold.merge(s.cold);
+        total.reset.merge(s.reset);
+        total.gets += s.gets;
+        total.resets += s.resets;
+        total.reloads += s.reloads;
+    }
+
+    std::uint64_t inits = 0, waits = 0;
+    for (const auto& cell : cells)
+    {
+        auto snap = cell->stats()->snapshot();
+        inits += snap.init_count;
+        waits += snap.wait_count;
+    }
+
+    const auto ops = static_cast<double>(total.gets + total.resets + total.reloads);
+    std::cout << "threads=" << o.threads << " cells=" << o.cells << " ops/thread=" << o.ops << " rounds=" << o.rounds
+        << " mix=get:" << o.get_ratio << ",reset:" << o.reset_ratio << ",reload:" << o.reload_ratio
+        << (o.pin ? " pinned" : "") << "\n";
+    std::cout << "  elapsed=" << seconds << "s throughput=" << static_cast<std::uint64_t>(ops / seconds) << " ops/s"
+        << " initializations=" << inits << " waits=" << waits << "\n";
+    print_histogram(std::cout, "get (hit)     ", total.hit);
+    print_histogram(std::cout, "get (cold)    ", total.cold);
+    print_histogram(std::cout, "reset         ", total.reset);
+
+    if (!o.json_path.empty())
+    {
+        std::ofstream out(o.json_path);
+        out << "{\"threads\": " << o.threads << ", \"cells\": " << o.cells << ", \"ops_per_thread\": " << o.ops
+            << ", \"rounds\": " << o.rounds
+            << ", \"pinned\": " << (o.pin ? "true" : "false") << ", \"seconds\": " << seconds
+            << ", \"ops_per_sec\": " << ops / seconds << ", \"initializations\": " << inits
+            << ", \"waits\": " << waits << ", ";
+        json_histogram(out, "get_hit", total.hit);
+        out << ", ";
+        json_histogram(out, "get_cold", total.cold);
+        out << ", ";
+        json_histogram(out, "reset", total.reset);
+        out << "}\n";
+    }
+    return 0;
+}
@@ -0,0 +1,220 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+// 内存占用基准：为每种单元类型和若干值大小构造大量实例，
+// 报告构造后和全部初始化后的 RSS 增量以及每个单元的平均字节数
+//
+
+#include <cxxlazy/components/lazy.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace components;
+
+namespace
+{
+    template <std::size_t N>
+    struct Blob
+    {
+        std::array<std::uint8_t, N> bytes;
+    };
+
+    template <typename T>
+    T make_value()
+    {
+        return T{};
+    }
+
+    template <>
+    std::uint32_t make_value<std::uint32_t>()
+    {
+        return 42;
+    }
+
+    struct Options
+    {
+        std::size_t count = 10000000;
+        std::string filter;
+        std::string json_path;
+    };
+
+    /// @brief 一个用例的测量结果
+    struct Row
+    {
+        std::string name;
+        std::size_t size = 0;
+        std::int64_t rss_constructed = 0;
+        std::int64_t rss_initialized = 0;
+        double construct_s = 0;
+        double init_s = 0;
+    };
+
+    /// @brief 一个用例：单元类型的大小，以及在给定位置构造、初始化、析构一个实例的方法
+    struct Case
+    {
+        std::string name;
+        std::size_t size;
+        std::size_t align;
+        std::function<void(void*)> construct;
+        std::function<void(void*)> initialize;
+        std::function<void(void*)> destroy;
+    };
+
+    template <typename Cell, typename Init>
+    Case make_case(std::string name, Init init)
+    {
+        return Case{std::move(name), sizeof(Cell), alignof(Cell),
+                    [](void* p) {
+                        if constexpr (std::is_default_constructible_v<Cell>)
+                            new(p) Cell();
+                        else
+                            new(p) Cell(&make_value<typename Cell::InitFn::result_type>);
+                    },
+                    [init](void* p) { init(*static_cast<Cell*>(p)); },
+                    [](void* p) { static_cast<Cell*>(p)->~Cell(); }};
+    }
+
+    template <typename T>
+    void add_cell_cases(std::vector<Case>& cases, const std::string& type)
+    {
+        cases.push_back(make_case<OnceCell<T>>("OnceCell<" + type + ">", [](OnceCell<T>& c) {
+            c.get_or_init(&make_value<T>);
+        }));
+        cases.push_back(make_case<Lazy<T>>("Lazy<" + type + ">", [](Lazy<T>& c) { c.get(); }));
+    }
+
+    std::vector<Case> all_cases()
+    {
+        std::vector<Case> cases;
+        cases.push_back(make_case<OnceCall>("OnceCall", [](OnceCall& c) { c.call([] {}); }));
+        cases.push_back(make_case<Lazy<void>>("Lazy<void>", [](Lazy<void>& c) { c.get(); }));
+        add_cell_cases<std::uint32_t>(cases, "uint32_t");
+        add_cell_cases<Blob<64>>(cases, "Blob<64>");
+        add_cell_cases<Blob<256>>(cases, "Blob<256>");
+        return cases;
+    }
+
+    [[noreturn]] void usage()
+    {
+        std::cerr << "usage: footprint_bench [--count=N] [--filter=SUBSTR] [--json=PATH]\n";
+        std::exit(2);
+    }
+
+    Options parse(int argc, char** argv)
+    {
+        Options o;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&](const char* prefix) -> const char* {
+                auto n = std::char_traits<char>::length(prefix);
+                return arg.compare(0, n, prefix) == 0 ? arg.c_str() + n : nullptr;
+            };
+            if (auto v = value("--count="))
+                o.count = std::max<std::size_t>(1, std::strtoull(v, nullptr, 10));
+            else if (auto v = value("--filter="))
+                o.filter = v;
+            else if (auto v = value("--json="))
+                o.json_path = v;
+            else
+                usage();
+        }
+        return o;
+    }
+
+    /**
+     * @brief 当前进程的常驻内存（字节），读取 /proc/self/statm
+     */
+    std::int64_t rss_bytes()
+    {
+        std::ifstream in("/proc/self/statm");
+        std::int64_t size = 0, resident = 0;
+        in >> size >> resident;
+        return resident * static_cast<std::int64_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    double seconds_since(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    Row run(const Case& c, std::size_t count)
+    {
+        Row r;
+        r.name = c.name;
+        r.size = c.size;
+        const std::int64_t before = rss_bytes();
+        auto* storage = static_cast<unsigned char*>(::operator new(c.size * count, std::align_val_t(c.align)));
+
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < count; ++i)
+            c.construct(storage + i * c.size);
+        r.construct_s = seconds_since(start);
+        r.rss_constructed = rss_bytes() - before;
+
+        start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < count; ++i)
+            c.initialize(storage + i * c.size);
+        r.init_s = seconds_since(start);
+        r.rss_initialized = rss_bytes() - before;
+
+        for (std::size_t i = 0; i < count; ++i)
+            c.destroy(storage + i * c.size);
+        ::operator delete(storage, std::align_val_t(c.align));
+        return r;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const Options o = parse(argc, argv);
+    const double n = static_cast<double>(o.count);
+
+    std::printf("count=%zu\n", o.count);
+    std::printf("%-20s %7s %14s %14s %13s %13s %11s %9s\n", "cell", "sizeof", "rss_built_MiB", "rss_init_MiB",
+                "bytes/cell", "bytes/init", "construct_s", "init_s");
+    std::vector<Row> rows;
+    for (const auto& c : all_cases())
+    {
+        if (!o.filter.empty() && c.name.find(o.filter) == std::string::npos)
+            continue;
+        Row r = run(c, o.count);
+        std::printf("%-20s %7zu %14.1f %14.1f %13.1f %13.1f %11.3f %9.3f\n", r.name.c_str(), r.size,
+                    static_cast<double>(r.rss_constructed) / (1 << 20),
+                    static_cast<double>(r.rss_initialized) / (1 << 20),
+                    static_cast<double>(r.rss_constructed) / n, static_cast<double>(r.rss_initialized) / n,
+                    r.construct_s, r.init_s);
+        std::fflush(stdout);
+        rows.push_back(std::move(r));
+    }
+
+    if (!o.json_path.empty())
+    {
+        std::ofstream out(o.json_path);
+        out << "{\"count\": " << o.count << ", \"results\": [";
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            const auto& r = rows[i];
+            out << (i ? ", " : "") << "{\"cell\": \"" << r.name << "\", \"sizeof\": " << r.size
+                << ", \"rss_constructed_bytes\": " << r.rss_constructed
+                << ", \"rss_initialized_bytes\": " << r.rss_initialized
+                << ", \"bytes_per_cell\": " << static_cast<double>(r.rss_constructed) / n
+                << ", \"bytes_per_initialized_cell\": " << static_cast<double>(r.rss_initialized) / n
+                << ", \"construct_s\": " << r.construct_s << ", \"init_s\": " << r.init_s << "}";
+        }
+        out << "]}\n";
+    }
+    return 0;
+}
@@ -0,0 +1,238 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#include "harness.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+
+namespace bench
+{
+    namespace
+    {
+        bool starts_with(const std::string& s, const std::string& prefix)
+        {
+            return s.rfind(prefix, 0) == 0;
+        }
+
+        std::string json_string(const std::string& s)
+        {
+            std::string out = "\"";
+            for (char c : s)
+            {
+                if (c == '"' || c == '\\')
+                    out += '\\';
+                out += c;
+            }
+            return out + "\"";
+        }
+
+        std::string describe(const Params& params)
+        {
+            std::string out;
+            for (const auto& [k, v] : params)
+                out += (out.empty() ? "" : " ") + k + "=" + v;
+            return out;
+        }
+    }
+
+    Harness::Harness(int argc, char** argv)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (starts_with(arg, "--filter="))
+                filter_ = arg.substr(9);
+            else if (starts_with(arg, "--min-time="))
+                min_time_ = std::chrono::milliseconds(std::atoi(arg.c_str() + 11));
+            else if (starts_with(arg, "--rounds="))
+                rounds_ = std::max(1, std::atoi(arg.c_str() + 9));
+            else if (starts_with(arg, "--json="))
+                json_path_ = arg.substr(7);
+            else if (arg == "--perf")
+                perf_ = true;
+            else if (starts_with(arg, "--threads="))
+            {
+                std::stringstream ss(arg.substr(10));
+                std::string item;
+                while (std::getline(ss, item, ','))
+                    thread_counts_.push_back(std::max(1, std::atoi(item.c_str())));
+            }
+            else
+            {
+                std::cerr << "unknown argument: " << arg << "\n";
+                std::exit(2);
+            }
+        }
+
+        if (thread_counts_.empty())
+        {
+            int hw = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+            for (int t = 1; t < hw; t *= 2)
+                thread_counts_.push_back(t);
+            thread_counts_.push_back(hw);
+        }
+
+        // JSON 写到标准输出时，表格改写到标准错误输出
+        table_ = json_path_ == "-" ? stderr : stdout;
+
+        if (perf_ && !PerfCounters::available(&perf_note_))
+        {
+            std::fprintf(stderr, "warning: hardware counters disabled: %s\n", perf_note_.c_str());
+            perf_ = false;
+        }
+
+        std::fprintf(table_, "%-40s %-28s %7s %14s %14s %12s", "benchmark", "params", "threads", "ns/op", "ops/s",
+                     "p99 ns");
+        if (perf_)
+        {
+            for (std::size_t i = 0; i < kCounterCount; ++i)
+                std::fprintf(table_, " %16s", (std::string(PerfCounters::name(i)) + "/op").c_str());
+        }
+        std::fprintf(table_, "\n");
+    }
+
+    bool Harness::enabled(const std::string& name) const
+    {
+        return filter_.empty() || name.find(filter_) != std::string::npos;
+    }
+
+    double Harness::run_parallel(int threads, const std::function<void(int)>& body, CounterValues* counters)
+    {
+        std::atomic<int> ready{0};
+        std::atomic<int> done{0};
+        std::atomic<bool> go{false};
+        std::mutex counters_mtx;
+
+        std::vector<std::thread> workers;
+        workers.reserve(static_cast<std::size_t>(threads));
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t] {
+                // 计数器按线程打开，只统计 body 本身，不包括线程创建和主线程的等待
+                std::optional<PerfCounters> perf;
+                if (counters)
+                    perf.emplace();
+                ready.fetch_add(1, std::memory_order_acq_rel);
+                while (!go.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                if (perf)
+                    perf->start();
+                body(t);
+                if (perf)
+                    perf->stop();
+                done.fetch_add(1, std::memory_order_acq_rel);
+                if (perf)
+                {
+                    CounterValues values = perf->read();
+                    std::lock_guard<std::mutex> lock(counters_mtx);
+                    *counters += values;
+                }
+            });
+        }
+
+        while (ready.load(std::memory_order_acquire) != threads)
+            std::this_thread::yield();
+        auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        while (done.load(std::memory_order_acquire) != threads)
+            std::this_thread::yield();
+        auto end = std::chrono::steady_clock::now();
+
+        for (auto& w : workers)
+            w.join();
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    void Harness::add(Result result)
+    {
+        std::string p99 = result.round_ns.empty() ? "-" : std::to_string(static_cast<long long>(result.round_ns[3]));
+        std::fprintf(table_, "%-40s %-28s %7d %14.2f %14.0f %12s", result.name.c_str(),
+                     describe(result.params).c_str(), result.threads, result.ns_per_op, result.ops_per_sec, p99.c_str());
+        if (perf_)
+        {
+            for (std::size_t i = 0; i < kCounterCount; ++i)
+            {
+                if (result.counters.valid[i])
+                    std::fprintf(table_, " %16.3f", result.counters.values[i] / result.counter_divisor);
+                else
+                    std::fprintf(table_, " %16s", "-");
+            }
+        }
+        std::fprintf(table_, "\n");
+        std::fflush(table_);
+        results_.push_back(std::move(result));
+    }
+
+    void Harness::write_json(std::ostream& os) const
+    {
+        os << std::setprecision(6);
+        os << "{\n  \"context\": {\"hardware_concurrency\": " << std::thread::hardware_concurrency()
+#if defined(__VERSION__)
+            << ", \"compiler\": " << json_string(__VERSION__)
+#endif
+            << ", \"min_time_ms\": " << min_time_.count() << ", \"rounds\": " << rounds_
+            << ", \"perf_counters\": " << (perf_ ? "true" : "false");
+        if (!perf_note_.empty())
+            os << ", \"perf_note\": " << json_string(perf_note_);
+        os << "},\n";
+        os << "  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results_.size(); ++i)
+        {
+            const auto& r = results_[i];
+            os << (i ? ",\n" : "\n") << "    {\"name\": " << json_string(r.name) << ", \"threads\": " << r.threads;
+            for (const auto& [k, v] : r.params)
+                os << ", " << json_string(k) << ": " << json_string(v);
+            os << ", \"operations\": " << r.operations << ", \"seconds\": " << r.seconds
+                << ", \"ns_per_op\": " << r.ns_per_op << ", \"ops_per_sec\": " << r.ops_per_sec;
+            if (!r.round_ns.empty())
+            {
+                os << ", \"round_ns\": {\"min\": " << r.round_ns[0] << ", \"p50\": " << r.round_ns[1]
+                    << ", \"p90\": " << r.round_ns[2] << ", \"p99\": " << r.round_ns[3]
+                    << ", \"max\": " << r.round_ns[4] << "}";
+            }
+            if (perf_)
+            {
+                os << ", \"counters_per_op\": {";
+                bool first = true;
+                for (std::size_t c = 0; c < kCounterCount; ++c)
+                {
+                    if (!r.counters.valid[c])
+                        continue;
+                    os << (first ? "" : ", ") << json_string(PerfCounters::name(c)) << ": "
+                        << r.counters.values[c] / r.counter_divisor;
+                    first = false;
+                }
+                os << "}";
+            }
+            os << "}";
+        }
+        os << "\n  ]\n}\n";
+    }
+
+    int Harness::finish()
+    {
+        if (json_path_.empty())
+            return 0;
+        if (json_path_ == "-")
+        {
+            write_json(std::cout);
+            return 0;
+        }
+        std::ofstream out(json_path_);
+        if (!out)
+        {
+            std::cerr << "cannot open " << json_path_ << "\n";
+            return 1;
+        }
+        write_json(out);
+        return 0;
+    }
+}
@@ -0,0 +1,218 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include "perf_counters.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+    /// @brief 一组基准参数，例如 {"value_size", "64"}
+    using Params = std::vector<std::pair<std::string, std::string>>;
+
+    /**
+     * @brief 一次基准测试的结果
+     */
+    struct Result
+    {
+        std::string name;
+        Params params;
+        int threads = 1;
+        /// @brief 所有线程执行的操作总数
+        std::uint64_t operations = 0;
+        /// @brief 墙钟时间（秒）
+        double seconds = 0.0;
+        /// @brief 单个线程视角下每次操作的平均耗时（纳秒）；按轮测量时为每轮的平均耗时
+        double ns_per_op = 0.0;
+        /// @brief 所有线程合计的吞吐量
+        double ops_per_sec = 0.0;
+        /// @brief 按轮测量时每轮耗时的分位数（纳秒），按吞吐测量时为空
+        std::vector<double> round_ns;
+        /// @brief 所有线程合计的计数器读数，未开启 `--perf` 时全部无效
+        CounterValues counters;
+        /// @brief 计数器的归一化单位：按吞吐测量时为操作总数，按轮测量时为轮数
+        double counter_divisor = 1.0;
+    };
+
+    /**
+     * @brief 阻止编译器把基准中的计算优化掉
+     */
+    template <typename T>
+    inline void do_not_optimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    /**
+     * @class Harness
+     * @brief 极简的多线程微基准框架
+     * @details
+     * 支持两种测量方式：
+     * - run_throughput：每个线程反复执行同一操作，自动增加迭代次数直到超过最短测量时间
+     * - run_rounds：每轮重新准备状态，然后同时释放所有线程执行一次操作，测量整轮耗时
+     * 结果以表格写到标准输出，并可以用 `--json=<path>` 写成 JSON
+     *
+     * 命令行参数：
+     * - `--filter=<substr>` 只运行名称包含 substr 的基准
+     * - `--min-time=<ms>` 每个吞吐基准的最短测量时间，默认 100
+     * - `--rounds=<n>` 每个按轮基准的轮数，默认 200
+     * - `--threads=<a,b,c>` 覆盖线程数扫描
+     * - `--json=<path>` JSON 输出路径，`-` 表示标准输出
+     * - `--perf` 用 perf_event_open 计数器包裹每次测量，报告每次操作的
+     *   cycles、instructions、cache misses、branch misses 和 context switches；
+     *   计数器不可用时给出提示并照常运行
+     */
+    class Harness
+    {
+    public:
+        Harness(int argc, char** argv);
+
+        /**
+         * @brief 要扫描的线程数，默认是 1 到硬件线程数之间的 2 的幂
+         */
+        [[nodiscard]] const std::vector<int>& thread_counts() const { return thread_counts_; }
+
+        /**
+         * @brief 该名称的基准是否需要运行
+         */
+        [[nodiscard]] bool enabled(const std::string& name) const;
+
+        /**
+         * @brief 测量稳态操作的吞吐
+         * @param op 签名为 `void(int thread_index)`，每次调用执行一次操作
+         */
+        template <typename Op>
+        void run_throughput(const std::string& name, const Params& params, int threads, Op op);
+
+        /**
+         * @brief 按轮测量一次性事件，例如冷启动时的竞争初始化
+         * @param setup 每轮开始前在主线程上调用，准备新的状态
+         * @param op 签名为 `void(int thread_index)`，每轮每个线程调用一次
+         * @param teardown 每轮结束后在主线程上调用
+         */
+        template <typename Setup, typename Op, typename Teardown>
+        void run_rounds(const std::string& name, const Params& params, int threads,
+                        Setup setup, Op op, Teardown teardown);
+
+        /**
+         * @brief 写出所有结果
+         * @return 进程退出码
+         */
+        int finish();
+
+    private:
+        /**
+         * @brief 启动 threads 个线程，同时开始执行 body，返回墙钟时间（秒）
+         * @param counters 不为空时，每个线程在执行 body 期间统计自己的计数器，合计后累加到这里
+         */
+        static double run_parallel(int threads, const std::function<void(int)>& body, CounterValues* counters);
+
+        /**
+         * @brief 开启 `--perf` 时返回用于累加计数器的对象，否则返回空
+         */
+        CounterValues* counters_for(CounterValues& values) const { return perf_ ? &values : nullptr; }
+
+        void add(Result result);
+
+        void write_json(std::ostream& os) const;
+
+        std::string filter_;
+        std::chrono::milliseconds min_time_{100};
+        int rounds_ = 200;
+        std::vector<int> thread_counts_;
+        std::string json_path_;
+        bool perf_ = false;
+        std::string perf_note_;
+        std::FILE* table_ = stdout;
+        std::vector<Result> results_;
+    };
+
+    template <typename Op>
+    void Harness::run_throughput(const std::string& name, const Params& params, int threads, Op op)
+    {
+        if (!enabled(name))
+            return;
+
+        std::uint64_t iterations = 1000;
+        double seconds = 0.0;
+        CounterValues counters;
+        const double min_seconds = std::chrono::duration<double>(min_time_).count();
+        while (true)
+        {
+            counters = CounterValues{};
+            seconds = run_parallel(threads, [&](int tid) {
+                for (std::uint64_t i = 0; i < iterations; ++i)
+                    op(tid);
+            }, counters_for(counters));
+            if (seconds >= min_seconds || iterations >= (1ULL << 40))
+                break;
+            double factor = seconds > 0 ? min_seconds / seconds * 1.2 : 10.0;
+            iterations = static_cast<std::uint64_t>(static_cast<double>(iterations) * std::clamp(factor, 1.5, 10.0));
+        }
+
+        Result r;
+        r.name = name;
+        r.params = params;
+        r.threads = threads;
+        r.operations = iterations * static_cast<std::uint64_t>(threads);
+        r.seconds = seconds;
+        r.ns_per_op = seconds * 1e9 / static_cast<double>(iterations);
+        r.ops_per_sec = static_cast<double>(r.operations) / seconds;
+        r.counters = counters;
+        r.counter_divisor = static_cast<double>(r.operations);
+        add(std::move(r));
+    }
+
+    template <typename Setup, typename Op, typename Teardown>
+    void Harness::run_rounds(const std::string& name, const Params& params, int threads,
+                             Setup setup, Op op, Teardown teardown)
+    {
+        if (!enabled(name))
+            return;
+
+        std::vector<double> samples;
+        samples.reserve(static_cast<std::size_t>(rounds_));
+        double total = 0.0;
+        CounterValues counters;
+        for (int round = 0; round < rounds_; ++round)
+        {
+            setup();
+            double seconds = run_parallel(threads, [&](int tid) { op(tid); }, counters_for(counters));
+            teardown();
+            samples.push_back(seconds * 1e9);
+            total += seconds;
+        }
+        std::sort(samples.begin(), samples.end());
+
+        Result r;
+        r.name = name;
+        r.params = params;
+        r.threads = threads;
+        r.operations = static_cast<std::uint64_t>(rounds_) * static_cast<std::uint64_t>(threads);
+        r.seconds = total;
+        r.ns_per_op = total * 1e9 / rounds_;
+        r.ops_per_sec = static_cast<double>(r.operations) / total;
+        auto at = [&](double q) { return samples[static_cast<std::size_t>(q * static_cast<double>(samples.size() - 1))]; };
+        r.round_ns = {at(0.0), at(0.5), at(0.9), at(0.99), at(1.0)};
+        r.counters = counters;
+        r.counter_divisor = rounds_;
+        add(std::move(r));
+    }
+}
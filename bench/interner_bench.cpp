@@ -0,0 +1,249 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+// 字符串驻留基准：比较 StringInterner（查找不加锁，分片插入）与互斥锁保护的 std::unordered_set<std::string>，
+// 分为两种负载：
+// - lookup：所有字符串预先驻留，各线程随机驻留已存在的字符串；
+// - insert：从空表开始，各线程以不同的顺序驻留同一组字符串，每个字符串只有第一次驻留是插入
+//
+
+#include <cxxlazy/components/string_interner.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace components;
+
+namespace
+{
+    struct Options
+    {
+        std::size_t keys = 200000;
+        std::size_t ops = 1000000;
+        std::vector<int> threads = {1, 4, 8};
+        std::string json_path;
+    };
+
+    [[noreturn]] void usage()
+    {
+        std::cerr << "usage: interner_bench [--keys=N] [--ops=N] [--threads=1,4,8] [--json=PATH]\n";
+        std::exit(2);
+    }
+
+    std::vector<int> parse_list(const char* s)
+    {
+        std::vector<int> out;
+        for (const char* p = s; *p;)
+        {
+            char* end = nullptr;
+            out.push_back(std::max(1, static_cast<int>(std::strtol(p, &end, 10))));
+            if (end == p)
+                usage();
+            p = *end == ',' ? end + 1 : end;
+        }
+        return out;
+    }
+
+    Options parse(int argc, char** argv)
+    {
+        Options o;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&](const char* prefix) -> const char* {
+                auto n = std::char_traits<char>::length(prefix);
+                return arg.compare(0, n, prefix) == 0 ? arg.c_str() + n : nullptr;
+            };
+            if (auto v = value("--keys="))
+                o.keys = std::max<std::size_t>(1, std::strtoull(v, nullptr, 10));
+            else if (auto v = value("--ops="))
+                o.ops = std::max<std::size_t>(1, std::strtoull(v, nullptr, 10));
+            else if (auto v = value("--threads="))
+                o.threads = parse_list(v);
+            else if (auto v = value("--json="))
+                o.json_path = v;
+            else
+                usage();
+        }
+        return o;
+    }
+
+    /**
+     * @brief 对照组：一把互斥锁保护的 std::unordered_set<std::string>
+     * @details 节点式容器中元素的地址稳定，返回的 string_view 与 StringInterner 一样在表析构之前有效
+     */
+    class MutexSetInterner
+    {
+    public:
+        std::string_view intern_view(std::string_view s)
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            return *set_.emplace(s).first;
+        }
+
+    private:
+        std::mutex mtx_;
+        std::unordered_set<std::string> set_;
+    };
+
+    /**
+     * @brief 生成与符号名、标识符相近的字符串
+     */
+    std::vector<std::string> make_keys(std::size_t n)
+    {
+        static const char* const prefixes[] = {"ns::", "http.request.", "metric_", "user/", ""};
+        std::vector<std::string> keys;
+        keys.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            keys.push_back(std::string(prefixes[i % 5]) + "symbol_" + std::to_string(i * 2654435761u % 1000003));
+        return keys;
+    }
+
+    /**
+     * @brief 为每个线程预先生成访问序列（键的下标），计时只包含驻留操作
+     */
+    std::vector<std::vector<std::uint32_t>> make_traces(const Options& o, int threads, bool insert)
+    {
+        std::vector<std::vector<std::uint32_t>> traces(static_cast<std::size_t>(threads));
+        for (int t = 0; t < threads; ++t)
+        {
+            std::mt19937_64 rng(static_cast<std::uint64_t>(t) * 7919 + 1);
+            auto& trace = traces[static_cast<std::size_t>(t)];
+            if (insert)
+            {
+                trace.resize(o.keys);
+                std::iota(trace.begin(), trace.end(), 0u);
+                std::shuffle(trace.begin(), trace.end(), rng);
+            }
+            else
+            {
+                std::uniform_int_distribution<std::uint32_t> pick(0, static_cast<std::uint32_t>(o.keys - 1));
+                trace.reserve(o.ops);
+                for (std::size_t i = 0; i < o.ops; ++i)
+                    trace.push_back(pick(rng));
+            }
+        }
+        return traces;
+    }
+
+    template <typename Interner>
+    double run(Interner& interner, const std::vector<std::string>& keys,
+               const std::vector<std::vector<std::uint32_t>>& traces)
+    {
+        std::atomic<int> ready{0};
+        std::atomic<bool> go{false};
+        std::atomic<bool> ok{true};
+        std::vector<std::thread> threads;
+        for (const auto& trace : traces)
+        {
+            threads.emplace_back([&, &trace = trace] {
+                ready++;
+                while (!go.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                for (std::uint32_t i : trace)
+                {
+                    if (interner.intern_view(keys[i]).size() != keys[i].size())
+                        ok = false;
+                }
+            });
+        }
+        while (ready.load() != static_cast<int>(traces.size()))
+            std::this_thread::yield();
+        const auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& t : threads)
+            t.join();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!ok)
+        {
+            std::cerr << "wrong string returned\n";
+            std::exit(1);
+        }
+        return seconds;
+    }
+
+    struct Row
+    {
+        std::string interner;
+        std::string workload;
+        int threads = 0;
+        double mops = 0;
+    };
+}
+
+int main(int argc, char** argv)
+{
+    const Options o = parse(argc, argv);
+    const auto keys = make_keys(o.keys);
+    std::printf("keys=%zu lookup ops/thread=%zu\n", o.keys, o.ops);
+    std::printf("%-16s %-8s %7s %10s\n", "interner", "workload", "threads", "Mops/s");
+
+    std::vector<Row> rows;
+    for (const bool insert : {false, true})
+    {
+        for (const int threads : o.threads)
+        {
+            const auto traces = make_traces(o, threads, insert);
+            double total_ops = 0;
+            for (const auto& trace : traces)
+                total_ops += static_cast<double>(trace.size());
+            auto report = [&](const char* name, double seconds) {
+                Row r;
+                r.interner = name;
+                r.workload = insert ? "insert" : "lookup";
+                r.threads = threads;
+                r.mops = total_ops / seconds / 1e6;
+                std::printf("%-16s %-8s %7d %10.2f\n", r.interner.c_str(), r.workload.c_str(), r.threads, r.mops);
+                std::fflush(stdout);
+                rows.push_back(std::move(r));
+            };
+
+            {
+                StringInterner interner;
+                if (!insert)
+                {
+                    for (const auto& k : keys)
+                        interner.intern(k);
+                }
+                report("StringInterner", run(interner, keys, traces));
+            }
+            {
+                MutexSetInterner interner;
+                if (!insert)
+                {
+                    for (const auto& k : keys)
+                        interner.intern_view(k);
+                }
+                report("mutex-set", run(interner, keys, traces));
+            }
+        }
+    }
+
+    if (!o.json_path.empty())
+    {
+        std::ofstream out(o.json_path);
+        out << "{\"keys\": " << o.keys << ", \"ops_per_thread\": " << o.ops << ", \"results\": [";
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            const auto& r = rows[i];
+            out << (i ? ", " : "") << "{\"interner\": \"" << r.interner << "\", \"workload\": \"" << r.workload
+                << "\", \"threads\": " << r.threads << ", \"mops\": " << r.mops << "}";
+        }
+        out << "]}\n";
+    }
+    return 0;
+}
@@ -0,0 +1,188 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+// OnceCell / Lazy 与标准库替代方案的微基准
+//
+
+#include "harness.h"
+
+#include <cxxlazy/components/macros.h>
+#include <array>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace components;
+
+namespace
+{
+    /**
+     * @brief 指定大小的值，用于扫描值大小
+     */
+    template <std::size_t N>
+    struct Blob
+    {
+        std::array<unsigned char, N> bytes{};
+    };
+
+    template <std::size_t N>
+    Blob<N> make_blob()
+    {
+        Blob<N> b;
+        b.bytes[0] = 1;
+        return b;
+    }
+
+    template <std::size_t N>
+    Blob<N>& function_local_static()
+    {
+        static Blob<N> value = make_blob<N>();
+        return value;
+    }
+
+    template <std::size_t N>
+    Lazy<Blob<N>>& lazy_static()
+    {
+        LAZY_STATIC(Blob<N>, value, make_blob<N>());
+        return value;
+    }
+
+    /// @brief std::call_once 加 std::optional 组成的惰性值
+    template <std::size_t N>
+    struct CallOnceValue
+    {
+        std::once_flag flag;
+        std::optional<Blob<N>> value;
+
+        Blob<N>& get()
+        {
+            std::call_once(flag, [this] { value.emplace(make_blob<N>()); });
+            return *value;
+        }
+    };
+
+    template <std::size_t N>
+    void read_benchmarks(bench::Harness& h, const bench::Params& params, int threads)
+    {
+        OnceCell<Blob<N>> cell;
+        cell.get_or_init(make_blob<N>);
+        h.run_throughput("read/once_cell", params, threads, [&](int) {
+            bench::do_not_optimize(cell.get_or_init(make_blob<N>));
+        });
+
+        Lazy<Blob<N>> lazy(make_blob<N>);
+        lazy.get();
+        h.run_throughput("read/lazy", params, threads, [&](int) { bench::do_not_optimize(lazy.get()); });
+
+        lazy_static<N>().get();
+        h.run_throughput("read/lazy_static", params, threads, [&](int) {
+            bench::do_not_optimize(lazy_static<N>().get());
+        });
+
+        function_local_static<N>();
+        h.run_throughput("read/function_local_static", params, threads, [&](int) {
+            bench::do_not_optimize(function_local_static<N>());
+        });
+
+        CallOnceValue<N> once;
+        once.get();
+        h.run_throughput("read/call_once", params, threads, [&](int) { bench::do_not_optimize(once.get()); });
+
+        std::shared_future<Blob<N>> future = std::async(std::launch::deferred, make_blob<N>).share();
+        future.wait();
+        h.run_throughput("read/shared_future", params, threads, [&](int) {
+            bench::do_not_optimize(future.get());
+        });
+    }
+
+    template <std::size_t N>
+    void cold_init_benchmarks(bench::Harness& h, const bench::Params& params, int threads)
+    {
+        std::unique_ptr<OnceCell<Blob<N>>> cell;
+        h.run_rounds("cold_init/once_cell", params, threads,
+                     [&] { cell = std::make_unique<OnceCell<Blob<N>>>(); },
+                     [&](int) { bench::do_not_optimize(cell->get_or_init(make_blob<N>)); },
+                     [&] { cell.reset(); });
+
+        std::unique_ptr<Lazy<Blob<N>>> lazy;
+        h.run_rounds("cold_init/lazy", params, threads,
+                     [&] { lazy = std::make_unique<Lazy<Blob<N>>>(make_blob<N>); },
+                     [&](int) { bench::do_not_optimize(lazy->get()); },
+                     [&] { lazy.reset(); });
+
+        std::unique_ptr<CallOnceValue<N>> once;
+        h.run_rounds("cold_init/call_once", params, threads,
+                     [&] { once = std::make_unique<CallOnceValue<N>>(); },
+                     [&](int) { bench::do_not_optimize(once->get()); },
+                     [&] { once.reset(); });
+
+        std::shared_future<Blob<N>> future;
+        h.run_rounds("cold_init/shared_future", params, threads,
+                     [&] { future = std::async(std::launch::deferred, make_blob<N>).share(); },
+                     [&](int) { bench::do_not_optimize(future.get()); },
+                     [&] { future = {}; });
+    }
+
+    /**
+     * @brief 每个工作线程一份，reset 不能与同一单元上的 get 并发
+     */
+    template <typename Cell, typename... Args>
+    std::vector<std::unique_ptr<Cell>> per_thread(int threads, const Args&... args)
+    {
+        std::vector<std::unique_ptr<Cell>> cells;
+        for (int t = 0; t < threads; ++t)
+            cells.push_back(std::make_unique<Cell>(args...));
+        return cells;
+    }
+
+    template <std::size_t N>
+    void reset_benchmarks(bench::Harness& h, const bench::Params& params, int threads)
+    {
+        // 每个线程只重置自己的单元，测量的是单线程的 reset / 重新初始化循环在多核上的扩展性
+        auto cells = per_thread<OnceCell<Blob<N>>>(threads);
+        h.run_throughput("reset_cycle/once_cell", params, threads, [&](int t) {
+            auto& cell = *cells[static_cast<std::size_t>(t)];
+            bench::do_not_optimize(cell.get_or_init(make_blob<N>));
+            cell.reset();
+        });
+
+        auto lazies = per_thread<Lazy<Blob<N>>>(threads, make_blob<N>);
+        h.run_throughput("reset_cycle/lazy", params, threads, [&](int t) {
+            auto& lazy = *lazies[static_cast<std::size_t>(t)];
+            bench::do_not_optimize(lazy.get());
+            lazy.reset();
+        });
+
+        // 具名单元会登记到 LazyRegistry 并记录统计信息，用来衡量观测的开销
+        auto named = per_thread<Lazy<Blob<N>>>(threads, "bench_reset_cycle", make_blob<N>);
+        h.run_throughput("reset_cycle/lazy_named", params, threads, [&](int t) {
+            auto& lazy = *named[static_cast<std::size_t>(t)];
+            bench::do_not_optimize(lazy.get());
+            lazy.reset();
+        });
+    }
+
+    template <std::size_t N>
+    void run_all(bench::Harness& h)
+    {
+        for (int threads : h.thread_counts())
+        {
+            bench::Params params{{"value_size", std::to_string(N)}};
+            read_benchmarks<N>(h, params, threads);
+            cold_init_benchmarks<N>(h, params, threads);
+            reset_benchmarks<N>(h, params, threads);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bench::Harness h(argc, argv);
+    run_all<8>(h);
+    run_all<256>(h);
+    run_all<4096>(h);
+    return h.finish();
+}
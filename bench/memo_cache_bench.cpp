@@ -0,0 +1,310 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+// 有界记忆缓存基准：在 Zipf 分布和“Zipf + 一次性扫描”两种负载下，
+// 比较 MemoCache（S3-FIFO，无锁命中）与常见的互斥锁保护的 LRU，报告吞吐和命中率
+//
+
+#include <cxxlazy/components/memo_cache.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace components;
+
+namespace
+{
+    struct Options
+    {
+        std::uint64_t keys = 100000;
+        std::size_t capacity = 10000;
+        std::size_t ops = 500000;
+        std::vector<int> threads = {1, 4, 8};
+        double zipf = 0.99;
+        /// @brief 扫描负载中一次性键所占的比例
+        double scan = 0.3;
+        /// @brief 未命中时计算一个值的耗时（忙等）
+        std::uint64_t compute_ns = 500;
+        std::string json_path;
+    };
+
+    [[noreturn]] void usage()
+    {
+        std::cerr << "usage: memo_cache_bench [--keys=N] [--capacity=N] [--ops=N] [--threads=1,4,8]\n"
+                     "                        [--zipf=S] [--scan=FRACTION] [--compute-ns=N] [--json=PATH]\n";
+        std::exit(2);
+    }
+
+    std::vector<int> parse_list(const char* s)
+    {
+        std::vector<int> out;
+        for (const char* p = s; *p;)
+        {
+            char* end = nullptr;
+            out.push_back(std::max(1, static_cast<int>(std::strtol(p, &end, 10))));
+            if (end == p)
+                usage();
+            p = *end == ',' ? end + 1 : end;
+        }
+        return out;
+    }
+
+    Options parse(int argc, char** argv)
+    {
+        Options o;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&](const char* prefix) -> const char* {
+                auto n = std::char_traits<char>::length(prefix);
+                return arg.compare(0, n, prefix) == 0 ? arg.c_str() + n : nullptr;
+            };
+            if (auto v = value("--keys="))
+                o.keys = std::max<std::uint64_t>(1, std::strtoull(v, nullptr, 10));
+            else if (auto v = value("--capacity="))
+                o.capacity = std::max<std::size_t>(1, std::strtoull(v, nullptr, 10));
+            else if (auto v = value("--ops="))
+                o.ops = std::max<std::size_t>(1, std::strtoull(v, nullptr, 10));
+            else if (auto v = value("--threads="))
+                o.threads = parse_list(v);
+            else if (auto v = value("--zipf="))
+                o.zipf = std::atof(v);
+            else if (auto v = value("--scan="))
+                o.scan = std::clamp(std::atof(v), 0.0, 1.0);
+            else if (auto v = value("--compute-ns="))
+                o.compute_ns = std::strtoull(v, nullptr, 10);
+            else if (auto v = value("--json="))
+                o.json_path = v;
+            else
+                usage();
+        }
+        return o;
+    }
+
+    /**
+     * @brief 模拟未命中的代价
+     */
+    std::uint64_t compute(std::uint64_t key, std::uint64_t ns)
+    {
+        const auto until = std::chrono::steady_clock::now() + std::chrono::nanoseconds(ns);
+        while (std::chrono::steady_clock::now() < until)
+        {
+        }
+        return key * 2 + 1;
+    }
+
+    /**
+     * @brief 对照组：一把互斥锁保护的 LRU，未命中时在锁外计算
+     */
+    class MutexLru
+    {
+    public:
+        explicit MutexLru(std::size_t capacity) : capacity_(capacity)
+        {
+        }
+
+        template <typename Fn>
+        std::uint64_t get_or_compute(std::uint64_t key, Fn&& fn)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if (auto it = index_.find(key); it != index_.end())
+                {
+                    order_.splice(order_.begin(), order_, it->second);
+                    hits_++;
+                    return it->second->second;
+                }
+                misses_++;
+            }
+            const std::uint64_t value = fn(key);
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (index_.find(key) == index_.end())
+            {
+                order_.emplace_front(key, value);
+                index_[key] = order_.begin();
+                if (order_.size() > capacity_)
+                {
+                    index_.erase(order_.back().first);
+                    order_.pop_back();
+                }
+            }
+            return value;
+        }
+
+        [[nodiscard]] std::pair<std::uint64_t, std::uint64_t> hits_misses() const { return {hits_, misses_}; }
+
+    private:
+        std::size_t capacity_;
+        std::mutex mtx_;
+        std::list<std::pair<std::uint64_t, std::uint64_t>> order_;
+        std::unordered_map<std::uint64_t, std::list<std::pair<std::uint64_t, std::uint64_t>>::iterator> index_;
+        std::uint64_t hits_ = 0;
+        std::uint64_t misses_ = 0;
+    };
+
+    class ZipfSampler
+    {
+    public:
+        ZipfSampler(std::uint64_t n, double s) : cdf_(n)
+        {
+            double sum = 0;
+            for (std::uint64_t i = 0; i < n; ++i)
+            {
+                sum += 1.0 / std::pow(static_cast<double>(i + 1), s);
+                cdf_[i] = sum;
+            }
+            for (auto& c : cdf_)
+                c /= sum;
+        }
+
+        std::uint64_t operator()(std::mt19937_64& rng) const
+        {
+            const double u = std::uniform_real_distribution<double>(0, 1)(rng);
+            return static_cast<std::uint64_t>(std::lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin());
+        }
+
+    private:
+        std::vector<double> cdf_;
+    };
+
+    /**
+     * @brief 为每个线程预先生成访问序列，计时只包含缓存操作
+     * @details 扫描负载中，按比例把访问替换为热点范围之外、只出现一次的键
+     */
+    std::vector<std::vector<std::uint64_t>> make_traces(const Options& o, int threads, bool scan)
+    {
+        ZipfSampler zipf(o.keys, o.zipf);
+        std::vector<std::vector<std::uint64_t>> traces(static_cast<std::size_t>(threads));
+        std::uint64_t next_scan_key = o.keys;
+        for (int t = 0; t < threads; ++t)
+        {
+            std::mt19937_64 rng(static_cast<std::uint64_t>(t) * 7919 + 1);
+            std::bernoulli_distribution is_scan(scan ? o.scan : 0.0);
+            auto& trace = traces[static_cast<std::size_t>(t)];
+            trace.reserve(o.ops);
+            for (std::size_t i = 0; i < o.ops; ++i)
+                trace.push_back(is_scan(rng) ? next_scan_key++ : zipf(rng));
+        }
+        return traces;
+    }
+
+    struct Row
+    {
+        std::string cache;
+        std::string workload;
+        int threads = 0;
+        double mops = 0;
+        double hit_ratio = 0;
+    };
+
+    template <typename Cache>
+    double run(Cache& cache, const std::vector<std::vector<std::uint64_t>>& traces, std::uint64_t compute_ns)
+    {
+        std::atomic<int> ready{0};
+        std::atomic<bool> go{false};
+        std::atomic<bool> ok{true};
+        std::vector<std::thread> threads;
+        for (const auto& trace : traces)
+        {
+            threads.emplace_back([&, &trace = trace] {
+                ready++;
+                while (!go.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                for (std::uint64_t key : trace)
+                {
+                    if (cache.get_or_compute(key, [&](std::uint64_t k) { return compute(k, compute_ns); }) !=
+                        key * 2 + 1)
+                        ok = false;
+                }
+            });
+        }
+        while (ready.load() != static_cast<int>(traces.size()))
+            std::this_thread::yield();
+        const auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& t : threads)
+            t.join();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!ok)
+        {
+            std::cerr << "wrong value returned\n";
+            std::exit(1);
+        }
+        return seconds;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const Options o = parse(argc, argv);
+    std::printf("keys=%llu capacity=%zu ops/thread=%zu zipf=%.2f scan=%.2f compute_ns=%llu\n",
+                static_cast<unsigned long long>(o.keys), o.capacity, o.ops, o.zipf, o.scan,
+                static_cast<unsigned long long>(o.compute_ns));
+    std::printf("%-12s %-10s %7s %10s %9s\n", "cache", "workload", "threads", "Mops/s", "hit%");
+
+    std::vector<Row> rows;
+    for (const bool scan : {false, true})
+    {
+        for (const int threads : o.threads)
+        {
+            const auto traces = make_traces(o, threads, scan);
+            const double total_ops = static_cast<double>(o.ops) * threads;
+            auto report = [&](const char* name, double seconds, std::uint64_t hits, std::uint64_t misses) {
+                Row r;
+                r.cache = name;
+                r.workload = scan ? "zipf+scan" : "zipf";
+                r.threads = threads;
+                r.mops = total_ops / seconds / 1e6;
+                r.hit_ratio = static_cast<double>(hits) / static_cast<double>(std::max<std::uint64_t>(1, hits + misses));
+                std::printf("%-12s %-10s %7d %10.2f %8.2f%%\n", r.cache.c_str(), r.workload.c_str(), r.threads, r.mops,
+                            r.hit_ratio * 100);
+                std::fflush(stdout);
+                rows.push_back(std::move(r));
+            };
+
+            {
+                MemoCache<std::uint64_t, std::uint64_t> cache(o.capacity);
+                const double s = run(cache, traces, o.compute_ns);
+                const auto stats = cache.stats();
+                report("MemoCache", s, stats.hits, stats.misses);
+            }
+            {
+                MutexLru cache(o.capacity);
+                const double s = run(cache, traces, o.compute_ns);
+                const auto [hits, misses] = cache.hits_misses();
+                report("mutex-LRU", s, hits, misses);
+            }
+        }
+    }
+
+    if (!o.json_path.empty())
+    {
+        std::ofstream out(o.json_path);
+        out << "{\"keys\": " << o.keys << ", \"capacity\": " << o.capacity << ", \"ops_per_thread\": " << o.ops
+            << ", \"zipf\": " << o.zipf << ", \"scan\": " << o.scan << ", \"compute_ns\": " << o.compute_ns
+            << ", \"results\": [";
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            const auto& r = rows[i];
+            out << (i ? ", " : "") << "{\"cache\": \"" << r.cache << "\", \"workload\": \"" << r.workload
+                << "\", \"threads\": " << r.threads << ", \"mops\": " << r.mops << ", \"hit_ratio\": " << r.hit_ratio
+                << "}";
+        }
+        out << "]}\n";
+    }
+    return 0;
+}
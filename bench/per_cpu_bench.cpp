@@ -0,0 +1,176 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+// 按 CPU 分片基准：多个线程不断修改同一份热点状态（计数器），比较
+// - 全局 Lazy<T> 加一把互斥锁；
+// - PerCpuLazy<T>::with_local()（分片锁，通常无竞争）；
+// - PerCpuLazy<std::atomic<T>>::local()（不加锁，原子加）
+// 报告各线程数下的吞吐，理想情况下 PerCpuLazy 随核心数线性增长
+//
+
+#include <cxxlazy/components/lazy.h>
+#include <cxxlazy/components/per_cpu_lazy.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace components;
+
+namespace
+{
+    struct Options
+    {
+        std::size_t ops = 2000000;
+        std::vector<int> threads = {1, 2, 4, 8};
+        std::string json_path;
+    };
+
+    [[noreturn]] void usage()
+    {
+        std::cerr << "usage: per_cpu_bench [--ops=N] [--threads=1,2,4,8] [--json=PATH]\n";
+        std::exit(2);
+    }
+
+    std::vector<int> parse_list(const char* s)
+    {
+        std::vector<int> out;
+        for (const char* p = s; *p;)
+        {
+            char* end = nullptr;
+            out.push_back(std::max(1, static_cast<int>(std::strtol(p, &end, 10))));
+            if (end == p)
+                usage();
+            p = *end == ',' ? end + 1 : end;
+        }
+        return out;
+    }
+
+    Options parse(int argc, char** argv)
+    {
+        Options o;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&](const char* prefix) -> const char* {
+                auto n = std::char_traits<char>::length(prefix);
+                return arg.compare(0, n, prefix) == 0 ? arg.c_str() + n : nullptr;
+            };
+            if (auto v = value("--ops="))
+                o.ops = std::max<std::size_t>(1, std::strtoull(v, nullptr, 10));
+            else if (auto v = value("--threads="))
+                o.threads = parse_list(v);
+            else if (auto v = value("--json="))
+                o.json_path = v;
+            else
+                usage();
+        }
+        return o;
+    }
+
+    /**
+     * @brief 在 threads 个线程中各执行 ops 次 op，返回耗时（秒）
+     */
+    template <typename Op>
+    double run(int threads, std::size_t ops, Op&& op)
+    {
+        std::atomic<int> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&] {
+                ready++;
+                while (!go.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                for (std::size_t i = 0; i < ops; ++i)
+                    op();
+            });
+        }
+        while (ready.load() != threads)
+            std::this_thread::yield();
+        const auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& w : workers)
+            w.join();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    struct Row
+    {
+        std::string variant;
+        int threads = 0;
+        double mops = 0;
+    };
+}
+
+int main(int argc, char** argv)
+{
+    const Options o = parse(argc, argv);
+    std::printf("cpus=%zu ops/thread=%zu\n", detail::cpu_count(), o.ops);
+    std::printf("%-20s %7s %10s\n", "variant", "threads", "Mops/s");
+
+    std::vector<Row> rows;
+    for (const int threads : o.threads)
+    {
+        const std::uint64_t expected = static_cast<std::uint64_t>(threads) * o.ops;
+        auto report = [&](const char* name, double seconds, std::uint64_t total) {
+            if (total != expected)
+            {
+                std::cerr << name << ": lost updates (" << total << " != " << expected << ")\n";
+                std::exit(1);
+            }
+            Row r{name, threads, static_cast<double>(expected) / seconds / 1e6};
+            std::printf("%-20s %7d %10.2f\n", r.variant.c_str(), r.threads, r.mops);
+            std::fflush(stdout);
+            rows.push_back(std::move(r));
+        };
+
+        {
+            Lazy<std::uint64_t> counter([] { return std::uint64_t{0}; });
+            std::mutex mtx;
+            const double s = run(threads, o.ops, [&] {
+                std::lock_guard<std::mutex> lock(mtx);
+                ++*counter;
+            });
+            report("Lazy+mutex", s, *counter);
+        }
+        {
+            PerCpuLazy<std::uint64_t> counter([](std::size_t) { return std::uint64_t{0}; });
+            const double s = run(threads, o.ops, [&] { counter.with_local([](std::uint64_t& n) { ++n; }); });
+            std::uint64_t total = 0;
+            counter.aggregate([&](const std::uint64_t& n) { total += n; });
+            report("PerCpuLazy", s, total);
+        }
+        {
+            PerCpuLazy<std::atomic<std::uint64_t>> counter([](std::size_t) { return std::atomic<std::uint64_t>{0}; });
+            const double s = run(threads, o.ops, [&] { counter.local().fetch_add(1, std::memory_order_relaxed); });
+            std::uint64_t total = 0;
+            counter.aggregate([&](const std::atomic<std::uint64_t>& n) { total += n.load(); });
+            report("PerCpuLazy<atomic>", s, total);
+        }
+    }
+
+    if (!o.json_path.empty())
+    {
+        std::ofstream out(o.json_path);
+        out << "{\"cpus\": " << detail::cpu_count() << ", \"ops_per_thread\": " << o.ops << ", \"results\": [";
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            const auto& r = rows[i];
+            out << (i ? ", " : "") << "{\"variant\": \"" << r.variant << "\", \"threads\": " << r.threads
+                << ", \"mops\": " << r.mops << "}";
+        }
+        out << "]}\n";
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#include "perf_counters.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench
+{
+    namespace
+    {
+        constexpr const char* kNames[kCounterCount] = {
+            "cycles", "instructions", "cache_misses", "branch_misses", "context_switches"
+        };
+
+#if defined(__linux__)
+        struct EventSpec
+        {
+            std::uint32_t type;
+            std::uint64_t config;
+        };
+
+        constexpr EventSpec kEvents[kCounterCount] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+        };
+
+        int open_event(const EventSpec& spec, int* error)
+        {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = spec.type;
+            attr.config = spec.config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            // 只统计调用线程（pid = 0）在任意 CPU 上的事件
+            long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+            if (fd < 0 && errno == EACCES)
+            {
+                // 部分 perf_event_paranoid 设置下 context switches 需要包含内核态
+                attr.exclude_kernel = 0;
+                fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+            }
+            if (fd < 0 && error)
+                *error = errno;
+            return static_cast<int>(fd);
+        }
+#endif
+    }
+
+    CounterValues& CounterValues::operator+=(const CounterValues& other)
+    {
+        for (std::size_t i = 0; i < kCounterCount; ++i)
+        {
+            values[i] += other.values[i];
+            valid[i] = valid[i] || other.valid[i];
+        }
+        return *this;
+    }
+
+    const char* PerfCounters::name(std::size_t index)
+    {
+        return index < kCounterCount ? kNames[index] : "";
+    }
+
+    bool PerfCounters::available(std::string* reason)
+    {
+#if defined(__linux__)
+        static int error = 0;
+        static const bool ok = [] {
+            bool any = false;
+            for (const auto& spec : kEvents)
+            {
+                int fd = open_event(spec, &error);
+                if (fd >= 0)
+                {
+                    close(fd);
+                    any = true;
+                }
+            }
+            return any;
+        }();
+        if (!ok && reason)
+            *reason = std::string("perf_event_open failed: ") + std::strerror(error) +
+                " (check /proc/sys/kernel/perf_event_paranoid)";
+        return ok;
+#else
+        if (reason)
+            *reason = "perf_event_open is only available on Linux";
+        return false;
+#endif
+    }
+
+    PerfCounters::PerfCounters()
+    {
+        fds_.fill(-1);
+#if defined(__linux__)
+        if (!available())
+            return;
+        for (std::size_t i = 0; i < kCounterCount; ++i)
+            fds_[i] = open_event(kEvents[i], nullptr);
+#endif
+    }
+
+    PerfCounters::~PerfCounters()
+    {
+#if defined(__linux__)
+        for (int fd : fds_)
+        {
+            if (fd >= 0)
+                close(fd);
+        }
+#endif
+    }
+
+    void PerfCounters::start()
+    {
+#if defined(__linux__)
+        for (int fd : fds_)
+        {
+            if (fd < 0)
+                continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    void PerfCounters::stop()
+    {
+#if defined(__linux__)
+        for (int fd : fds_)
+        {
+            if (fd >= 0)
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+#endif
+    }
+
+    CounterValues PerfCounters::read() const
+    {
+        CounterValues result;
+#if defined(__linux__)
+        for (std::size_t i = 0; i < kCounterCount; ++i)
+        {
+            if (fds_[i] < 0)
+                continue;
+            std::uint64_t buf[3] = {0, 0, 0};
+            if (::read(fds_[i], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf)))
+                continue;
+            const std::uint64_t value = buf[0], enabled = buf[1], running = buf[2];
+            if (running == 0)
+            {
+                // 启用过但从未被调度到 PMU 上，没有有效数据
+                result.valid[i] = enabled == 0;
+                continue;
+            }
+            result.values[i] = static_cast<double>(value) * static_cast<double>(enabled) / static_cast<double>(running);
+            result.valid[i] = true;
+        }
+#endif
+        return result;
+    }
+}
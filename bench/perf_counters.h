@@ -0,0 +1,80 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+namespace bench
+{
+    /// @brief 支持的硬件/软件计数器数量
+    constexpr std::size_t kCounterCount = 5;
+
+    /**
+     * @brief 一组计数器的读数
+     */
+    struct CounterValues
+    {
+        /// @brief 计数值，已经按复用比例（time_enabled / time_running）换算
+        std::array<double, kCounterCount> values{};
+        /// @brief 对应计数器是否可用
+        std::array<bool, kCounterCount> valid{};
+
+        CounterValues& operator+=(const CounterValues& other);
+    };
+
+    /**
+     * @class PerfCounters
+     * @brief 基于 Linux perf_event_open 的线程级计数器
+     * @details
+     * 统计调用线程的 cycles、instructions、cache misses、branch misses 和 context switches
+     * 每个计数器单独打开，部分不可用（例如虚拟机中没有硬件计数器、perf_event_paranoid 限制）时，
+     * 其余计数器照常工作；全部不可用或非 Linux 平台上所有读数都标记为无效
+     */
+    class PerfCounters
+    {
+    public:
+        /**
+         * @brief 计数器名称，例如 "cycles"
+         */
+        static const char* name(std::size_t index);
+
+        /**
+         * @brief 当前环境下是否至少有一个计数器可用，结果会被缓存
+         * @param reason 不可用时输出原因
+         */
+        static bool available(std::string* reason = nullptr);
+
+        /**
+         * @brief 为调用线程打开计数器，初始为停止状态
+         */
+        PerfCounters();
+
+        PerfCounters(const PerfCounters&) = delete;
+
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        ~PerfCounters();
+
+        /**
+         * @brief 清零并开始计数
+         */
+        void start();
+
+        /**
+         * @brief 停止计数
+         */
+        void stop();
+
+        /**
+         * @brief 读取计数值
+         */
+        [[nodiscard]] CounterValues read() const;
+
+    private:
+        std::array<int, kCounterCount> fds_{};
+    };
+}
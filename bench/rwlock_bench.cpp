@@ -0,0 +1,184 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+// 读写锁基准：多个线程以读为主访问同一个惰性值（偶尔写入），比较
+// - 全局 Lazy<T> 加 std::shared_mutex（所有读者修改同一条缓存行上的读者计数）；
+// - LazyRwLock<T>（读者计数按 CPU 分布）
+// 报告各线程数和写入比例下的吞吐
+//
+
+#include "harness.h"
+
+#include <cxxlazy/components/lazy.h>
+#include <cxxlazy/components/lazy_lock.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace components;
+
+namespace
+{
+    struct Options
+    {
+        std::size_t ops = 2000000;
+        std::vector<int> threads = {1, 2, 4, 8};
+        /// @brief 每千次操作中写操作的次数
+        unsigned write_permille = 1;
+        std::string json_path;
+    };
+
+    [[noreturn]] void usage()
+    {
+        std::cerr << "usage: rwlock_bench [--ops=N] [--threads=1,2,4,8] [--write-permille=N] [--json=PATH]\n";
+        std::exit(2);
+    }
+
+    std::vector<int> parse_list(const char* s)
+    {
+        std::vector<int> out;
+        for (const char* p = s; *p;)
+        {
+            char* end = nullptr;
+            out.push_back(std::max(1, static_cast<int>(std::strtol(p, &end, 10))));
+            if (end == p)
+                usage();
+            p = *end == ',' ? end + 1 : end;
+        }
+        return out;
+    }
+
+    Options parse(int argc, char** argv)
+    {
+        Options o;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&](const char* prefix) -> const char* {
+                auto n = std::char_traits<char>::length(prefix);
+                return arg.compare(0, n, prefix) == 0 ? arg.c_str() + n : nullptr;
+            };
+            if (auto v = value("--ops="))
+                o.ops = std::max<std::size_t>(1, std::strtoull(v, nullptr, 10));
+            else if (auto v = value("--threads="))
+                o.threads = parse_list(v);
+            else if (auto v = value("--write-permille="))
+                o.write_permille = static_cast<unsigned>(std::min<unsigned long>(1000, std::strtoul(v, nullptr, 10)));
+            else if (auto v = value("--json="))
+                o.json_path = v;
+            else
+                usage();
+        }
+        return o;
+    }
+
+    /**
+     * @brief 在 threads 个线程中各执行 ops 次 op(i)，返回耗时（秒）
+     */
+    template <typename Op>
+    double run(int threads, std::size_t ops, Op&& op)
+    {
+        std::atomic<int> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&] {
+                ready++;
+                while (!go.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                for (std::size_t i = 0; i < ops; ++i)
+                    op(i);
+            });
+        }
+        while (ready.load() != threads)
+            std::this_thread::yield();
+        const auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& w : workers)
+            w.join();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    struct Row
+    {
+        std::string variant;
+        int threads = 0;
+        double mops = 0;
+    };
+}
+
+int main(int argc, char** argv)
+{
+    const Options o = parse(argc, argv);
+    std::printf("cpus=%zu ops/thread=%zu write_permille=%u\n", detail::cpu_count(), o.ops, o.write_permille);
+    std::printf("%-20s %7s %10s\n", "variant", "threads", "Mops/s");
+
+    // 写操作均匀分布在访问序列中
+    auto is_write = [&](std::size_t i) { return o.write_permille && i % 1000 < o.write_permille; };
+    std::vector<Row> rows;
+    for (const int threads : o.threads)
+    {
+        const double total_ops = static_cast<double>(threads) * static_cast<double>(o.ops);
+        auto report = [&](const char* name, double seconds) {
+            Row r{name, threads, total_ops / seconds / 1e6};
+            std::printf("%-20s %7d %10.2f\n", r.variant.c_str(), r.threads, r.mops);
+            std::fflush(stdout);
+            rows.push_back(std::move(r));
+        };
+
+        {
+            Lazy<std::vector<std::uint64_t>> table([] { return std::vector<std::uint64_t>(64, 1); });
+            std::shared_mutex mtx;
+            const double s = run(threads, o.ops, [&](std::size_t i) {
+                if (is_write(i))
+                {
+                    std::unique_lock<std::shared_mutex> lock(mtx);
+                    (*table)[i % 64]++;
+                }
+                else
+                {
+                    std::shared_lock<std::shared_mutex> lock(mtx);
+                    bench::do_not_optimize((*table)[i % 64]);
+                }
+            });
+            report("Lazy+shared_mutex", s);
+        }
+        {
+            LazyRwLock<std::vector<std::uint64_t>> table([] { return std::vector<std::uint64_t>(64, 1); });
+            const double s = run(threads, o.ops, [&](std::size_t i) {
+                if (is_write(i))
+                    table.write().get()[i % 64]++;
+                else
+                    bench::do_not_optimize(table.read().get()[i % 64]);
+            });
+            report("LazyRwLock", s);
+        }
+    }
+
+    if (!o.json_path.empty())
+    {
+        std::ofstream out(o.json_path);
+        out << "{\"cpus\": " << detail::cpu_count() << ", \"ops_per_thread\": " << o.ops
+            << ", \"write_permille\": " << o.write_permille << ", \"results\": [";
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            const auto& r = rows[i];
+            out << (i ? ", " : "") << "{\"variant\": \"" << r.variant << "\", \"threads\": " << r.threads
+                << ", \"mops\": " << r.mops << "}";
+        }
+        out << "]}\n";
+    }
+    return 0;
+}
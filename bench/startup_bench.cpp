@@ -0,0 +1,520 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+// 进程启动开销基准：生成含有 N 个全局对象的程序，分别以普通全局变量（动态初始化）、
+// LAZY_STATIC、登记到 LazyRegistry 的 LAZY_STATIC_NAMED 和常量初始化的 OnceCell 定义，编译后反复启动，
+// 测量 exec 到 main 的时间、处理完第一个请求的时间、可执行文件大小和缺页次数
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    enum class Variant { Eager, LazyStatic, LazyStaticNamed, Constinit };
+
+    const char* variant_name(Variant v)
+    {
+        switch (v)
+        {
+        case Variant::Eager: return "eager";
+        case Variant::LazyStatic: return "lazy_static";
+        case Variant::LazyStaticNamed: return "lazy_static_named";
+        case Variant::Constinit: return "constinit";
+        }
+        return "?";
+    }
+
+    struct Options
+    {
+        std::vector<int> counts{100, 1000, 10000};
+        std::vector<Variant> variants{Variant::Eager, Variant::LazyStatic, Variant::LazyStaticNamed,
+                                      Variant::Constinit};
+        int runs = 10;
+        int touch = 16;
+        int per_tu = 100;
+        int jobs = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        std::string workdir = "startup_bench_work";
+        std::string cxx = CXXLAZY_BENCH_CXX;
+        std::string json_path;
+    };
+
+    /// @brief 一次启动的测量结果
+    struct Sample
+    {
+        std::int64_t exec_to_main_ns = 0;
+        std::int64_t first_request_ns = 0;
+        long minflt_main = 0;
+        long minflt_first = 0;
+        long minflt_total = 0;
+        long majflt_total = 0;
+        long maxrss_kb = 0;
+    };
+
+    /// @brief 一个（变体, N）组合的汇总结果，时间和缺页取多次启动的中位数
+    struct Row
+    {
+        Variant variant = Variant::Eager;
+        int count = 0;
+        double build_s = 0;
+        std::int64_t binary_bytes = 0;
+        Sample median;
+    };
+
+    [[noreturn]] void usage()
+    {
+        std::cerr << "usage: startup_bench [--counts=100,1000,10000]\n"
+            "                     [--variants=eager,lazy_static,lazy_static_named,constinit]\n"
+            "                     [--runs=N] [--touch=N] [--per-tu=N] [--jobs=N]\n"
+            "                     [--workdir=DIR] [--cxx=PATH] [--json=PATH]\n";
+        std::exit(2);
+    }
+
+    std::vector<std::string> split(const std::string& s, char sep)
+    {
+        std::vector<std::string> parts;
+        std::stringstream ss(s);
+        std::string item;
+        while (std::getline(ss, item, sep))
+        {
+            if (!item.empty())
+                parts.push_back(item);
+        }
+        return parts;
+    }
+
+    Options parse(int argc, char** argv)
+    {
+        Options o;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&](const char* prefix) -> const char* {
+                auto n = std::char_traits<char>::length(prefix);
+                return arg.compare(0, n, prefix) == 0 ? arg.c_str() + n : nullptr;
+            };
+            if (auto v = value("--counts="))
+            {
+                o.counts.clear();
+                for (const auto& c : split(v, ','))
+                    o.counts.push_back(std::max(1, std::atoi(c.c_str())));
+            }
+            else if (auto v = value("--variants="))
+            {
+                o.variants.clear();
+                for (const auto& name : split(v, ','))
+                {
+                    if (name == "eager")
+                        o.variants.push_back(Variant::Eager);
+                    else if (name == "lazy_static")
+                        o.variants.push_back(Variant::LazyStatic);
+                    else if (name == "lazy_static_named")
+                        o.variants.push_back(Variant::LazyStaticNamed);
+                    else if (name == "constinit")
+                        o.variants.push_back(Variant::Constinit);
+                    else
+                        usage();
+                }
+            }
+            else if (auto v = value("--runs="))
+                o.runs = std::max(1, std::atoi(v));
+            else if (auto v = value("--touch="))
+                o.touch = std::max(0, std::atoi(v));
+            else if (auto v = value("--per-tu="))
+                o.per_tu = std::max(1, std::atoi(v));
+            else if (auto v = value("--jobs="))
+                o.jobs = std::max(1, std::atoi(v));
+            else if (auto v = value("--workdir="))
+                o.workdir = v;
+            else if (auto v = value("--cxx="))
+                o.cxx = v;
+            else if (auto v = value("--json="))
+                o.json_path = v;
+            else
+                usage();
+        }
+        if (o.counts.empty() || o.variants.empty())
+            usage();
+        return o;
+    }
+
+    std::int64_t now_ns()
+    {
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    bool run_command(const std::string& cmd)
+    {
+        return std::system(cmd.c_str()) == 0;
+    }
+
+    /**
+     * @brief 最多同时运行 jobs 个命令
+     * @return 所有命令都成功时返回 true
+     */
+    bool run_parallel(const std::vector<std::string>& commands, int jobs)
+    {
+        bool ok = true;
+        int running = 0;
+        auto reap = [&] {
+            int status = 0;
+            if (wait(&status) > 0)
+            {
+                running--;
+                ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+            }
+        };
+        for (const auto& cmd : commands)
+        {
+            while (running >= jobs)
+                reap();
+            const pid_t pid = fork();
+            if (pid < 0)
+                return false;
+            if (pid == 0)
+            {
+                execl("/bin/sh", "sh", "-c", cmd.c_str(), static_cast<char*>(nullptr));
+                _exit(127);
+            }
+            running++;
+        }
+        while (running > 0)
+            reap();
+        return ok;
+    }
+
+    std::int64_t file_size(const std::string& path)
+    {
+        struct stat st{};
+        return ::stat(path.c_str(), &st) == 0 ? static_cast<std::int64_t>(st.st_size) : -1;
+    }
+
+    /**
+     * @brief 检查编译器能否使用 C++20 的 constinit，不能时退回 C++17
+     * @details C++17 下 OnceCell 的 constexpr 构造函数同样保证常量初始化，只是缺少编译期检查
+     */
+    std::string pick_standard(const Options& o)
+    {
+        const std::string probe = o.workdir + "/probe.cpp";
+        {
+            std::ofstream out(probe);
+            out << "constinit int probe = 0;\nint main() { return probe; }\n";
+        }
+        const std::string cmd = o.cxx + " -std=c++20 -fsyntax-only " + probe + " >/dev/null 2>&1";
+        return run_command(cmd) ? "c++20" : "c++17";
+    }
+
+    // ---- 生成被测程序 ----
+
+    void write_common(const std::string& dir, Variant v, int tus)
+    {
+        std::ofstream out(dir + "/common.h");
+        out << "#pragma once\n"
+            "#include <cstdint>\n"
+            "#include <string>\n"
+            "#include <vector>\n";
+        if (v == Variant::LazyStatic || v == Variant::LazyStaticNamed)
+            out << "#include <cxxlazy/components/macros.h>\n";
+        else if (v == Variant::Constinit)
+            out << "#include <cxxlazy/components/once_call.h>\n"
+                "#if __cplusplus >= 202002L\n"
+                "#define BENCH_CONSTINIT constinit\n"
+                "#else\n"
+                "#define BENCH_CONSTINIT\n"
+                "#endif\n";
+        out << "struct Payload { std::uint64_t id; std::string name; std::vector<std::uint64_t> data; };\n"
+            "Payload make_payload(std::uint64_t id);\n";
+        for (int t = 0; t < tus; ++t)
+            out << "std::uint64_t touch_tu_" << t << "(int n);\n";
+    }
+
+    void write_tu(const std::string& dir, Variant v, int tu, int first, int last)
+    {
+        std::ofstream out(dir + "/tu_" + std::to_string(tu) + ".cpp");
+        out << "#include \"common.h\"\n\n";
+        for (int i = first; i < last; ++i)
+        {
+            switch (v)
+            {
+            case Variant::Eager:
+                out << "static Payload g_" << i << " = make_payload(" << i << ");\n";
+                break;
+            case Variant::LazyStatic:
+                out << "LAZY_STATIC(Payload, g_" << i << ", make_payload(" << i << "));\n";
+                break;
+            case Variant::LazyStaticNamed:
+                out << "LAZY_STATIC_NAMED(Payload, g_" << i << ", make_payload(" << i << "));\n";
+                break;
+            case Variant::Constinit:
+                out << "BENCH_CONSTINIT static components::OnceCell<Payload> g_" << i << ";\n";
+                break;
+            }
+        }
+        out << "\nstd::uint64_t touch_tu_" << tu << "(int n)\n{\n    std::uint64_t sum = 0;\n";
+        for (int i = first; i < last; ++i)
+        {
+            out << "    if (n-- <= 0) return sum;\n    sum += ";
+            switch (v)
+            {
+            case Variant::Eager:
+                out << "g_" << i << ".id;\n";
+                break;
+            case Variant::LazyStatic:
+            case Variant::LazyStaticNamed:
+                out << "g_" << i << "->id;\n";
+                break;
+            case Variant::Constinit:
+                out << "g_" << i << ".get_or_init([] { return make_payload(" << i << "); }).id;\n";
+                break;
+            }
+        }
+        out << "    return sum;\n}\n";
+    }
+
+    /**
+     * @brief 被测程序的 main：在入口处和处理完第一个请求后各记录一次时间和缺页数
+     * @details 父进程在 exec 之前把时间戳放入环境变量 CXXLAZY_SPAWN_NS
+     */
+    void write_main(const std::string& dir, int tus, int per_tu, int touch)
+    {
+        std::ofstream out(dir + "/main.cpp");
+        out << "#include \"common.h\"\n"
+            "#include <cstdio>\n"
+            "#include <cstdlib>\n"
+            "#include <ctime>\n"
+            "#include <sys/resource.h>\n\n"
+            "static long long now_ns()\n{\n"
+            "    timespec ts{};\n"
+            "    clock_gettime(CLOCK_MONOTONIC, &ts);\n"
+            "    return static_cast<long long>(ts.tv_sec) * 1000000000 + ts.tv_nsec;\n}\n\n"
+            "__attribute__((noinline)) Payload make_payload(std::uint64_t id)\n{\n"
+            "    return Payload{id, \"g_\" + std::to_string(id), std::vector<std::uint64_t>(8, id)};\n}\n\n"
+            "static std::uint64_t (*const kTouch[])(int) = {";
+        for (int t = 0; t < tus; ++t)
+            out << (t ? ", " : "") << "touch_tu_" << t;
+        out << "};\n\n"
+            "int main()\n{\n"
+            "    const long long main_ns = now_ns();\n"
+            "    rusage at_main{};\n"
+            "    getrusage(RUSAGE_SELF, &at_main);\n\n"
+            "    // 第一个请求：依次访问前 " << touch << " 个全局对象\n"
+            "    std::uint64_t sum = 0;\n"
+            "    int left = " << touch << ";\n"
+            "    for (int t = 0; t < " << tus << " && left > 0; ++t, left -= " << per_tu << ")\n"
+            "        sum += kTouch[t](left);\n"
+            "    const long long first_ns = now_ns();\n"
+            "    rusage at_first{};\n"
+            "    getrusage(RUSAGE_SELF, &at_first);\n\n"
+            "    const char* spawn = std::getenv(\"CXXLAZY_SPAWN_NS\");\n"
+            "    const long long spawn_ns = spawn ? std::atoll(spawn) : main_ns;\n"
+            "    std::printf(\"%lld %lld %ld %ld %llu\\n\", main_ns - spawn_ns, first_ns - spawn_ns,\n"
+            "                at_main.ru_minflt, at_first.ru_minflt, static_cast<unsigned long long>(sum));\n"
+            "    return 0;\n}\n";
+    }
+
+    /**
+     * @brief 生成并编译一个被测程序
+     * @return 可执行文件路径，失败时为空
+     */
+    std::string build(const Options& o, const std::string& standard, Variant v, int count, double& seconds)
+    {
+        const std::string dir = o.workdir + "/" + variant_name(v) + "_" + std::to_string(count);
+        run_command("mkdir -p " + dir);
+        const int tus = (count + o.per_tu - 1) / o.per_tu;
+        write_common(dir, v, tus);
+        for (int t = 0; t < tus; ++t)
+            write_tu(dir, v, t, t * o.per_tu, std::min(count, (t + 1) * o.per_tu));
+        write_main(dir, tus, o.per_tu, std::min(o.touch, count));
+
+        const auto start = std::chrono::steady_clock::now();
+        const std::string flags = " -std=" + standard + " -O2 -I" CXXLAZY_BENCH_INCLUDE_DIR " ";
+        std::string objects;
+        std::vector<std::string> commands;
+        for (int t = 0; t <= tus; ++t)
+        {
+            const std::string src = t < tus ? dir + "/tu_" + std::to_string(t) + ".cpp" : dir + "/main.cpp";
+            const std::string obj = src + ".o";
+            commands.push_back(o.cxx + flags + "-c " + src + " -o " + obj);
+            objects += " " + obj;
+        }
+        if (!run_parallel(commands, o.jobs))
+            return {};
+        const std::string exe = dir + "/program";
+        if (!run_command(o.cxx + " -o " + exe + objects + " " CXXLAZY_BENCH_LIBRARY " -lpthread"))
+            return {};
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return exe;
+    }
+
+    // ---- 启动与测量 ----
+
+    bool launch(const std::string& exe, Sample& s)
+    {
+        int fds[2];
+        if (pipe(fds) != 0)
+            return false;
+        const pid_t pid = fork();
+        if (pid < 0)
+            return false;
+        if (pid == 0)
+        {
+            dup2(fds[1], STDOUT_FILENO);
+            close(fds[0]);
+            close(fds[1]);
+            setenv("CXXLAZY_SPAWN_NS", std::to_string(now_ns()).c_str(), 1);
+            execl(exe.c_str(), exe.c_str(), static_cast<char*>(nullptr));
+            _exit(127);
+        }
+        close(fds[1]);
+        std::string output;
+        char buf[256];
+        ssize_t n;
+        while ((n = read(fds[0], buf, sizeof(buf))) > 0)
+            output.append(buf, static_cast<std::size_t>(n));
+        close(fds[0]);
+
+        int status = 0;
+        rusage usage{};
+        if (wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            return false;
+        long long exec_to_main = 0, first_request = 0;
+        unsigned long long checksum = 0;
+        if (std::sscanf(output.c_str(), "%lld %lld %ld %ld %llu", &exec_to_main, &first_request, &s.minflt_main,
+                        &s.minflt_first, &checksum) != 5)
+            return false;
+        s.exec_to_main_ns = exec_to_main;
+        s.first_request_ns = first_request;
+        s.minflt_total = usage.ru_minflt;
+        s.majflt_total = usage.ru_majflt;
+        s.maxrss_kb = usage.ru_maxrss;
+        return true;
+    }
+
+    template <typename T>
+    T median_of(std::vector<Sample>& samples, T Sample::* field)
+    {
+        std::sort(samples.begin(), samples.end(),
+                  [field](const Sample& a, const Sample& b) { return a.*field < b.*field; });
+        return samples[samples.size() / 2].*field;
+    }
+
+    Sample median(std::vector<Sample> samples)
+    {
+        Sample m;
+        m.exec_to_main_ns = median_of(samples, &Sample::exec_to_main_ns);
+        m.first_request_ns = median_of(samples, &Sample::first_request_ns);
+        m.minflt_main = median_of(samples, &Sample::minflt_main);
+        m.minflt_first = median_of(samples, &Sample::minflt_first);
+        m.minflt_total = median_of(samples, &Sample::minflt_total);
+        m.majflt_total = median_of(samples, &Sample::majflt_total);
+        m.maxrss_kb = median_of(samples, &Sample::maxrss_kb);
+        return m;
+    }
+
+    void print_header()
+    {
+        std::printf("%-17s %8s %9s %12s %14s %14s %11s %12s %12s %10s\n", "variant", "N", "build_s", "binary_KiB",
+                    "exec->main_us", "first_req_us", "minflt@main", "minflt@first", "minflt_total", "maxrss_KiB");
+    }
+
+    void print_row(const Row& r)
+    {
+        std::printf("%-17s %8d %9.1f %12lld %14.1f %14.1f %11ld %12ld %12ld %10ld\n", variant_name(r.variant),
+                    r.count, r.build_s, static_cast<long long>(r.binary_bytes / 1024),
+                    static_cast<double>(r.median.exec_to_main_ns) / 1e3,
+                    static_cast<double>(r.median.first_request_ns) / 1e3, r.median.minflt_main,
+                    r.median.minflt_first, r.median.minflt_total, r.median.maxrss_kb);
+        std::fflush(stdout);
+    }
+
+    void write_json(const Options& o, const std::string& standard, const std::vector<Row>& rows)
+    {
+        std::ofstream out(o.json_path);
+        out << "{\"standard\": \"" << standard << "\", \"runs\": " << o.runs << ", \"touch\": " << o.touch
+            << ", \"results\": [";
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            const auto& r = rows[i];
+            out << (i ? ", " : "") << "{\"variant\": \"" << variant_name(r.variant) << "\", \"count\": " << r.count
+                << ", \"build_s\": " << r.build_s << ", \"binary_bytes\": " << r.binary_bytes
+                << ", \"exec_to_main_ns\": " << r.median.exec_to_main_ns
+                << ", \"first_request_ns\": " << r.median.first_request_ns
+                << ", \"minflt_at_main\": " << r.median.minflt_main
+                << ", \"minflt_at_first_request\": " << r.median.minflt_first
+                << ", \"minflt_total\": " << r.median.minflt_total
+                << ", \"majflt_total\": " << r.median.majflt_total
+                << ", \"maxrss_kb\": " << r.median.maxrss_kb << "}";
+        }
+        out << "]}\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const Options o = parse(argc, argv);
+    if (!run_command("mkdir -p " + o.workdir))
+    {
+        std::cerr << "startup_bench: cannot create " << o.workdir << "\n";
+        return 1;
+    }
+    const std::string standard = pick_standard(o);
+    std::printf("compiler=%s std=%s runs=%d touch=%d\n", o.cxx.c_str(), standard.c_str(), o.runs, o.touch);
+    print_header();
+
+    std::vector<Row> rows;
+    for (int count : o.counts)
+    {
+        for (Variant v : o.variants)
+        {
+            Row r;
+            r.variant = v;
+            r.count = count;
+            const std::string exe = build(o, standard, v, count, r.build_s);
+            if (exe.empty())
+            {
+                std::cerr << "startup_bench: failed to build " << variant_name(v) << " N=" << count << "\n";
+                return 1;
+            }
+            r.binary_bytes = file_size(exe);
+
+            std::vector<Sample> samples;
+            Sample warmup;
+            launch(exe, warmup);
+            for (int i = 0; i < o.runs; ++i)
+            {
+                Sample s;
+                if (!launch(exe, s))
+                {
+                    std::cerr << "startup_bench: " << exe << " failed\n";
+                    return 1;
+                }
+                samples.push_back(s);
+            }
+            r.median = median(std::move(samples));
+            print_row(r);
+            rows.push_back(r);
+        }
+    }
+
+    if (!o.json_path.empty())
+        write_json(o, standard, rows);
+    return 0;
+}
@@ -0,0 +1,438 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+// 访问追踪回放：把 trace::start 记录的追踪在不同的缓存策略下模拟一遍，
+// 报告命中率、内存占用和初始化造成的停顿，用于选择 TTL、空闲淘汰阈值和内存预算
+//
+// 模拟是单线程的：每次未命中的代价是该单元在追踪中观察到的平均初始化耗时，
+// 应用自己的 reset 在所有策略下都会让值失效；失败的初始化不产生值，不计为访问
+//
+
+#include <cxxlazy/components/access_trace.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <list>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace components;
+
+namespace
+{
+    /**
+     * @brief 模拟的缓存策略，参数为 0 表示不启用该限制
+     */
+    struct Policy
+    {
+        std::string name;
+        /// @brief 初始化后经过该时间即失效
+        std::uint64_t ttl_ns = 0;
+        /// @brief 超过该时间没有访问即淘汰
+        std::uint64_t idle_ns = 0;
+        /// @brief 所有常驻值的总字节数上限，超出时按 LRU 淘汰
+        std::uint64_t budget_bytes = 0;
+    };
+
+    struct Result
+    {
+        Policy policy;
+        std::uint64_t accesses = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+        std::uint64_t stall_ns = 0;
+        std::uint64_t peak_bytes = 0;
+        double avg_bytes = 0;
+    };
+
+    /// @brief 每个单元从追踪中得到的模型参数
+    struct CellModel
+    {
+        std::string name;
+        std::uint64_t init_ns = 0;
+        std::uint64_t bytes = 0;
+    };
+
+    struct Options
+    {
+        std::string path;
+        std::vector<std::uint64_t> ttl_ms{100, 1000, 10000};
+        std::vector<std::uint64_t> idle_ms{100, 1000, 10000};
+        /// @brief 为空时使用 plain 策略峰值内存的 25%、50%、75%
+        std::vector<std::uint64_t> budget_kib;
+        std::string json_path;
+    };
+
+    [[noreturn]] void usage()
+    {
+        std::cerr << "usage: trace_replay TRACE [--ttl=MS,...] [--idle=MS,...] [--budget=KIB,...] [--json=PATH]\n";
+        std::exit(2);
+    }
+
+    std::vector<std::uint64_t> parse_list(const std::string& s)
+    {
+        std::vector<std::uint64_t> values;
+        std::stringstream ss(s);
+        std::string item;
+        while (std::getline(ss, item, ','))
+        {
+            if (!item.empty())
+                values.push_back(std::strtoull(item.c_str(), nullptr, 10));
+        }
+        return values;
+    }
+
+    Options parse(int argc, char** argv)
+    {
+        Options o;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&](const char* prefix) -> const char* {
+                auto n = std::char_traits<char>::length(prefix);
+                return arg.compare(0, n, prefix) == 0 ? arg.c_str() + n : nullptr;
+            };
+            if (auto v = value("--ttl="))
+                o.ttl_ms = parse_list(v);
+            else if (auto v = value("--idle="))
+                o.idle_ms = parse_list(v);
+            else if (auto v = value("--budget="))
+                o.budget_kib = parse_list(v);
+            else if (auto v = value("--json="))
+                o.json_path = v;
+            else if (arg.rfind("--", 0) == 0 || !o.path.empty())
+                usage();
+            else
+                o.path = arg;
+        }
+        if (o.path.empty())
+            usage();
+        return o;
+    }
+
+    /**
+     * @brief 得到值的事件才算一次访问；Failure 没有产生值，不算访问，也不会让单元常驻
+     */
+    bool is_access(trace::AccessKind kind)
+    {
+        return kind == trace::AccessKind::Hit || kind == trace::AccessKind::Wait || kind == trace::AccessKind::Init;
+    }
+
+    /**
+     * @brief 整理出回放用的事件：访问和重置
+     * @details
+     * 前一个初始化者失败时，等待者先记录一条 Wait，再自己执行初始化，记录 Init 或 Failure
+     * 同一线程、同一单元上紧跟着的 Wait 和 Init 是同一次访问，合并为一次未命中，耗时为两者之和；
+     * 紧跟着 Failure 的 Wait 没有得到值，与 Failure 一起丢弃；中间隔着该单元的 Reset 时不合并
+     */
+    std::vector<trace::AccessEvent> replay_events(const trace::Trace& t)
+    {
+        std::vector<trace::AccessEvent> events;
+        events.reserve(t.events.size());
+        // 每个线程最近一条尚未配对的 Wait 在 events 中的下标
+        std::unordered_map<std::uint16_t, std::size_t> pending_wait;
+        std::vector<bool> dropped;
+        for (const auto& e : t.events)
+        {
+            auto it = pending_wait.find(e.thread);
+            if (it != pending_wait.end())
+            {
+                trace::AccessEvent& wait = events[it->second];
+                const bool same_cell = wait.cell == e.cell;
+                const std::size_t index = it->second;
+                pending_wait.erase(it);
+                if (same_cell && e.kind == trace::AccessKind::Init)
+                {
+                    wait.kind = trace::AccessKind::Init;
+                    wait.duration_ns += e.duration_ns;
+                    wait.bytes = e.bytes;
+                    continue;
+                }
+                if (same_cell && e.kind == trace::AccessKind::Failure)
+                {
+                    dropped[index] = true;
+                    continue;
+                }
+            }
+            if (e.kind == trace::AccessKind::Reset)
+            {
+                // 重置之后的初始化是一次新的访问，不再与之前的等待合并
+                for (auto w = pending_wait.begin(); w != pending_wait.end();)
+                    w = events[w->second].cell == e.cell ? pending_wait.erase(w) : std::next(w);
+            }
+            else if (!is_access(e.kind))
+                continue;
+            if (e.kind == trace::AccessKind::Wait)
+                pending_wait[e.thread] = events.size();
+            events.push_back(e);
+            dropped.push_back(false);
+        }
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < events.size(); ++i)
+        {
+            if (!dropped[i])
+                events[kept++] = events[i];
+        }
+        events.resize(kept);
+        return events;
+    }
+
+    /**
+     * @brief 从追踪中估计每个单元的初始化耗时和值大小
+     * @details 没有观察到初始化的单元（追踪开始前已初始化）使用所有单元的平均初始化耗时
+     */
+    std::unordered_map<std::uint32_t, CellModel> build_models(const trace::Trace& t)
+    {
+        std::unordered_map<std::uint32_t, CellModel> models;
+        std::unordered_map<std::uint32_t, std::pair<std::uint64_t, std::uint64_t>> inits;
+        for (const auto& cell : t.cells)
+            models[cell.id] = CellModel{cell.name, 0, cell.bytes};
+
+        std::uint64_t total_ns = 0, total_inits = 0;
+        for (const auto& e : t.events)
+        {
+            if (e.kind != trace::AccessKind::Init)
+                continue;
+            auto& [sum, n] = inits[e.cell];
+            sum += e.duration_ns;
+            n++;
+            total_ns += e.duration_ns;
+            total_inits++;
+            models[e.cell].bytes = e.bytes;
+        }
+        const std::uint64_t fallback = total_inits ? total_ns / total_inits : 0;
+        for (auto& [id, model] : models)
+        {
+            auto it = inits.find(id);
+            model.init_ns = it != inits.end() ? it->second.first / it->second.second : fallback;
+            if (model.name.empty())
+                model.name = "#" + std::to_string(id);
+        }
+        return models;
+    }
+
+    /**
+     * @brief 在一个策略下回放追踪
+     */
+    Result simulate(const std::vector<trace::AccessEvent>& events,
+                    const std::unordered_map<std::uint32_t, CellModel>& models, const Policy& policy)
+    {
+        struct CellState
+        {
+            bool resident = false;
+            std::uint64_t loaded_at = 0;
+            std::uint64_t last_access = 0;
+            std::list<std::uint32_t>::iterator lru;
+        };
+
+        Result r;
+        r.policy = policy;
+        std::unordered_map<std::uint32_t, CellState> cells;
+        std::list<std::uint32_t> lru;
+        // (到期时间, 单元)；条目可能过时，弹出时再核对
+        using Deadline = std::pair<std::uint64_t, std::uint32_t>;
+        std::priority_queue<Deadline, std::vector<Deadline>, std::greater<>> deadlines;
+
+        std::uint64_t resident_bytes = 0;
+        double byte_ns = 0;
+        std::uint64_t clock = events.empty() ? 0 : events.front().timestamp_ns;
+        auto advance = [&](std::uint64_t now) {
+            if (now > clock)
+            {
+                byte_ns += static_cast<double>(resident_bytes) * static_cast<double>(now - clock);
+                clock = now;
+            }
+        };
+        auto bytes_of = [&](std::uint32_t id) { return models.at(id).bytes; };
+        auto unload = [&](std::uint32_t id, CellState& s) {
+            s.resident = false;
+            resident_bytes -= bytes_of(id);
+            if (policy.budget_bytes)
+                lru.erase(s.lru);
+        };
+        auto deadline_of = [&](const CellState& s) {
+            std::uint64_t d = UINT64_MAX;
+            if (policy.ttl_ns)
+                d = std::min(d, s.loaded_at + policy.ttl_ns);
+            if (policy.idle_ns)
+                d = std::min(d, s.last_access + policy.idle_ns);
+            return d;
+        };
+        auto expire_until = [&](std::uint64_t now) {
+            while (!deadlines.empty() && deadlines.top().first <= now)
+            {
+                auto [when, id] = deadlines.top();
+                deadlines.pop();
+                auto& s = cells[id];
+                if (!s.resident)
+                    continue;
+                const std::uint64_t actual = deadline_of(s);
+                if (actual > when)
+                {
+                    deadlines.emplace(actual, id);
+                    continue;
+                }
+                advance(when);
+                unload(id, s);
+                r.evictions++;
+            }
+        };
+
+        for (const auto& e : events)
+        {
+            if (!models.count(e.cell))
+                continue;
+            expire_until(e.timestamp_ns);
+            advance(e.timestamp_ns);
+            auto& s = cells[e.cell];
+            if (e.kind == trace::AccessKind::Reset)
+            {
+                if (s.resident)
+                    unload(e.cell, s);
+                continue;
+            }
+            r.accesses++;
+            if (s.resident)
+            {
+                r.hits++;
+                s.last_access = e.timestamp_ns;
+                if (policy.budget_bytes)
+                    lru.splice(lru.end(), lru, s.lru);
+                continue;
+            }
+
+            r.misses++;
+            r.stall_ns += models.at(e.cell).init_ns;
+            const std::uint64_t bytes = bytes_of(e.cell);
+            if (policy.budget_bytes)
+            {
+                while (!lru.empty() && resident_bytes + bytes > policy.budget_bytes)
+                {
+                    const std::uint32_t victim = lru.front();
+                    unload(victim, cells[victim]);
+                    r.evictions++;
+                }
+                s.lru = lru.insert(lru.end(), e.cell);
+            }
+            s.resident = true;
+            s.loaded_at = s.last_access = e.timestamp_ns;
+            resident_bytes += bytes;
+            r.peak_bytes = std::max(r.peak_bytes, resident_bytes);
+            if (policy.ttl_ns || policy.idle_ns)
+                deadlines.emplace(deadline_of(s), e.cell);
+        }
+
+        if (!events.empty())
+        {
+            const std::uint64_t end = events.back().timestamp_ns;
+            expire_until(end);
+            advance(end);
+            const std::uint64_t span = end - events.front().timestamp_ns;
+            r.avg_bytes = span ? byte_ns / static_cast<double>(span) : static_cast<double>(resident_bytes);
+        }
+        return r;
+    }
+
+    std::string format_bytes(std::uint64_t bytes)
+    {
+        if (bytes < 10 * 1024)
+            return std::to_string(bytes) + "B";
+        if (bytes < 10 * 1024 * 1024)
+            return std::to_string(bytes / 1024) + "KiB";
+        return std::to_string(bytes / (1024 * 1024)) + "MiB";
+    }
+
+    std::vector<Policy> policies(const Options& o, std::uint64_t plain_peak)
+    {
+        std::vector<Policy> list;
+        for (auto ms : o.ttl_ms)
+            list.push_back(Policy{"ttl=" + std::to_string(ms) + "ms", ms * 1000000, 0, 0});
+        for (auto ms : o.idle_ms)
+            list.push_back(Policy{"idle=" + std::to_string(ms) + "ms", 0, ms * 1000000, 0});
+        std::vector<std::uint64_t> budgets;
+        for (auto kib : o.budget_kib)
+            budgets.push_back(kib * 1024);
+        if (o.budget_kib.empty() && plain_peak > 0)
+            budgets = {plain_peak / 4, plain_peak / 2, plain_peak * 3 / 4};
+        for (auto bytes : budgets)
+            list.push_back(Policy{"budget=" + format_bytes(bytes), 0, 0, std::max<std::uint64_t>(bytes, 1)});
+        return list;
+    }
+
+    void print_row(const Result& r)
+    {
+        const double rate = r.accesses ? 100.0 * static_cast<double>(r.hits) / static_cast<double>(r.accesses) : 0;
+        std::printf("%-18s %10llu %8.2f%% %9llu %9llu %12.3f %12.1f %12.1f\n", r.policy.name.c_str(),
+                    static_cast<unsigned long long>(r.accesses), rate, static_cast<unsigned long long>(r.misses),
+                    static_cast<unsigned long long>(r.evictions), static_cast<double>(r.stall_ns) / 1e6,
+                    static_cast<double>(r.peak_bytes) / 1024, r.avg_bytes / 1024);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const Options o = parse(argc, argv);
+    std::ifstream in(o.path, std::ios::binary);
+    trace::Trace t;
+    if (!in || !trace::read(in, t))
+    {
+        std::cerr << "trace_replay: cannot read " << o.path << "\n";
+        return 1;
+    }
+    const auto models = build_models(t);
+    const auto events = replay_events(t);
+
+    // 追踪中实际观察到的情况
+    std::uint64_t observed_hits = 0, observed_accesses = 0, observed_stall = 0;
+    for (const auto& e : events)
+    {
+        if (!is_access(e.kind))
+            continue;
+        observed_accesses++;
+        observed_hits += e.kind == trace::AccessKind::Hit;
+        if (e.kind != trace::AccessKind::Hit)
+            observed_stall += e.duration_ns;
+    }
+    const std::uint64_t span = t.events.empty() ? 0 : t.events.back().timestamp_ns - t.events.front().timestamp_ns;
+    std::printf("trace=%s cells=%zu events=%zu span=%.3fs observed: hit_rate=%.2f%% stall=%.3fms\n",
+                o.path.c_str(), t.cells.size(), t.events.size(), static_cast<double>(span) / 1e9,
+                observed_accesses ? 100.0 * static_cast<double>(observed_hits) / static_cast<double>(observed_accesses)
+                                  : 0.0,
+                static_cast<double>(observed_stall) / 1e6);
+    std::printf("%-18s %10s %9s %9s %9s %12s %12s %12s\n", "policy", "accesses", "hit_rate", "misses", "evictions",
+                "stall_ms", "peak_KiB", "avg_KiB");
+
+    std::vector<Result> results;
+    results.push_back(simulate(events, models, Policy{"plain"}));
+    for (const auto& p : policies(o, results.front().peak_bytes))
+        results.push_back(simulate(events, models, p));
+    for (const auto& r : results)
+        print_row(r);
+
+    if (!o.json_path.empty())
+    {
+        std::ofstream out(o.json_path);
+        out << "{\"trace\": \"" << o.path << "\", \"cells\": " << t.cells.size() << ", \"events\": "
+            << t.events.size() << ", \"span_ns\": " << span << ", \"observed_hits\": " << observed_hits
+            << ", \"observed_accesses\": " << observed_accesses << ", \"observed_stall_ns\": " << observed_stall
+            << ", \"policies\": [";
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const auto& r = results[i];
+            out << (i ? ", " : "") << "{\"policy\": \"" << r.policy.name << "\", \"accesses\": " << r.accesses
+                << ", \"hits\": " << r.hits << ", \"misses\": " << r.misses << ", \"evictions\": " << r.evictions
+                << ", \"stall_ns\": " << r.stall_ns << ", \"peak_bytes\": " << r.peak_bytes
+                << ", \"avg_bytes\": " << r.avg_bytes << "}";
+        }
+        out << "]}\n";
+    }
+    return 0;
+}
@@ -7,5 +7,8 @@
 
 
 enum  class ErrorCode {
-
-};
\ No newline at end of file
+    /// @brief 初始化函数直接或间接地访问了自己所在的单元
+    ReentrantInitialization,
+    /// @brief 多个线程的初始化之间形成了相互等待的环
+    InitializationDeadlock,
+};
@@ -0,0 +1,379 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#include "access_trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace components::trace
+{
+    namespace
+    {
+        constexpr char kMagic[8] = {'C', 'X', 'L', 'T', 'R', 'A', 'C', 'E'};
+        constexpr std::uint32_t kVersion = 1;
+        constexpr std::uint32_t kEventsBlock = 1;
+        constexpr std::uint32_t kCellsBlock = 2;
+
+        /**
+         * @brief 一个线程的单生产者环形缓冲区
+         * @details head 只由所属线程推进；tail 只在持有 Recorder::io_mtx 时推进
+         */
+        struct ThreadBuffer
+        {
+            ThreadBuffer(std::size_t capacity, std::uint16_t thread, std::uint64_t session)
+                : events(capacity), thread(thread), session(session)
+            {
+            }
+
+            std::vector<AccessEvent> events;
+            std::atomic<std::uint64_t> head{0};
+            std::atomic<std::uint64_t> tail{0};
+            const std::uint16_t thread;
+            const std::uint64_t session;
+        };
+
+        struct Recorder
+        {
+            /// @brief 保护缓冲区列表、单元表和会话状态，持有期间从不进行文件 I/O
+            std::mutex mtx;
+            /// @brief 保护输出文件和各缓冲区 tail 的推进，只由刷写线程和 stop 获取
+            std::mutex io_mtx;
+            std::ofstream out;
+            std::size_t capacity = 0;
+            /// @brief 每次 start/stop 都会递增，旧会话的缓冲区据此失效
+            std::atomic<std::uint64_t> session{0};
+            std::uint16_t next_thread = 0;
+            std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+            std::map<std::uint32_t, TraceCell> cells;
+            /// @brief 因缓冲区已满或内存不足而丢弃的事件数
+            std::atomic<std::uint64_t> dropped{0};
+
+            /// @brief 后台刷写线程及其唤醒条件
+            std::thread flusher;
+            std::mutex flush_mtx;
+            std::condition_variable flush_cv;
+            bool flush_stop = false;
+            bool flush_requested = false;
+        };
+
+        Recorder& recorder()
+        {
+            // 与登记表相同，故意泄漏以便在静态析构阶段仍可安全调用
+            static auto* r = new Recorder();
+            return *r;
+        }
+
+        thread_local std::shared_ptr<ThreadBuffer> local_buffer;
+
+        void write_header(std::ostream& out, std::uint32_t type, std::uint32_t count)
+        {
+            out.write(reinterpret_cast<const char*>(&type), sizeof(type));
+            out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        }
+
+        /**
+         * @brief 把缓冲区中 [tail, head) 的事件写入文件，调用方持有 Recorder::io_mtx
+         */
+        void drain(Recorder& r, ThreadBuffer& buf)
+        {
+            const std::uint64_t head = buf.head.load(std::memory_order_acquire);
+            std::uint64_t tail = buf.tail.load(std::memory_order_relaxed);
+            if (r.out.is_open() && buf.session == r.session.load(std::memory_order_relaxed))
+            {
+                const std::size_t capacity = buf.events.size();
+                write_header(r.out, kEventsBlock, static_cast<std::uint32_t>(head - tail));
+                while (tail != head)
+                {
+                    const std::size_t begin = tail % capacity;
+                    const std::size_t n = std::min<std::uint64_t>(head - tail, capacity - begin);
+                    r.out.write(reinterpret_cast<const char*>(&buf.events[begin]),
+                                static_cast<std::streamsize>(n * sizeof(AccessEvent)));
+                    tail += n;
+                }
+            }
+            buf.tail.store(head, std::memory_order_release);
+        }
+
+        void note_cell(Recorder& r, const CellStats& stats)
+        {
+            auto& cell = r.cells[stats.id()];
+            if (cell.id == 0)
+            {
+                cell.id = stats.id();
+                cell.name = stats.name();
+            }
+        }
+
+        /**
+         * @brief 为当前线程创建本次会话的缓冲区
+         * @return 会话已结束或内存不足时返回 nullptr
+         */
+        ThreadBuffer* attach(Recorder& r, std::uint64_t session) noexcept
+        {
+            try
+            {
+                std::lock_guard<std::mutex> lock(r.mtx);
+                if (!enabled() || r.session.load(std::memory_order_relaxed) != session)
+                    return nullptr;
+                auto buf = std::make_shared<ThreadBuffer>(r.capacity, r.next_thread, session);
+                r.buffers.push_back(buf);
+                ++r.next_thread;
+                local_buffer = std::move(buf);
+                return local_buffer.get();
+            }
+            catch (...)
+            {
+                return nullptr;
+            }
+        }
+
+        /**
+         * @brief 把所有缓冲区中的事件写入文件
+         * @details 只在持有 mtx 时复制缓冲区列表，写文件时只持有 io_mtx，不阻塞记录单元名称的生产者
+         */
+        void flush_all(Recorder& r)
+        {
+            std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+            {
+                std::lock_guard<std::mutex> lock(r.mtx);
+                buffers = r.buffers;
+            }
+            std::lock_guard<std::mutex> io(r.io_mtx);
+            for (const auto& buf : buffers)
+                drain(r, *buf);
+        }
+
+        /**
+         * @brief 后台刷写线程：定期、或在某个缓冲区过半时被唤醒，把事件写入文件
+         */
+        void flush_loop(Recorder& r)
+        {
+            constexpr auto kInterval = std::chrono::milliseconds(10);
+            std::unique_lock<std::mutex> lock(r.flush_mtx);
+            while (!r.flush_stop)
+            {
+                r.flush_cv.wait_for(lock, kInterval, [&] { return r.flush_stop || r.flush_requested; });
+                r.flush_requested = false;
+                lock.unlock();
+                flush_all(r);
+                lock.lock();
+            }
+        }
+
+        /**
+         * @brief 请求刷写线程尽快写出，不等待、不进行 I/O
+         */
+        void request_flush(Recorder& r) noexcept
+        {
+            try
+            {
+                std::lock_guard<std::mutex> lock(r.flush_mtx);
+                r.flush_requested = true;
+            }
+            catch (...)
+            {
+                // 下一个周期仍会写出
+            }
+            r.flush_cv.notify_one();
+        }
+    }
+
+    bool start(const std::string& path, std::size_t buffer_events)
+    {
+        auto& r = recorder();
+        std::lock_guard<std::mutex> lock(r.mtx);
+        if (enabled() || r.out.is_open())
+            return false;
+        r.out.open(path, std::ios::binary | std::ios::trunc);
+        if (!r.out)
+            return false;
+        r.out.write(kMagic, sizeof(kMagic));
+        const std::uint32_t header[2] = {kVersion, 0};
+        r.out.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+        r.capacity = std::max<std::size_t>(buffer_events, 2);
+        r.next_thread = 0;
+        r.cells.clear();
+        r.dropped.store(0, std::memory_order_relaxed);
+        // 追踪开始前已初始化的单元之后只会产生命中事件，先把它们记下来
+        for (const auto& stats : LazyRegistry::instance().cells())
+            note_cell(r, *stats);
+        r.flush_stop = false;
+        r.flush_requested = false;
+        try
+        {
+            r.flusher = std::thread([&r] { flush_loop(r); });
+        }
+        catch (...)
+        {
+            r.out.close();
+            throw;
+        }
+        r.session.fetch_add(1, std::memory_order_relaxed);
+        enabled_flag.store(true, std::memory_order_release);
+        return true;
+    }
+
+    void stop()
+    {
+        auto& r = recorder();
+        enabled_flag.store(false, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(r.flush_mtx);
+            r.flush_stop = true;
+        }
+        r.flush_cv.notify_one();
+        if (r.flusher.joinable())
+            r.flusher.join();
+
+        std::lock_guard<std::mutex> lock(r.mtx);
+        std::lock_guard<std::mutex> io(r.io_mtx);
+        if (!r.out.is_open())
+            return;
+        for (const auto& buf : r.buffers)
+            drain(r, *buf);
+
+        for (const auto& stats : LazyRegistry::instance().cells())
+        {
+            if (auto it = r.cells.find(stats->id()); it != r.cells.end())
+                it->second.bytes = stats->snapshot().estimated_bytes;
+        }
+        write_header(r.out, kCellsBlock, static_cast<std::uint32_t>(r.cells.size()));
+        for (const auto& [id, cell] : r.cells)
+        {
+            const auto len = static_cast<std::uint32_t>(cell.name.size());
+            r.out.write(reinterpret_cast<const char*>(&id), sizeof(id));
+            r.out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+            r.out.write(reinterpret_cast<const char*>(&cell.bytes), sizeof(cell.bytes));
+            r.out.write(cell.name.data(), len);
+        }
+        r.out.close();
+        r.buffers.clear();
+        r.session.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t now_ns() noexcept
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    std::uint64_t dropped_events() noexcept
+    {
+        return recorder().dropped.load(std::memory_order_relaxed);
+    }
+
+    void append(const CellStats& stats, AccessKind kind, std::uint64_t timestamp_ns, std::uint64_t duration_ns,
+                std::size_t bytes) noexcept
+    {
+        auto& r = recorder();
+        const std::uint64_t session = r.session.load(std::memory_order_acquire);
+        ThreadBuffer* buf = local_buffer.get();
+        if (!buf || buf->session != session)
+        {
+            buf = attach(r, session);
+            if (!buf)
+            {
+                if (enabled())
+                    r.dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        // 缓冲区已满时丢弃并计数，写文件只由刷写线程进行，记录事件的线程从不等待 I/O
+        const std::uint64_t head = buf->head.load(std::memory_order_relaxed);
+        const std::size_t capacity = buf->events.size();
+        const std::uint64_t used = head - buf->tail.load(std::memory_order_acquire);
+        if (used == capacity)
+        {
+            r.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // 命中事件只可能发生在已记下的单元上，其余事件都在慢路径，可以承受一次加锁
+        if (kind != AccessKind::Hit)
+        {
+            try
+            {
+                std::lock_guard<std::mutex> lock(r.mtx);
+                note_cell(r, stats);
+            }
+            catch (...)
+            {
+                // 名称表记录失败时这条事件无法解释，直接丢弃
+                r.dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        AccessEvent& e = buf->events[head % capacity];
+        e.timestamp_ns = timestamp_ns;
+        e.duration_ns = duration_ns;
+        e.cell = stats.id();
+        e.bytes = static_cast<std::uint32_t>(std::min<std::size_t>(bytes, std::numeric_limits<std::uint32_t>::max()));
+        e.thread = buf->thread;
+        e.kind = kind;
+        e.reserved = 0;
+        buf->head.store(head + 1, std::memory_order_release);
+
+        // 刚过半时叫醒刷写线程，不必等到下一个周期
+        if (used + 1 == capacity / 2)
+            request_flush(r);
+    }
+
+    bool read(std::istream& in, Trace& out)
+    {
+        char magic[sizeof(kMagic)];
+        std::uint32_t header[2];
+        if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+            return false;
+        if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != kVersion)
+            return false;
+
+        out = Trace{};
+        std::uint32_t block[2];
+        while (in.read(reinterpret_cast<char*>(block), sizeof(block)))
+        {
+            const std::uint32_t count = block[1];
+            if (block[0] == kEventsBlock)
+            {
+                const std::size_t offset = out.events.size();
+                out.events.resize(offset + count);
+                if (!in.read(reinterpret_cast<char*>(out.events.data() + offset),
+                             static_cast<std::streamsize>(count * sizeof(AccessEvent))))
+                    return false;
+            }
+            else if (block[0] == kCellsBlock)
+            {
+                for (std::uint32_t i = 0; i < count; ++i)
+                {
+                    TraceCell cell;
+                    std::uint32_t len = 0;
+                    in.read(reinterpret_cast<char*>(&cell.id), sizeof(cell.id));
+                    in.read(reinterpret_cast<char*>(&len), sizeof(len));
+                    in.read(reinterpret_cast<char*>(&cell.bytes), sizeof(cell.bytes));
+                    cell.name.resize(len);
+                    if (!in.read(cell.name.data(), len))
+                        return false;
+                    out.cells.push_back(std::move(cell));
+                }
+            }
+            else
+                return false;
+        }
+        std::stable_sort(out.events.begin(), out.events.end(), [](const AccessEvent& a, const AccessEvent& b) {
+            return a.timestamp_ns < b.timestamp_ns;
+        });
+        return true;
+    }
+}
@@ -0,0 +1,135 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include "registry.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace components::trace
+{
+    /**
+     * @brief 访问事件的种类
+     */
+    enum class AccessKind : std::uint8_t
+    {
+        /// @brief 快速路径命中已初始化的值
+        Hit,
+        /// @brief 阻塞等待其他线程的初始化后得到值
+        Wait,
+        /// @brief 执行了初始化函数并成功
+        Init,
+        /// @brief 初始化函数抛出异常
+        Failure,
+        /// @brief 单元被重置
+        Reset,
+    };
+
+    /**
+     * @brief 追踪文件中的一条访问事件，按本机字节序原样写入，固定 32 字节
+     */
+    struct AccessEvent
+    {
+        /// @brief steady_clock 时间（纳秒），Init、Failure、Wait 为开始时间
+        std::uint64_t timestamp_ns;
+        /// @brief Init、Failure、Wait 的耗时（纳秒），其余为 0
+        std::uint64_t duration_ns;
+        /// @brief CellStats::id()
+        std::uint32_t cell;
+        /// @brief Init 时估算的值占用字节数（超过 4 GiB 时截断），其余为 0
+        std::uint32_t bytes;
+        /// @brief 记录该事件的线程在本次追踪中的编号
+        std::uint16_t thread;
+        AccessKind kind;
+        std::uint8_t reserved;
+    };
+
+    static_assert(sizeof(AccessEvent) == 32, "trace file layout");
+
+    /**
+     * @brief 追踪文件中的单元信息
+     */
+    struct TraceCell
+    {
+        std::uint32_t id = 0;
+        std::string name;
+        /// @brief 追踪结束时估算的值占用字节数，单元已销毁时为 0
+        std::uint64_t bytes = 0;
+    };
+
+    /**
+     * @brief 读取后的完整追踪
+     */
+    struct Trace
+    {
+        std::vector<TraceCell> cells;
+        /// @brief 按时间戳排序的事件
+        std::vector<AccessEvent> events;
+    };
+
+    /// @brief 追踪开关，默认关闭
+    inline std::atomic<bool> enabled_flag{false};
+
+    /**
+     * @brief 是否正在追踪
+     */
+    inline bool enabled() noexcept { return enabled_flag.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 开始把具名单元的访问事件记录到文件
+     * @details
+     * 每个线程先写入自己的环形缓冲区，后台刷写线程定期（以及某个缓冲区过半时）把事件整块写入文件，
+     * 记录事件的线程从不进行文件 I/O，也不会因为分配失败而抛出异常
+     * 缓冲区在两次刷写之间被写满时新事件被丢弃并计入 dropped_events()，突发访问较多时应增大 buffer_events
+     * 未开启时快速路径上只多一次 relaxed 读取；匿名单元不被记录
+     * @param path 追踪文件路径
+     * @param buffer_events 每个线程缓冲区可容纳的事件数
+     * @return 已在追踪或无法打开文件时返回 false
+     */
+    bool start(const std::string& path, std::size_t buffer_events = 16384);
+
+    /**
+     * @brief 结束追踪，停止刷写线程，写出所有线程缓冲区中剩余的事件和单元名称表并关闭文件
+     */
+    void stop();
+
+    /**
+     * @brief 本次（或最近一次）追踪中因缓冲区已满或内存不足而丢弃的事件数
+     */
+    std::uint64_t dropped_events() noexcept;
+
+    /**
+     * @brief 把一条事件追加到当前线程的缓冲区
+     * @details 缓冲区已满或内存不足时丢弃事件并计数，不进行文件 I/O
+     */
+    void append(const CellStats& stats, AccessKind kind, std::uint64_t timestamp_ns, std::uint64_t duration_ns,
+                std::size_t bytes) noexcept;
+
+    /**
+     * @brief 当前 steady_clock 时间（纳秒）
+     */
+    std::uint64_t now_ns() noexcept;
+
+    /**
+     * @brief 追踪开启且单元具名时记录一条没有耗时的事件
+     */
+    inline void record(const CellStats* stats, AccessKind kind) noexcept
+    {
+        if (enabled() && stats)
+            append(*stats, kind, now_ns(), 0, 0);
+    }
+
+    /**
+     * @brief 读取追踪文件
+     * @param in 以二进制方式打开的输入流
+     * @param out 输出参数
+     * @return 文件格式不正确时返回 false
+     */
+    bool read(std::istream& in, Trace& out);
+}
@@ -0,0 +1,77 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#include "alloc_tracking.h"
+
+#include <cstdlib>
+
+namespace components::alloc_tracking
+{
+    namespace
+    {
+        /// @brief 每块内存前面的头部
+        struct Header
+        {
+            std::size_t size;
+            CellStats* owner;
+        };
+
+        /// @brief 头部占用的空间，向上取整以保持 operator new 的对齐保证
+        constexpr std::size_t kHeaderSize =
+            (sizeof(Header) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+        void* try_allocate(std::size_t size) noexcept
+        {
+            void* raw = std::malloc(size + kHeaderSize);
+            if (!raw)
+                return nullptr;
+
+            CellStats* owner = detail::current_initializer();
+            auto* header = static_cast<Header*>(raw);
+            header->size = size;
+            header->owner = owner;
+            if (owner)
+                owner->record_alloc(size);
+            return static_cast<char*>(raw) + kHeaderSize;
+        }
+    }
+
+    void* allocate(std::size_t size)
+    {
+        if (size == 0)
+            size = 1;
+        while (true)
+        {
+            if (void* p = try_allocate(size))
+                return p;
+            std::new_handler handler = std::get_new_handler();
+            if (!handler)
+                throw std::bad_alloc();
+            handler();
+        }
+    }
+
+    void* allocate_nothrow(std::size_t size) noexcept
+    {
+        try
+        {
+            return allocate(size);
+        }
+        catch (...)
+        {
+            return nullptr;
+        }
+    }
+
+    void deallocate(void* ptr) noexcept
+    {
+        if (!ptr)
+            return;
+        void* raw = static_cast<char*>(ptr) - kHeaderSize;
+        auto* header = static_cast<Header*>(raw);
+        if (header->owner)
+            header->owner->record_free(header->size);
+        std::free(raw);
+    }
+}
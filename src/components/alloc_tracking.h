@@ -0,0 +1,122 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include "instrument.h"
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace components
+{
+    namespace alloc_tracking
+    {
+        /**
+         * @brief 分配内存，并把它归属到当前线程正在执行的具名初始化函数
+         * @details
+         * 供 CXXLAZY_TRACK_GLOBAL_ALLOCATIONS 定义的全局 operator new 使用
+         * 每块内存前面带一个小头部，记录大小和所属单元，释放时据此记账
+         * @param size 请求的字节数
+         * @return 分配到的内存，失败时按 operator new 的约定调用 new_handler 或抛出 std::bad_alloc
+         */
+        void* allocate(std::size_t size);
+
+        /**
+         * @brief 与 allocate 相同，但失败时返回 `nullptr`
+         */
+        void* allocate_nothrow(std::size_t size) noexcept;
+
+        /**
+         * @brief 释放由 allocate 分配的内存，并从所属单元的存活字节数中扣除
+         */
+        void deallocate(void* ptr) noexcept;
+    }
+
+    /**
+     * @class TrackingAllocator
+     * @brief 把分配记账到具名惰性单元的分配器适配器
+     * @details
+     * 构造时捕获当前线程正在执行的具名初始化函数（嵌套时为最内层），
+     * 之后通过它分配和释放的内存都记到该单元名下，即使释放发生在其他线程
+     * 与全局 operator new 替换不同，它只统计显式使用它的容器
+     * @tparam T 元素类型
+     */
+    template <typename T>
+    class TrackingAllocator
+    {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        /**
+         * @brief 构造分配器，归属到当前线程最内层的具名初始化函数
+         */
+        TrackingAllocator() noexcept
+        {
+            if (CellStats* stats = detail::current_initializer())
+                owner_ = stats->shared_from_this();
+        }
+
+        template <typename U>
+        TrackingAllocator(const TrackingAllocator<U>& other) noexcept : owner_(other.owner())
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            T* p = std::allocator<T>{}.allocate(n);
+            if (owner_)
+                owner_->record_alloc(n * sizeof(T));
+            return p;
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            std::allocator<T>{}.deallocate(p, n);
+            if (owner_)
+                owner_->record_free(n * sizeof(T));
+        }
+
+        /**
+         * @brief 分配所归属的单元，没有时为空
+         */
+        [[nodiscard]] const std::shared_ptr<CellStats>& owner() const noexcept { return owner_; }
+
+        template <typename U>
+        bool operator==(const TrackingAllocator<U>& other) const noexcept { return owner_ == other.owner(); }
+
+        template <typename U>
+        bool operator!=(const TrackingAllocator<U>& other) const noexcept { return !(*this == other); }
+
+    private:
+        std::shared_ptr<CellStats> owner_;
+    };
+}
+
+/**
+ * @brief 用带记账功能的版本替换全局 operator new/delete
+ * @details
+ * 可选功能：在程序中恰好一个 .cpp 文件的全局作用域展开一次
+ * 在具名单元初始化函数内发生的每次分配都会按字节数和次数记到该单元名下，
+ * 一个单元强制初始化另一个单元时记到最内层的单元名下
+ * 结果出现在 LazyRegistry 的统计信息和 Prometheus 指标中
+ * 对齐版本（std::align_val_t）的 operator new 不受影响
+ */
+#define CXXLAZY_TRACK_GLOBAL_ALLOCATIONS() \
+void* operator new(std::size_t size) { return components::alloc_tracking::allocate(size); } \
+void* operator new[](std::size_t size) { return components::alloc_tracking::allocate(size); } \
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept \
+{ return components::alloc_tracking::allocate_nothrow(size); } \
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept \
+{ return components::alloc_tracking::allocate_nothrow(size); } \
+void operator delete(void* ptr) noexcept { components::alloc_tracking::deallocate(ptr); } \
+void operator delete[](void* ptr) noexcept { components::alloc_tracking::deallocate(ptr); } \
+void operator delete(void* ptr, std::size_t) noexcept { components::alloc_tracking::deallocate(ptr); } \
+void operator delete[](void* ptr, std::size_t) noexcept { components::alloc_tracking::deallocate(ptr); } \
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { components::alloc_tracking::deallocate(ptr); } \
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { components::alloc_tracking::deallocate(ptr); }
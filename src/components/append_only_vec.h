@@ -0,0 +1,244 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace components
+{
+    namespace detail
+    {
+        /**
+         * @brief 最高位的 1 所在的位置，w 不能为 0
+         */
+        inline unsigned highest_bit(std::uint64_t w) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return 63u - static_cast<unsigned>(__builtin_clzll(w));
+#else
+            unsigned n = 0;
+            while (w >>= 1)
+                ++n;
+            return n;
+#endif
+        }
+    }
+
+    /**
+     * @class AppendOnlyVec
+     * @brief 只能追加的并发向量，元素地址稳定，按下标读取不加锁
+     * @details
+     * 元素存放在容量按 2 倍增长的桶里（第 b 个桶容纳 32 << b 个元素），桶在第一次被用到时才分配；
+     * 桶指针用比较交换发布，同时分配同一个桶的线程中只有一个胜出，其余释放自己的那份
+     * 写入者用一次 fetch_add 认领下标，在槽位上构造元素后设置槽位的就绪标志；
+     * 读取者只读取桶指针和就绪标志，从不阻塞，已经写入的元素在向量析构之前不会移动
+     *
+     * 元素构造抛出异常时，已认领的下标永远不会就绪，读取者把它当作空位
+     * @tparam T 元素类型
+     */
+    template <typename T>
+    class AppendOnlyVec
+    {
+    public:
+        /**
+         * @brief 构造一个空向量，常量初始化，不分配内存
+         */
+        constexpr AppendOnlyVec() noexcept = default;
+
+        /**
+         * @brief 析构所有已写入的元素并释放桶
+         */
+        ~AppendOnlyVec();
+
+        AppendOnlyVec(const AppendOnlyVec&) = delete;
+
+        AppendOnlyVec& operator=(const AppendOnlyVec&) = delete;
+
+        /**
+         * @brief 在末尾构造一个元素
+         * @return 元素的下标
+         */
+        template <typename... Args>
+        std::size_t emplace_back(Args&&... args);
+
+        /**
+         * @brief 在末尾追加一个元素
+         * @return 元素的下标
+         */
+        std::size_t push_back(const T& value) { return emplace_back(value); }
+
+        /**
+         * @brief 在末尾追加一个元素
+         * @return 元素的下标
+         */
+        std::size_t push_back(T&& value) { return emplace_back(std::move(value)); }
+
+        /**
+         * @brief 获取已写入的元素
+         * @return 下标超出范围或元素尚未写入完成时返回 nullptr
+         */
+        [[nodiscard]] const T* get(std::size_t index) const;
+
+        /**
+         * @brief 可变版本的 get
+         */
+        [[nodiscard]] T* get(std::size_t index);
+
+        /**
+         * @brief 获取已写入的元素
+         * @warning 元素必须已经写入完成，例如下标来自本线程的 push_back，或来自已与写入者同步的线程
+         */
+        const T& operator[](std::size_t index) const
+        {
+            const T* p = get(index);
+            assert(p && "AppendOnlyVec: element not written yet");
+            return *p;
+        }
+
+        /**
+         * @brief 已认领的下标数量
+         * @details 其中可能有正在写入、尚未就绪的元素
+         */
+        [[nodiscard]] std::size_t size() const { return claimed_.load(std::memory_order_acquire); }
+
+        /**
+         * @brief 按下标顺序访问所有已写入的元素
+         * @param fn 签名为 `void(std::size_t, const T&)`
+         */
+        template <typename Fn>
+        void for_each(Fn&& fn) const;
+
+    private:
+        struct Slot
+        {
+            alignas(T) unsigned char bytes[sizeof(T)];
+            std::atomic<bool> ready;
+
+            T* ptr() noexcept { return std::launder(reinterpret_cast<T*>(bytes)); }
+
+            const T* ptr() const noexcept { return std::launder(reinterpret_cast<const T*>(bytes)); }
+        };
+
+        static constexpr unsigned kFirstBucketBits = 5;
+        static constexpr std::size_t kFirstBucket = std::size_t{1} << kFirstBucketBits;
+        static constexpr unsigned kBuckets = 64 - kFirstBucketBits;
+
+        /// @brief 元素所在的桶和桶内偏移
+        struct Location
+        {
+            unsigned bucket;
+            std::size_t offset;
+        };
+
+        static Location locate(std::size_t index) noexcept
+        {
+            const std::uint64_t j = static_cast<std::uint64_t>(index) + kFirstBucket;
+            const unsigned top = detail::highest_bit(j);
+            return Location{top - kFirstBucketBits, static_cast<std::size_t>(j - (std::uint64_t{1} << top))};
+        }
+
+        static std::size_t bucket_size(unsigned bucket) noexcept { return kFirstBucket << bucket; }
+
+        const Slot* slot(std::size_t index) const;
+
+        /**
+         * @brief 获取桶，不存在时分配并用比较交换发布
+         */
+        Slot* bucket(unsigned b);
+
+        std::atomic<std::size_t> claimed_{0};
+        std::atomic<Slot*> buckets_[kBuckets] = {};
+    };
+
+    // ---------------- 实现 ----------------
+
+    template <typename T>
+    AppendOnlyVec<T>::~AppendOnlyVec()
+    {
+        for (unsigned b = 0; b < kBuckets; ++b)
+        {
+            Slot* slots = buckets_[b].load(std::memory_order_acquire);
+            if (!slots)
+                continue;
+            for (std::size_t i = 0; i < bucket_size(b); ++i)
+            {
+                if (slots[i].ready.load(std::memory_order_relaxed))
+                    slots[i].ptr()->~T();
+            }
+            delete[] slots;
+        }
+    }
+
+    template <typename T>
+    template <typename... Args>
+    std::size_t AppendOnlyVec<T>::emplace_back(Args&&... args)
+    {
+        const std::size_t index = claimed_.fetch_add(1, std::memory_order_relaxed);
+        const Location loc = locate(index);
+        Slot& s = bucket(loc.bucket)[loc.offset];
+        new(s.bytes) T(std::forward<Args>(args)...);
+        s.ready.store(true, std::memory_order_release);
+
+        // 写到当前桶的末尾附近时提前分配下一个桶，后续的写入者不必在分配上竞争
+        if (loc.offset == bucket_size(loc.bucket) - bucket_size(loc.bucket) / 8 && loc.bucket + 1 < kBuckets)
+            bucket(loc.bucket + 1);
+        return index;
+    }
+
+    template <typename T>
+    typename AppendOnlyVec<T>::Slot* AppendOnlyVec<T>::bucket(unsigned b)
+    {
+        Slot* slots = buckets_[b].load(std::memory_order_acquire);
+        if (slots)
+            return slots;
+        auto* fresh = new Slot[bucket_size(b)]();
+        if (buckets_[b].compare_exchange_strong(slots, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+            return fresh;
+        delete[] fresh;
+        return slots;
+    }
+
+    template <typename T>
+    const typename AppendOnlyVec<T>::Slot* AppendOnlyVec<T>::slot(std::size_t index) const
+    {
+        if (index >= claimed_.load(std::memory_order_acquire))
+            return nullptr;
+        const Location loc = locate(index);
+        const Slot* slots = buckets_[loc.bucket].load(std::memory_order_acquire);
+        if (!slots || !slots[loc.offset].ready.load(std::memory_order_acquire))
+            return nullptr;
+        return &slots[loc.offset];
+    }
+
+    template <typename T>
+    const T* AppendOnlyVec<T>::get(std::size_t index) const
+    {
+        const Slot* s = slot(index);
+        return s ? s->ptr() : nullptr;
+    }
+
+    template <typename T>
+    T* AppendOnlyVec<T>::get(std::size_t index)
+    {
+        return const_cast<T*>(std::as_const(*this).get(index));
+    }
+
+    template <typename T>
+    template <typename Fn>
+    void AppendOnlyVec<T>::for_each(Fn&& fn) const
+    {
+        const std::size_t n = size();
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (const T* p = get(i))
+                fn(i, *p);
+        }
+    }
+}
@@ -0,0 +1,135 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#include "checked.h"
+
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+namespace components
+{
+    namespace
+    {
+        std::string join(const std::vector<std::string>& chain)
+        {
+            std::string out;
+            for (const auto& name : chain)
+            {
+                if (!out.empty())
+                    out += " -> ";
+                out += name;
+            }
+            return out;
+        }
+
+        std::string message(ErrorCode code, const std::vector<std::string>& chain)
+        {
+            switch (code)
+            {
+            case ErrorCode::ReentrantInitialization:
+                return "reentrant lazy initialization: " + join(chain);
+            case ErrorCode::InitializationDeadlock:
+                return "lazy initialization deadlock: " + join(chain);
+            }
+            return join(chain);
+        }
+
+        /// @brief 正在被初始化的单元
+        struct Owner
+        {
+            std::thread::id thread;
+            std::string name;
+        };
+
+        /**
+         * @brief 全局等待图：哪个线程在初始化哪个单元，哪个线程在等待哪个单元
+         * @details 只在检查模式的慢路径上访问
+         */
+        struct WaitGraph
+        {
+            std::mutex mtx;
+            std::map<const void*, Owner> owners;
+            std::map<std::thread::id, const void*> waiting;
+        };
+
+        WaitGraph& graph()
+        {
+            // 故意泄漏，与 LazyRegistry 相同
+            static auto* g = new WaitGraph();
+            return *g;
+        }
+    }
+
+    LazyInitError::LazyInitError(ErrorCode code, std::vector<std::string> chain)
+        : std::logic_error(message(code, chain)), code_(code), chain_(std::move(chain))
+    {
+    }
+
+    namespace checked
+    {
+        std::string describe(const void* cell, const CellStats* stats)
+        {
+            if (stats)
+                return stats->name();
+            std::ostringstream os;
+            os << "<anonymous@" << cell << ">";
+            return os.str();
+        }
+
+        void begin_init(const void* cell, const CellStats* stats)
+        {
+            auto& g = graph();
+            std::lock_guard<std::mutex> lock(g.mtx);
+            g.owners[cell] = Owner{std::this_thread::get_id(), describe(cell, stats)};
+        }
+
+        void end_init(const void* cell) noexcept
+        {
+            auto& g = graph();
+            std::lock_guard<std::mutex> lock(g.mtx);
+            g.owners.erase(cell);
+        }
+
+        void begin_wait(const void* cell, const CellStats* stats)
+        {
+            auto& g = graph();
+            const auto me = std::this_thread::get_id();
+            std::lock_guard<std::mutex> lock(g.mtx);
+
+            // 沿着 “单元 -> 初始化它的线程 -> 该线程等待的单元” 前进，回到自己即为环
+            std::vector<std::string> chain{describe(cell, stats)};
+            const void* c = cell;
+            while (true)
+            {
+                auto owner = g.owners.find(c);
+                if (owner == g.owners.end())
+                    break;
+                if (owner->second.thread == me)
+                {
+                    chain.push_back(chain.front());
+                    throw LazyInitError(ErrorCode::InitializationDeadlock, std::move(chain));
+                }
+                auto next = g.waiting.find(owner->second.thread);
+                if (next == g.waiting.end())
+                    break;
+                c = next->second;
+                auto next_owner = g.owners.find(c);
+                chain.push_back(next_owner != g.owners.end() ? next_owner->second.name : describe(c, nullptr));
+                if (chain.size() > g.owners.size() + 1)
+                    break;
+            }
+            g.waiting[me] = cell;
+        }
+
+        void end_wait() noexcept
+        {
+            auto& g = graph();
+            std::lock_guard<std::mutex> lock(g.mtx);
+            g.waiting.erase(std::this_thread::get_id());
+        }
+    }
+}
@@ -0,0 +1,86 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include "../common/error_code.h"
+#include "registry.h"
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace components
+{
+    /**
+     * @class LazyInitError
+     * @brief 检查模式下发现重入或死锁时抛出的异常
+     * @details 携带涉及的单元名称链，例如 `a -> b -> a`
+     */
+    class LazyInitError : public std::logic_error
+    {
+    public:
+        LazyInitError(ErrorCode code, std::vector<std::string> chain);
+
+        /**
+         * @brief 错误类型
+         */
+        [[nodiscard]] ErrorCode code() const noexcept { return code_; }
+
+        /**
+         * @brief 涉及的单元名称链，首尾是同一个单元
+         */
+        [[nodiscard]] const std::vector<std::string>& chain() const noexcept { return chain_; }
+
+    private:
+        ErrorCode code_;
+        std::vector<std::string> chain_;
+    };
+
+    namespace checked
+    {
+        /// @brief 检查模式开关，默认关闭
+        inline std::atomic<bool> enabled_flag{false};
+
+        /**
+         * @brief 开启或关闭检查模式
+         * @details
+         * 开启后，初始化函数重入自己所在的单元、或多个线程的初始化相互等待时，
+         * 会抛出 LazyInitError 而不是永远挂起
+         * 检查只发生在慢路径上，已初始化单元的读取不受影响
+         */
+        inline void set_enabled(bool on) noexcept { enabled_flag.store(on, std::memory_order_relaxed); }
+
+        /**
+         * @brief 检查模式是否开启
+         */
+        inline bool enabled() noexcept { return enabled_flag.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief 单元在错误信息中的名称，匿名单元使用其地址
+         */
+        std::string describe(const void* cell, const CellStats* stats);
+
+        /**
+         * @brief 登记当前线程开始初始化某个单元
+         */
+        void begin_init(const void* cell, const CellStats* stats);
+
+        /**
+         * @brief 登记当前线程结束初始化某个单元
+         */
+        void end_init(const void* cell) noexcept;
+
+        /**
+         * @brief 登记当前线程即将阻塞等待某个单元，并检查等待图中是否出现环
+         * @throws LazyInitError 等待会形成死锁时抛出，此时不会留下登记
+         */
+        void begin_wait(const void* cell, const CellStats* stats);
+
+        /**
+         * @brief 登记当前线程结束等待
+         */
+        void end_wait() noexcept;
+    }
+}
@@ -0,0 +1,139 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#include "cpu.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+namespace components::detail
+{
+    std::size_t cpu_count() noexcept
+    {
+        static const std::size_t count = [] {
+#if defined(__linux__)
+            if (const long n = sysconf(_SC_NPROCESSORS_CONF); n > 0)
+                return static_cast<std::size_t>(n);
+#endif
+            return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        }();
+        return count;
+    }
+
+    std::size_t current_cpu() noexcept
+    {
+#if defined(__linux__)
+        const int cpu = sched_getcpu();
+        if (cpu >= 0)
+            return static_cast<std::size_t>(cpu) % cpu_count();
+#endif
+        static std::atomic<std::size_t> next{0};
+        thread_local const std::size_t slot = next.fetch_add(1, std::memory_order_relaxed) % cpu_count();
+        return slot;
+    }
+
+    namespace
+    {
+        struct NumaTopology
+        {
+            std::size_t nodes = 1;
+            /// @brief 按 CPU 编号索引的节点下标
+            std::vector<std::size_t> node_of_cpu;
+        };
+
+        NumaTopology read_topology()
+        {
+            NumaTopology topo;
+#if defined(__linux__)
+            try
+            {
+                std::ifstream online("/sys/devices/system/node/online");
+                std::string line;
+                if (!online || !std::getline(online, line))
+                    return topo;
+                const auto ids = parse_cpu_list(line);
+                if (ids.size() < 2)
+                    return topo;
+
+                std::vector<std::size_t> node_of_cpu(cpu_count(), 0);
+                for (std::size_t index = 0; index < ids.size(); ++index)
+                {
+                    std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(ids[index]) + "/cpulist");
+                    std::string cpus;
+                    if (!cpulist || !std::getline(cpulist, cpus))
+                        continue;
+                    for (const std::size_t cpu : parse_cpu_list(cpus))
+                    {
+                        if (cpu < node_of_cpu.size())
+                            node_of_cpu[cpu] = index;
+                    }
+                }
+                topo.nodes = ids.size();
+                topo.node_of_cpu = std::move(node_of_cpu);
+            }
+            catch (...)
+            {
+                // 读取拓扑失败时退化为单节点
+                return NumaTopology{};
+            }
+#endif
+            return topo;
+        }
+
+        const NumaTopology& topology()
+        {
+            // 与登记表相同，故意泄漏：静态析构阶段仍可能查询
+            static const auto* topo = new NumaTopology(read_topology());
+            return *topo;
+        }
+    }
+
+    std::vector<std::size_t> parse_cpu_list(std::string_view list)
+    {
+        std::vector<std::size_t> out;
+        while (!list.empty())
+        {
+            const std::size_t comma = list.find(',');
+            const std::string item(list.substr(0, comma));
+            list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+
+            char* end = nullptr;
+            const unsigned long first = std::strtoul(item.c_str(), &end, 10);
+            if (end == item.c_str())
+                continue;
+            unsigned long last = first;
+            if (*end == '-')
+            {
+                const char* begin = end + 1;
+                last = std::strtoul(begin, &end, 10);
+                if (end == begin || last < first)
+                    continue;
+            }
+            for (unsigned long id = first; id <= last; ++id)
+                out.push_back(static_cast<std::size_t>(id));
+        }
+        return out;
+    }
+
+    std::size_t numa_node_count() noexcept
+    {
+        return topology().nodes;
+    }
+
+    std::size_t numa_node_of(std::size_t cpu) noexcept
+    {
+        const auto& map = topology().node_of_cpu;
+        return cpu < map.size() ? map[cpu] : 0;
+    }
+}
@@ -0,0 +1,54 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace components::detail
+{
+    /**
+     * @brief 系统配置的 CPU 数量（包括当前离线的 CPU），至少为 1
+     * @details 进程启动后第一次调用时读取并缓存
+     */
+    std::size_t cpu_count() noexcept;
+
+    /**
+     * @brief 当前线程正在运行的 CPU 编号
+     * @details
+     * Linux 上使用 sched_getcpu()，较新的 glibc 通过 rseq 读取，不进入内核；
+     * 不支持时退化为线程编号：每个线程第一次调用时轮流分配一个编号并缓存在线程局部变量中
+     * 返回值只是提示，线程随时可能被迁移到其他 CPU，调用方不能依赖它做互斥
+     * @return 小于 cpu_count() 的编号
+     */
+    std::size_t current_cpu() noexcept;
+
+    /**
+     * @brief 解析内核的 CPU / 节点列表格式，例如 "0-3,8,10-11"
+     * @return 按出现顺序排列的编号，格式错误的部分被忽略
+     */
+    std::vector<std::size_t> parse_cpu_list(std::string_view list);
+
+    /**
+     * @brief NUMA 节点数量，至少为 1
+     * @details
+     * 进程启动后第一次调用时从 /sys/devices/system/node 读取拓扑并缓存，不依赖 libnuma；
+     * 读取失败或不是 Linux 时视为只有一个节点
+     * 节点编号被压缩为从 0 开始的连续下标
+     */
+    std::size_t numa_node_count() noexcept;
+
+    /**
+     * @brief CPU 所在的 NUMA 节点下标，未知的 CPU 属于节点 0
+     */
+    std::size_t numa_node_of(std::size_t cpu) noexcept;
+
+    /**
+     * @brief 当前线程所在的 NUMA 节点下标
+     * @details 与 current_cpu() 一样只是提示
+     */
+    inline std::size_t current_numa_node() noexcept { return numa_node_of(current_cpu()); }
+}
@@ -0,0 +1,268 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#include "dependency_graph.h"
+#include "registry.h"
+
+#include <cstdio>
+#include <set>
+#include <sstream>
+
+namespace components
+{
+    namespace
+    {
+        /// @brief 图中一个节点的耗时信息
+        struct Node
+        {
+            bool initialized = false;
+            std::uint64_t init_count = 0;
+            double mean_seconds = 0.0;
+            double max_seconds = 0.0;
+        };
+
+        /**
+         * @brief 汇总登记表中的耗时信息，同名单元合并
+         */
+        std::map<std::string, Node> collect_nodes(const std::vector<DependencyEdge>& edges)
+        {
+            std::map<std::string, Node> nodes;
+            std::map<std::string, std::pair<std::uint64_t, std::uint64_t>> timed;
+            for (const auto& s : LazyRegistry::instance().snapshot())
+            {
+                auto& n = nodes[s.name];
+                n.initialized = n.initialized || s.initialized;
+                n.init_count += s.init_count;
+                auto max = static_cast<double>(s.init_ns_max) / 1e9;
+                n.max_seconds = n.max_seconds > max ? n.max_seconds : max;
+                timed[s.name].first += s.init_ns_sum;
+                timed[s.name].second += s.init_sampled_count;
+            }
+            for (auto& [name, t] : timed)
+            {
+                if (t.second > 0)
+                    nodes[name].mean_seconds = static_cast<double>(t.first) / 1e9 / static_cast<double>(t.second);
+            }
+            // 已经析构的单元仍可能出现在边中
+            for (const auto& e : edges)
+            {
+                nodes.emplace(e.parent, Node{});
+                nodes.emplace(e.child, Node{});
+            }
+            return nodes;
+        }
+
+        std::vector<std::string> longest_chain(const std::vector<DependencyEdge>& edges,
+                                               const std::map<std::string, Node>& nodes)
+        {
+            std::map<std::string, std::vector<std::string>> children;
+            std::set<std::string> has_parent;
+            for (const auto& e : edges)
+            {
+                children[e.parent].push_back(e.child);
+                has_parent.insert(e.child);
+            }
+
+            auto heavier = [&](const std::string& a, const std::string& b) {
+                return nodes.at(a).mean_seconds > nodes.at(b).mean_seconds;
+            };
+
+            std::vector<std::string> path;
+            for (const auto& [name, node] : nodes)
+            {
+                if (has_parent.count(name) || !children.count(name))
+                    continue;
+                if (path.empty() || heavier(name, path.front()))
+                    path = {name};
+            }
+
+            std::set<std::string> visited(path.begin(), path.end());
+            while (!path.empty())
+            {
+                auto it = children.find(path.back());
+                if (it == children.end())
+                    break;
+                const std::string* next = nullptr;
+                for (const auto& c : it->second)
+                {
+                    if (!visited.count(c) && (!next || heavier(c, *next)))
+                        next = &c;
+                }
+                if (!next)
+                    break;
+                visited.insert(*next);
+                path.push_back(*next);
+            }
+            return path;
+        }
+
+        std::string quote(const std::string& s)
+        {
+            std::string out = "\"";
+            for (char c : s)
+            {
+                switch (c)
+                {
+                case '"': out += "\\\"";
+                    break;
+                case '\\': out += "\\\\";
+                    break;
+                case '\n': out += "\\n";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        char buf[8];
+                        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                        out += buf;
+                    }
+                    else
+                    {
+                        out += c;
+                    }
+                }
+            }
+            return out + "\"";
+        }
+    }
+
+    DependencyGraph& DependencyGraph::instance()
+    {
+        // 故意泄漏，与 LazyRegistry 相同
+        static auto* graph = new DependencyGraph();
+        return *graph;
+    }
+
+    void DependencyGraph::record(const CellStats& parent, CellStats& child)
+    {
+        auto* cached = child.last_dependency_.load(std::memory_order_acquire);
+        if (cached && cached->parent_id == parent.id())
+        {
+            cached->count.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto& counter = edges_[{parent.name(), child.name()}];
+        if (!counter)
+            counter = std::make_unique<detail::DependencyCounter>(parent.id());
+        counter->count.fetch_add(1, std::memory_order_relaxed);
+        child.last_dependency_.store(counter.get(), std::memory_order_release);
+    }
+
+    std::vector<DependencyEdge> DependencyGraph::edges() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        std::vector<DependencyEdge> result;
+        result.reserve(edges_.size());
+        for (const auto& [key, counter] : edges_)
+        {
+            if (const std::uint64_t count = counter->count.load(std::memory_order_relaxed))
+                result.push_back(DependencyEdge{key.first, key.second, count});
+        }
+        return result;
+    }
+
+    void DependencyGraph::clear()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (auto& [key, counter] : edges_)
+            counter->count.store(0, std::memory_order_relaxed);
+    }
+
+    std::vector<std::string> DependencyGraph::critical_path() const
+    {
+        auto e = edges();
+        return longest_chain(e, collect_nodes(e));
+    }
+
+    void DependencyGraph::write_dot(std::ostream& os) const
+    {
+        auto e = edges();
+        auto nodes = collect_nodes(e);
+        auto path = longest_chain(e, nodes);
+        std::set<std::pair<std::string, std::string>> critical;
+        for (std::size_t i = 1; i < path.size(); ++i)
+            critical.emplace(path[i - 1], path[i]);
+
+        std::ostringstream out;
+        out.precision(3);
+        out << std::fixed;
+        out << "digraph cxxlazy {\n";
+        out << "  rankdir=LR;\n";
+        out << "  node [shape=box];\n";
+        for (const auto& [name, n] : nodes)
+        {
+            std::ostringstream label;
+            label.precision(3);
+            label << std::fixed << name << "\nmean " << n.mean_seconds * 1e3 << " ms, max "
+                << n.max_seconds * 1e3 << " ms, x" << n.init_count;
+            out << "  " << quote(name) << " [label=" << quote(label.str());
+            if (!n.initialized)
+                out << ", style=dashed";
+            out << "];\n";
+        }
+        for (const auto& edge : e)
+        {
+            out << "  " << quote(edge.parent) << " -> " << quote(edge.child) << " [label=\"" << edge.count << "\"";
+            if (critical.count({edge.parent, edge.child}))
+                out << ", color=red, penwidth=2";
+            out << "];\n";
+        }
+        out << "}\n";
+        os << out.str();
+    }
+
+    void DependencyGraph::write_json(std::ostream& os) const
+    {
+        auto e = edges();
+        auto nodes = collect_nodes(e);
+        auto path = longest_chain(e, nodes);
+
+        std::ostringstream out;
+        out.precision(9);
+        out << "{\"nodes\":[";
+        bool first = true;
+        for (const auto& [name, n] : nodes)
+        {
+            out << (first ? "" : ",") << "{\"name\":" << quote(name)
+                << ",\"initialized\":" << (n.initialized ? "true" : "false")
+                << ",\"init_count\":" << n.init_count
+                << ",\"mean_init_seconds\":" << n.mean_seconds
+                << ",\"max_init_seconds\":" << n.max_seconds << "}";
+            first = false;
+        }
+        out << "],\"edges\":[";
+        first = true;
+        for (const auto& edge : e)
+        {
+            out << (first ? "" : ",") << "{\"from\":" << quote(edge.parent) << ",\"to\":" << quote(edge.child)
+                << ",\"count\":" << edge.count << "}";
+            first = false;
+        }
+        out << "],\"critical_path\":[";
+        first = true;
+        for (const auto& name : path)
+        {
+            out << (first ? "" : ",") << quote(name);
+            first = false;
+        }
+        out << "]}\n";
+        os << out.str();
+    }
+
+    std::string render_dependency_dot()
+    {
+        std::ostringstream os;
+        DependencyGraph::instance().write_dot(os);
+        return os.str();
+    }
+
+    std::string render_dependency_json()
+    {
+        std::ostringstream os;
+        DependencyGraph::instance().write_json(os);
+        return os.str();
+    }
+}
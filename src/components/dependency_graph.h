@@ -0,0 +1,120 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace components
+{
+    class CellStats;
+
+    namespace detail
+    {
+        /**
+         * @brief 一条依赖边的计数，由依赖图持有、从不释放，子单元缓存它以跳过重复的记录
+         */
+        struct DependencyCounter
+        {
+            explicit DependencyCounter(std::uint32_t parent_id) : parent_id(parent_id)
+            {
+            }
+
+            /// @brief 第一次记录这条边的父单元编号
+            const std::uint32_t parent_id;
+            std::atomic<std::uint64_t> count{0};
+        };
+    }
+
+    /**
+     * @brief 观察到的一条依赖：parent 的初始化函数强制初始化了 child
+     */
+    struct DependencyEdge
+    {
+        std::string parent;
+        std::string child;
+        /// @brief 观察到的次数
+        std::uint64_t count = 0;
+    };
+
+    /**
+     * @class DependencyGraph
+     * @brief 运行期间观察到的具名单元之间的初始化依赖
+     * @details
+     * 慢路径上的 InitScope 发现自己嵌套在另一个具名单元的初始化中时记录一条边，
+     * 匿名单元归属到最近的具名外层单元
+     * 可以导出为 Graphviz DOT 或 JSON，节点带有来自 LazyRegistry 的初始化耗时，
+     * 用于找出启动过程的关键路径，决定哪些单元需要预热、拆分或改为立即初始化
+     */
+    class DependencyGraph
+    {
+    public:
+        /**
+         * @brief 获取全局依赖图
+         */
+        static DependencyGraph& instance();
+
+        /**
+         * @brief 记录一次嵌套初始化
+         * @details
+         * 子单元缓存上一次记录的边：同一个父单元再次初始化它时只做一次原子加，
+         * 不获取互斥锁，也不构造名称键；只有第一次出现的边才进入有序表
+         */
+        void record(const CellStats& parent, CellStats& child);
+
+        /**
+         * @brief 获取所有观察到的边
+         */
+        [[nodiscard]] std::vector<DependencyEdge> edges() const;
+
+        /**
+         * @brief 清空已记录的边
+         * @details 计数清零但边本身保留，子单元缓存的指针始终有效；计数为 0 的边不出现在 edges() 中
+         */
+        void clear();
+
+        /**
+         * @brief 以 Graphviz DOT 格式写出依赖图，关键路径上的边标为红色
+         */
+        void write_dot(std::ostream& os) const;
+
+        /**
+         * @brief 以 JSON 格式写出依赖图和关键路径
+         */
+        void write_json(std::ostream& os) const;
+
+        /**
+         * @brief 计算关键路径
+         * @details
+         * 父单元的初始化耗时已经包含了它强制初始化的子单元，
+         * 因此从平均耗时最长的根节点出发，每一步走向平均耗时最长的子节点
+         * @return 从根到叶的单元名称
+         */
+        [[nodiscard]] std::vector<std::string> critical_path() const;
+
+    private:
+        DependencyGraph() = default;
+
+        mutable std::mutex mtx_;
+        std::map<std::pair<std::string, std::string>, std::unique_ptr<detail::DependencyCounter>> edges_;
+    };
+
+    /**
+     * @brief 以 Graphviz DOT 格式渲染全局依赖图
+     */
+    std::string render_dependency_dot();
+
+    /**
+     * @brief 以 JSON 格式渲染全局依赖图
+     */
+    std::string render_dependency_json();
+}
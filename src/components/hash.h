@@ -0,0 +1,24 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace components::detail
+{
+    /**
+     * @brief 打散哈希值的各个位（splitmix64 的最终混合步骤）
+     * @details std::hash 对整数通常是恒等映射，直接取低位做下标会让连续的键挤在一起
+     */
+    inline std::uint64_t mix_hash(std::uint64_t h) noexcept
+    {
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+}
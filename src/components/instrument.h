@@ -0,0 +1,250 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include "access_trace.h"
+#include "checked.h"
+#include "dependency_graph.h"
+#include "registry.h"
+#include "sampling.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace components::detail
+{
+    /**
+     * @brief 当前线程上一次正在进行的初始化
+     * @details 每个帧都在初始化函数所在的栈上，通过 parent 串成链表
+     */
+    struct InitFrame
+    {
+        const void* cell;
+        CellStats* stats;
+        InitFrame* parent;
+    };
+
+    /// @brief 当前线程最内层的初始化帧，没有正在进行的初始化时为空
+    inline thread_local InitFrame* current_frame = nullptr;
+
+    /**
+     * @class AttributionPause
+     * @brief 在作用域内暂停内存分配的归属
+     * @details 插桩自身的分配（依赖图的边、检查模式的登记等）不属于任何单元的初始化函数，不应计入外层单元
+     */
+    class AttributionPause
+    {
+    public:
+        AttributionPause() noexcept : saved_(std::exchange(current_frame, nullptr))
+        {
+        }
+
+        AttributionPause(const AttributionPause&) = delete;
+
+        AttributionPause& operator=(const AttributionPause&) = delete;
+
+        ~AttributionPause() { current_frame = saved_; }
+
+    private:
+        InitFrame* saved_;
+    };
+
+    /**
+     * @brief 当前线程正在执行的、最内层的具名初始化函数
+     * @details 匿名单元的初始化会归属到最近的具名外层单元
+     * @return 对应单元的统计信息，没有时返回 `nullptr`
+     */
+    inline CellStats* current_initializer() noexcept
+    {
+        for (InitFrame* f = current_frame; f; f = f->parent)
+        {
+            if (f->stats)
+                return f->stats;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief 检查模式下，确认当前线程没有在初始化该单元的过程中再次进入它
+     * @details 必须在尝试获取单元的互斥锁之前调用，否则重入会直接死锁
+     * @throws LazyInitError 发现重入时抛出，携带从该单元到当前位置的完整名称链
+     */
+    inline void check_reentry(const void* cell, const CellStats* stats)
+    {
+        if (!checked::enabled())
+            return;
+        std::vector<std::string> chain;
+        bool found = false;
+        for (InitFrame* f = current_frame; f && !found; f = f->parent)
+        {
+            chain.push_back(checked::describe(f->cell, f->stats));
+            found = f->cell == cell;
+        }
+        if (!found)
+            return;
+        std::reverse(chain.begin(), chain.end());
+        chain.push_back(checked::describe(cell, stats));
+        throw LazyInitError(ErrorCode::ReentrantInitialization, std::move(chain));
+    }
+
+    /**
+     * @class InitScope
+     * @brief 包裹一次初始化调用的作用域，只在慢路径上构造
+     * @details
+     * 负责计时（按采样策略），并在离开作用域时把成功或失败写入单元的统计信息
+     * 同时把自己压入当前线程的初始化栈，使内存分配等事件可以归属到正在初始化的单元，
+     * 嵌套在另一个具名单元的初始化中时向 DependencyGraph 记录一条边（插桩自身的分配不归属到外层单元），
+     * 访问追踪开启时记录一条 Init 或 Failure 事件
+     */
+    class InitScope
+    {
+    public:
+        /**
+         * @param cell 正在初始化的单元或槽位
+         * @param stats 统计信息，匿名时为空
+         * @param slot 是否为容器中共享统计信息的一个槽位，成功时按 CellStats::record_slot_init 记账
+         */
+        InitScope(const void* cell, CellStats* stats, bool slot = false)
+            : stats_(stats), frame_{cell, stats, current_frame}, slot_(slot)
+        {
+            CellStats* parent = stats_ ? current_initializer() : nullptr;
+            if ((parent && parent != stats_) || checked::enabled())
+            {
+                AttributionPause pause;
+                if (parent && parent != stats_)
+                    DependencyGraph::instance().record(*parent, *stats_);
+                if (checked::enabled())
+                {
+                    checked::begin_init(cell, stats);
+                    checked_ = true;
+                }
+            }
+            current_frame = &frame_;
+            if (stats_)
+            {
+                sampled_ = sampling::should_sample(*stats_);
+                std::int64_t started_ns = 0;
+                if (sampled_)
+                {
+                    start_ = std::chrono::steady_clock::now();
+                    started_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        start_.time_since_epoch()).count();
+                }
+                stats_->begin_init(started_ns);
+                if (trace::enabled())
+                {
+                    traced_ = true;
+                    trace_start_ns_ = trace::now_ns();
+                }
+            }
+        }
+
+        InitScope(const InitScope&) = delete;
+
+        InitScope& operator=(const InitScope&) = delete;
+
+        /**
+         * @brief 如果没有调用 succeed，说明初始化函数抛出了异常
+         */
+        ~InitScope()
+        {
+            current_frame = frame_.parent;
+            if (checked_)
+                checked::end_init(frame_.cell);
+            if (stats_ && !done_)
+            {
+                stats_->record_failure();
+                if (traced_)
+                    trace::append(*stats_, trace::AccessKind::Failure, trace_start_ns_,
+                                  trace::now_ns() - trace_start_ns_, 0);
+            }
+        }
+
+        /**
+         * @brief 标记初始化成功
+         * @param bytes 估算的值占用字节数
+         */
+        void succeed(std::size_t bytes) noexcept
+        {
+            done_ = true;
+            if (!stats_)
+                return;
+            std::int64_t ns = 0;
+            if (sampled_)
+                ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start_).count();
+            if (slot_)
+                stats_->record_slot_init(static_cast<std::uint64_t>(ns), bytes, sampled_);
+            else
+                stats_->record_init(static_cast<std::uint64_t>(ns), bytes, sampled_);
+            if (traced_)
+                trace::append(*stats_, trace::AccessKind::Init, trace_start_ns_, trace::now_ns() - trace_start_ns_,
+                              bytes);
+        }
+
+    private:
+        CellStats* stats_;
+        InitFrame frame_;
+        std::chrono::steady_clock::time_point start_{};
+        bool slot_;
+        bool done_ = false;
+        bool checked_ = false;
+        bool sampled_ = false;
+        bool traced_ = false;
+        std::uint64_t trace_start_ns_ = 0;
+    };
+
+    /**
+     * @class WaitScope
+     * @brief 包裹一次阻塞等待的作用域，只在慢路径上构造
+     * @details
+     * 在等待期间把单元的等待线程数加一，供看门狗等观察者读取
+     * 检查模式下同时登记等待关系，等待会形成死锁时抛出 LazyInitError，
+     * 访问追踪开启时记录一条 Wait 事件
+     */
+    class WaitScope
+    {
+    public:
+        WaitScope(const void* cell, CellStats* stats) : stats_(stats)
+        {
+            if (checked::enabled())
+            {
+                checked::begin_wait(cell, stats);
+                checked_ = true;
+            }
+            if (stats_)
+            {
+                stats_->record_wait();
+                if (trace::enabled())
+                    trace_start_ns_ = trace::now_ns();
+            }
+        }
+
+        WaitScope(const WaitScope&) = delete;
+
+        WaitScope& operator=(const WaitScope&) = delete;
+
+        ~WaitScope()
+        {
+            if (checked_)
+                checked::end_wait();
+            if (stats_)
+            {
+                stats_->end_wait();
+                if (trace_start_ns_ != 0)
+                    trace::append(*stats_, trace::AccessKind::Wait, trace_start_ns_,
+                                  trace::now_ns() - trace_start_ns_, 0);
+            }
+        }
+
+    private:
+        CellStats* stats_;
+        bool checked_ = false;
+        /// @brief 开始等待的时间，追踪关闭时为 0
+        std::uint64_t trace_start_ns_ = 0;
+    };
+}
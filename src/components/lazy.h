@@ -6,6 +6,7 @@
 
 #include "once_call.h"
 #include <functional>
+#include <string_view>
 #include <utility>
 
 namespace components {
@@ -24,6 +25,13 @@ namespace components {
          */
         explicit Lazy(InitFn init_fn);
 
+        /**
+         * @brief 构造一个具名的 Lazy 对象，并将其登记到 LazyRegistry
+         * @param name 在统计信息和指标中使用的名称
+         * @param init_fn 用于初始化值的函数
+         */
+        Lazy(std::string_view name, InitFn init_fn);
+
         Lazy(const Lazy &) = delete;
 
         Lazy &operator=(const Lazy &) = delete;
@@ -64,6 +72,7 @@ namespace components {
 
         /**
          * @brief 重置，清空已有的值
+         * @warning 不能与 get() 并发，之前返回的引用在重置后悬空
          */
         void reset();
 
@@ -73,6 +82,12 @@ namespace components {
          */
         explicit operator bool() const { return is_initialized(); }
 
+        /**
+         * @brief 获取统计信息
+         * @return 具名对象返回其统计信息，匿名对象返回 `nullptr`
+         */
+        [[nodiscard]] const CellStats* stats() const { return cell_.stats(); }
+
     private:
         OnceCell<T> cell_;
         InitFn init_fn_;
@@ -85,6 +100,11 @@ namespace components {
         : init_fn_(std::move(init_fn)) {
     }
 
+    template<typename T>
+    Lazy<T>::Lazy(std::string_view name, InitFn init_fn)
+        : cell_(name), init_fn_(std::move(init_fn)) {
+    }
+
     template<typename T>
     T &Lazy<T>::get() {
         return cell_.get_or_init(init_fn_);
@@ -131,6 +151,15 @@ namespace components {
             : init_fn_(std::move(init_fn)) {
         }
 
+        /**
+         * @brief 构造一个具名的 Lazy<void> 对象，并将其登记到 LazyRegistry
+         * @param name 在统计信息和指标中使用的名称
+         * @param init_fn 用于初始化的函数
+         */
+        Lazy(std::string_view name, InitFn init_fn)
+            : once_(name), init_fn_(std::move(init_fn)) {
+        }
+
         Lazy(const Lazy &) = delete;
 
         Lazy &operator=(const Lazy &) = delete;
@@ -165,6 +194,12 @@ namespace components {
             once_.reset();
         }
 
+        /**
+         * @brief 获取统计信息
+         * @return 具名对象返回其统计信息，匿名对象返回 `nullptr`
+         */
+        [[nodiscard]] const CellStats* stats() const { return once_.stats(); }
+
     private:
         OnceCall once_;
         InitFn init_fn_;
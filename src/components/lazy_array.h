@@ -0,0 +1,239 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include "instrument.h"
+#include "slot_init.h"
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <utility>
+
+namespace components
+{
+    namespace detail
+    {
+        /**
+         * @brief 最低位的 1 所在的位置，w 不能为 0
+         */
+        inline int lowest_bit(std::uint64_t w) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctzll(w);
+#else
+            int n = 0;
+            while (!(w & 1))
+            {
+                w >>= 1;
+                ++n;
+            }
+            return n;
+#endif
+        }
+    }
+
+    /**
+     * @class LazyArray
+     * @brief 固定大小的惰性槽位数组，每个槽位在第一次访问时用其下标独立初始化
+     * @details
+     * 与 `std::vector<OnceCell<T>>` 不同，槽位不携带互斥锁和原子状态：
+     * 值连续存放在一块缓冲区中，状态存放在两张独立的原子位图里（已认领、已初始化），
+     * 每个槽位只额外占用 2 位；等待其他线程初始化的线程停在全局的条带化等待表上
+     * 值缓冲区在槽位初始化之前不会被写入，大数组中从未访问的页面不会占用物理内存
+     * 初始化函数抛出异常时槽位回到未初始化，等待的线程之一会重新尝试
+     * @tparam T 槽位中存储的数据类型
+     */
+    template <typename T>
+    class LazyArray
+    {
+    public:
+        using InitFn = std::function<T(std::size_t)>;
+
+        /**
+         * @brief 构造一个匿名的惰性数组
+         * @param size 槽位数量
+         * @param init_fn 槽位的初始化函数，参数为槽位下标
+         */
+        LazyArray(std::size_t size, InitFn init_fn);
+
+        /**
+         * @brief 构造一个具名的惰性数组，并将其登记到 LazyRegistry
+         * @details 所有槽位共享一份统计信息：每个槽位的初始化计为一次初始化（不计为 reload），估算字节数为所有槽位之和
+         * @param name 在统计信息和指标中使用的名称
+         * @param size 槽位数量
+         * @param init_fn 槽位的初始化函数，参数为槽位下标
+         */
+        LazyArray(std::string_view name, std::size_t size, InitFn init_fn);
+
+        /**
+         * @brief 析构所有已初始化的值，具名数组会从 LazyRegistry 注销
+         */
+        ~LazyArray();
+
+        LazyArray(const LazyArray&) = delete;
+
+        LazyArray& operator=(const LazyArray&) = delete;
+
+        /**
+         * @brief 获取槽位的值，如果尚未初始化，则先进行初始化
+         * @param index 槽位下标，必须小于 size()
+         * @return 值的引用
+         * @throws LazyInitError 检查模式下发现重入或初始化死锁时抛出
+         */
+        T& get(std::size_t index);
+
+        /**
+         * @brief 等同于 get(index)
+         */
+        T& operator[](std::size_t index) { return get(index); }
+
+        /**
+         * @brief 尝试获取槽位的值，不会触发初始化
+         * @return 已初始化时返回值指针，否则返回 nullptr
+         */
+        [[nodiscard]] const T* try_get(std::size_t index) const;
+
+        /**
+         * @brief 检查槽位是否已经初始化
+         */
+        [[nodiscard]] bool is_initialized(std::size_t index) const;
+
+        /**
+         * @brief 槽位数量
+         */
+        [[nodiscard]] std::size_t size() const { return size_; }
+
+        /**
+         * @brief 已初始化的槽位数量
+         * @details 逐字扫描位图，每次处理 64 个槽位
+         */
+        [[nodiscard]] std::size_t initialized_count() const;
+
+        /**
+         * @brief 按下标顺序访问所有已初始化的槽位，不会触发初始化
+         * @details 逐字扫描位图并跳过全零的字，遍历期间新初始化的槽位可能被访问也可能不被访问
+         * @param fn 签名为 `void(std::size_t, T&)`
+         */
+        template <typename Fn>
+        void for_each_initialized(Fn&& fn);
+
+        /**
+         * @brief 获取统计信息
+         * @return 具名数组返回其统计信息，匿名数组返回 `nullptr`
+         */
+        [[nodiscard]] const CellStats* stats() const { return stats_; }
+
+    private:
+        static constexpr std::size_t kWordBits = 64;
+
+        static std::size_t word_of(std::size_t index) { return index / kWordBits; }
+
+        static std::uint64_t bit_of(std::size_t index) { return std::uint64_t{1} << (index % kWordBits); }
+
+        T& init_slot(std::size_t index);
+
+        std::size_t size_;
+        std::size_t words_;
+        InitFn init_fn_;
+        /// @brief 已初始化位图
+        std::unique_ptr<std::atomic<std::uint64_t>[]> ready_;
+        /// @brief 已认领位图：正在初始化或已初始化
+        std::unique_ptr<std::atomic<std::uint64_t>[]> claimed_;
+        T* values_;
+        CellStats* stats_ = nullptr;
+    };
+
+    // ---------------- 实现 ----------------
+
+    template <typename T>
+    LazyArray<T>::LazyArray(std::size_t size, InitFn init_fn)
+        : size_(size), words_((size + kWordBits - 1) / kWordBits), init_fn_(std::move(init_fn)),
+          ready_(new std::atomic<std::uint64_t>[words_]()), claimed_(new std::atomic<std::uint64_t>[words_]()),
+          values_(static_cast<T*>(::operator new(sizeof(T) * size, std::align_val_t(alignof(T)))))
+    {
+    }
+
+    template <typename T>
+    LazyArray<T>::LazyArray(std::string_view name, std::size_t size, InitFn init_fn)
+        : LazyArray(size, std::move(init_fn))
+    {
+        stats_ = LazyRegistry::instance().add(name);
+    }
+
+    template <typename T>
+    LazyArray<T>::~LazyArray()
+    {
+        for_each_initialized([](std::size_t, T& value) { value.~T(); });
+        ::operator delete(values_, std::align_val_t(alignof(T)));
+        if (stats_)
+            LazyRegistry::instance().remove(stats_);
+    }
+
+    template <typename T>
+    T& LazyArray<T>::get(std::size_t index)
+    {
+        if (ready_[word_of(index)].load(std::memory_order_acquire) & bit_of(index))
+        {
+            trace::record(stats_, trace::AccessKind::Hit);
+            return values_[index];
+        }
+        return init_slot(index);
+    }
+
+    template <typename T>
+    T& LazyArray<T>::init_slot(std::size_t index)
+    {
+        const void* slot = values_ + index;
+        const std::uint64_t bit = bit_of(index);
+
+        detail::init_slot_once(slot, stats_, claimed_[word_of(index)], bit, ready_[word_of(index)], bit, [&] {
+            new(values_ + index) T(init_fn_(index));
+            return ByteEstimator<T>{}(values_[index]);
+        });
+        return values_[index];
+    }
+
+    template <typename T>
+    const T* LazyArray<T>::try_get(std::size_t index) const
+    {
+        return is_initialized(index) ? values_ + index : nullptr;
+    }
+
+    template <typename T>
+    bool LazyArray<T>::is_initialized(std::size_t index) const
+    {
+        return ready_[word_of(index)].load(std::memory_order_acquire) & bit_of(index);
+    }
+
+    template <typename T>
+    std::size_t LazyArray<T>::initialized_count() const
+    {
+        std::size_t count = 0;
+        for (std::size_t w = 0; w < words_; ++w)
+            count += std::bitset<kWordBits>(ready_[w].load(std::memory_order_relaxed)).count();
+        return count;
+    }
+
+    template <typename T>
+    template <typename Fn>
+    void LazyArray<T>::for_each_initialized(Fn&& fn)
+    {
+        for (std::size_t w = 0; w < words_; ++w)
+        {
+            std::uint64_t bits = ready_[w].load(std::memory_order_acquire);
+            while (bits)
+            {
+                const std::size_t index = w * kWordBits + static_cast<std::size_t>(detail::lowest_bit(bits));
+                fn(index, values_[index]);
+                bits &= bits - 1;
+            }
+        }
+    }
+}
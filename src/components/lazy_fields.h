@@ -0,0 +1,250 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include "slot_init.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace components
+{
+    /**
+     * @brief 以编译期常量指定初始化函数的字段描述
+     * @details Init 可以是成员函数指针 `R (Owner::*)() const` 或自由函数指针 `R (*)(const Owner&)`
+     * @tparam Init 初始化函数
+     */
+    template <auto Init>
+    struct LazyField
+    {
+        template <typename Owner>
+        decltype(auto) operator()(const Owner& owner) const
+        {
+            return std::invoke(Init, owner);
+        }
+    };
+
+    namespace detail
+    {
+        template <typename Sig>
+        struct init_result;
+
+        template <typename R, typename C>
+        struct init_result<R (C::*)() const>
+        {
+            using type = R;
+        };
+
+        template <typename R, typename C>
+        struct init_result<R (C::*)() const noexcept>
+        {
+            using type = R;
+        };
+
+        template <typename R, typename A>
+        struct init_result<R (*)(A)>
+        {
+            using type = R;
+        };
+
+        template <typename R, typename A>
+        struct init_result<R (*)(A) noexcept>
+        {
+            using type = R;
+        };
+
+        template <typename R, typename C, typename A>
+        struct init_result<R (C::*)(A) const>
+        {
+            using type = R;
+        };
+
+        template <typename R, typename C, typename A>
+        struct init_result<R (C::*)(A) const noexcept>
+        {
+            using type = R;
+        };
+
+        template <typename F, typename = void>
+        struct field_value
+        {
+            /// @brief 无状态可调用对象：从非模板的 operator() 推导
+            using type = std::decay_t<typename init_result<decltype(&F::operator())>::type>;
+        };
+
+        template <typename F>
+        struct field_value<F, std::void_t<typename F::type>>
+        {
+            /// @brief 描述类型显式声明了值类型
+            using type = typename F::type;
+        };
+
+        template <auto Init>
+        struct field_value<LazyField<Init>, void>
+        {
+            using type = std::decay_t<typename init_result<decltype(Init)>::type>;
+        };
+
+        template <typename F, typename... Fs>
+        struct field_index;
+
+        template <typename F, typename... Fs>
+        struct field_index<F, F, Fs...> : std::integral_constant<std::size_t, 0>
+        {
+        };
+
+        template <typename F, typename G, typename... Fs>
+        struct field_index<F, G, Fs...> : std::integral_constant<std::size_t, 1 + field_index<F, Fs...>::value>
+        {
+        };
+
+        /**
+         * @brief 未初始化的字段存储
+         */
+        template <typename T>
+        struct FieldStorage
+        {
+            alignas(T) unsigned char bytes[sizeof(T)];
+
+            T* ptr() noexcept { return std::launder(reinterpret_cast<T*>(bytes)); }
+        };
+    }
+
+    /**
+     * @class LazyFields
+     * @brief 一个对象的一组惰性派生字段，共享一个原子状态字
+     * @details
+     * 面向带有多个缓存派生属性（哈希、规范化名称、解析结果等）的领域对象：
+     * 每个字段只存储值本身，所有字段的状态放在同一个 64 位原子字里（低 32 位为已初始化，高 32 位为已认领），
+     * 等待其他线程初始化的线程停在全局的条带化等待表上；
+     * 初始化函数在编译期由字段描述指定，不存储 std::function 或互斥锁
+     *
+     * 字段描述可以是：
+     * - `LazyField<&Owner::compute_x>` 或 `LazyField<&free_function>`；
+     * - 无状态的可调用类型，`F{}(owner)` 返回值，值类型从非模板的 operator() 推导，或由 `using type = T;` 指定
+     *
+     * 复制一个 LazyFields 得到一组未初始化的字段：派生值属于原对象，副本按需重新计算
+     * @tparam Fs 字段描述，最多 32 个，不能重复
+     */
+    template <typename... Fs>
+    class LazyFields
+    {
+        static_assert(sizeof...(Fs) > 0 && sizeof...(Fs) <= 32, "LazyFields supports 1 to 32 fields");
+
+    public:
+        /// @brief 字段描述 F 的值类型
+        template <typename F>
+        using value_t = typename detail::field_value<F>::type;
+
+        LazyFields() noexcept = default;
+
+        LazyFields(const LazyFields&) noexcept
+        {
+        }
+
+        LazyFields& operator=(const LazyFields& other) noexcept
+        {
+            if (this != &other)
+                reset();
+            return *this;
+        }
+
+        ~LazyFields() { destroy_all(std::index_sequence_for<Fs...>{}); }
+
+        /**
+         * @brief 获取字段的值，如果尚未初始化，则用 owner 计算
+         * @tparam F 字段描述
+         * @param owner 传给初始化函数的对象，通常是持有这组字段的对象本身
+         * @throws 初始化函数抛出的异常，之后的调用会重新计算
+         */
+        template <typename F, typename Owner>
+        const value_t<F>& get(const Owner& owner) const
+        {
+            constexpr std::size_t I = detail::field_index<F, Fs...>::value;
+            auto& storage = std::get<I>(values_);
+            if (!(state_.load(std::memory_order_acquire) & ready_bit(I)))
+                init<F>(I, storage, owner);
+            return *storage.ptr();
+        }
+
+        /**
+         * @brief 按下标获取字段的值
+         */
+        template <std::size_t I, typename Owner>
+        const auto& get(const Owner& owner) const
+        {
+            return get<std::tuple_element_t<I, std::tuple<Fs...>>>(owner);
+        }
+
+        /**
+         * @brief 检查字段是否已经初始化
+         */
+        template <typename F>
+        [[nodiscard]] bool is_initialized() const
+        {
+            return state_.load(std::memory_order_acquire) & ready_bit(detail::field_index<F, Fs...>::value);
+        }
+
+        /**
+         * @brief 已初始化的字段数量
+         */
+        [[nodiscard]] std::size_t initialized_count() const
+        {
+            auto ready = static_cast<std::uint32_t>(state_.load(std::memory_order_acquire));
+            std::size_t n = 0;
+            for (; ready; ready &= ready - 1)
+                ++n;
+            return n;
+        }
+
+        /**
+         * @brief 清除所有字段，下一次访问时重新计算
+         * @warning 不能与 get 并发调用，通常在持有对象的写锁或修改对象时调用
+         */
+        void reset() noexcept
+        {
+            destroy_all(std::index_sequence_for<Fs...>{});
+            state_.store(0, std::memory_order_release);
+        }
+
+    private:
+        static constexpr std::uint64_t ready_bit(std::size_t i) { return std::uint64_t{1} << i; }
+
+        static constexpr std::uint64_t claimed_bit(std::size_t i) { return std::uint64_t{1} << (32 + i); }
+
+        template <typename F, typename Storage, typename Owner>
+        void init(std::size_t i, Storage& storage, const Owner& owner) const
+        {
+            using T = value_t<F>;
+            detail::init_slot_once(storage.bytes, nullptr, state_, claimed_bit(i), state_, ready_bit(i), [&] {
+                new(storage.bytes) T(F{}(owner));
+                return ByteEstimator<T>{}(*storage.ptr());
+            });
+        }
+
+        template <std::size_t... Is>
+        void destroy_all(std::index_sequence<Is...>) noexcept
+        {
+            const std::uint64_t state = state_.load(std::memory_order_acquire);
+            (destroy_one<Is>(state), ...);
+        }
+
+        template <std::size_t I>
+        void destroy_one(std::uint64_t state) noexcept
+        {
+            using T = value_t<std::tuple_element_t<I, std::tuple<Fs...>>>;
+            if (state & ready_bit(I))
+                std::get<I>(values_).ptr()->~T();
+        }
+
+        mutable std::atomic<std::uint64_t> state_{0};
+        mutable std::tuple<detail::FieldStorage<value_t<Fs>>...> values_;
+    };
+}
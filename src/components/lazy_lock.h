@@ -0,0 +1,384 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include "cpu.h"
+#include "instrument.h"
+#include "slot_init.h"
+#include "wait_table.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <utility>
+
+namespace components
+{
+    namespace detail
+    {
+        /**
+         * @brief LazyMutex / LazyRwLock 共用的惰性存储：值直接构造在对象内部，状态为一个原子字
+         */
+        template <typename T>
+        class LazyStorage
+        {
+        public:
+            using InitFn = std::function<T()>;
+
+            explicit LazyStorage(InitFn init_fn) : init_fn_(std::move(init_fn))
+            {
+            }
+
+            LazyStorage(std::string_view name, InitFn init_fn) : LazyStorage(std::move(init_fn))
+            {
+                stats_ = LazyRegistry::instance().add(name);
+            }
+
+            ~LazyStorage()
+            {
+                if (is_initialized())
+                    ptr()->~T();
+                if (stats_)
+                    LazyRegistry::instance().remove(stats_);
+            }
+
+            LazyStorage(const LazyStorage&) = delete;
+
+            LazyStorage& operator=(const LazyStorage&) = delete;
+
+            /**
+             * @brief 确保值已经初始化，返回值的指针
+             */
+            T* ensure()
+            {
+                if (!is_initialized())
+                {
+                    init_slot_once(bytes_, stats_, state_, kClaimed, state_, kReady, [&] {
+                        new(bytes_) T(init_fn_());
+                        return ByteEstimator<T>{}(*ptr());
+                    });
+                }
+                return ptr();
+            }
+
+            [[nodiscard]] bool is_initialized() const { return state_.load(std::memory_order_acquire) & kReady; }
+
+            [[nodiscard]] const CellStats* stats() const { return stats_; }
+
+            T* ptr() noexcept { return std::launder(reinterpret_cast<T*>(bytes_)); }
+
+        private:
+            static constexpr std::uint64_t kClaimed = 1;
+            static constexpr std::uint64_t kReady = 2;
+
+            alignas(T) unsigned char bytes_[sizeof(T)];
+            std::atomic<std::uint64_t> state_{0};
+            InitFn init_fn_;
+            CellStats* stats_ = nullptr;
+        };
+    }
+
+    /**
+     * @class LazyMutex
+     * @brief 带互斥锁保护的惰性值，第一次加锁时初始化
+     * @details
+     * `Lazy<T>::get()` 返回的引用在之后的修改上没有任何同步；LazyMutex 把初始化和加锁合并为一步，
+     * 只能通过 lock() 返回的守卫访问值
+     * @tparam T 存储的数据类型
+     */
+    template <typename T>
+    class LazyMutex
+    {
+    public:
+        using InitFn = std::function<T()>;
+
+        /**
+         * @brief 持有锁期间访问值的守卫，析构时解锁
+         */
+        class Guard
+        {
+        public:
+            T& operator*() const { return *value_; }
+
+            T* operator->() const { return value_; }
+
+            T& get() const { return *value_; }
+
+        private:
+            friend class LazyMutex;
+
+            Guard(std::mutex& mtx, T* value) : lock_(mtx), value_(value)
+            {
+            }
+
+            std::unique_lock<std::mutex> lock_;
+            T* value_;
+        };
+
+        /**
+         * @brief 构造一个匿名的 LazyMutex
+         * @param init_fn 第一次加锁时用于初始化值的函数
+         */
+        explicit LazyMutex(InitFn init_fn) : storage_(std::move(init_fn))
+        {
+        }
+
+        /**
+         * @brief 构造一个具名的 LazyMutex，并将其登记到 LazyRegistry
+         */
+        LazyMutex(std::string_view name, InitFn init_fn) : storage_(name, std::move(init_fn))
+        {
+        }
+
+        /**
+         * @brief 加锁，如果值尚未初始化，则先进行初始化
+         * @details 初始化在加锁之前完成，初始化函数执行期间不持有锁
+         * @throws 初始化函数抛出的异常，之后的加锁会重新尝试初始化
+         */
+        Guard lock() { return Guard(mtx_, storage_.ensure()); }
+
+        /**
+         * @brief 检查值是否已经初始化
+         */
+        [[nodiscard]] bool is_initialized() const { return storage_.is_initialized(); }
+
+        /**
+         * @brief 获取统计信息
+         * @return 具名对象返回其统计信息，匿名对象返回 `nullptr`
+         */
+        [[nodiscard]] const CellStats* stats() const { return storage_.stats(); }
+
+    private:
+        detail::LazyStorage<T> storage_;
+        std::mutex mtx_;
+    };
+
+    /**
+     * @class LazyRwLock
+     * @brief 带读写锁保护的惰性值，读锁按 CPU 分布，第一次加锁时初始化
+     * @details
+     * 读锁是分布式读写锁（brlock）：每个 CPU 一个独占缓存行的读者计数，读者只修改本 CPU 的计数，
+     * 不同核心上的读者从不写同一条缓存行；写者设置写标志后等待所有计数归零
+     * - 读者：增加计数后检查写标志，写标志已设置时撤回计数，停在条带化等待表上直到写者解锁；
+     * - 写者：写者之间用互斥锁串行，设置写标志后等待所有读者离开；
+     * - 写者优先：写标志设置后新的读者让路，写者不会被持续到来的读者饿死
+     *
+     * 读锁的代价是一次本地原子加和一次共享只读的加载；写锁的代价与 CPU 数量成正比，适合读多写少的场景
+     * @warning 读锁不可重入：持有读锁的线程再次加读锁时，如果中间有写者在等待，会死锁
+     * @tparam T 存储的数据类型
+     */
+    template <typename T>
+    class LazyRwLock
+    {
+    public:
+        using InitFn = std::function<T()>;
+
+        /**
+         * @brief 持有读锁期间只读访问值的守卫，析构时解锁
+         */
+        class ReadGuard
+        {
+        public:
+            ReadGuard(ReadGuard&& other) noexcept
+                : lock_(std::exchange(other.lock_, nullptr)), slot_(other.slot_), value_(other.value_)
+            {
+            }
+
+            ReadGuard& operator=(ReadGuard&&) = delete;
+
+            ~ReadGuard()
+            {
+                if (lock_)
+                    lock_->unlock_shared(slot_);
+            }
+
+            const T& operator*() const { return *value_; }
+
+            const T* operator->() const { return value_; }
+
+            const T& get() const { return *value_; }
+
+        private:
+            friend class LazyRwLock;
+
+            ReadGuard(LazyRwLock* lock, std::size_t slot, const T* value) : lock_(lock), slot_(slot), value_(value)
+            {
+            }
+
+            LazyRwLock* lock_;
+            /// @brief 加锁时所在 CPU 的计数，线程之后可能被迁移，解锁时必须使用同一个计数
+            std::size_t slot_;
+            const T* value_;
+        };
+
+        /**
+         * @brief 持有写锁期间访问值的守卫，析构时解锁
+         */
+        class WriteGuard
+        {
+        public:
+            WriteGuard(WriteGuard&& other) noexcept
+                : lock_(std::exchange(other.lock_, nullptr)), value_(other.value_)
+            {
+            }
+
+            WriteGuard& operator=(WriteGuard&&) = delete;
+
+            ~WriteGuard()
+            {
+                if (lock_)
+                    lock_->unlock();
+            }
+
+            T& operator*() const { return *value_; }
+
+            T* operator->() const { return value_; }
+
+            T& get() const { return *value_; }
+
+        private:
+            friend class LazyRwLock;
+
+            WriteGuard(LazyRwLock* lock, T* value) : lock_(lock), value_(value)
+            {
+            }
+
+            LazyRwLock* lock_;
+            T* value_;
+        };
+
+        /**
+         * @brief 构造一个匿名的 LazyRwLock
+         * @param init_fn 第一次加锁时用于初始化值的函数
+         */
+        explicit LazyRwLock(InitFn init_fn);
+
+        /**
+         * @brief 构造一个具名的 LazyRwLock，并将其登记到 LazyRegistry
+         */
+        LazyRwLock(std::string_view name, InitFn init_fn);
+
+        LazyRwLock(const LazyRwLock&) = delete;
+
+        LazyRwLock& operator=(const LazyRwLock&) = delete;
+
+        /**
+         * @brief 加读锁，如果值尚未初始化，则先进行初始化
+         * @details 初始化在加锁之前完成，初始化函数执行期间不持有锁
+         * @throws 初始化函数抛出的异常，之后的加锁会重新尝试初始化
+         */
+        ReadGuard read();
+
+        /**
+         * @brief 加写锁，如果值尚未初始化，则先进行初始化
+         * @throws 初始化函数抛出的异常，之后的加锁会重新尝试初始化
+         */
+        WriteGuard write();
+
+        /**
+         * @brief 检查值是否已经初始化
+         */
+        [[nodiscard]] bool is_initialized() const { return storage_.is_initialized(); }
+
+        /**
+         * @brief 获取统计信息
+         * @return 具名对象返回其统计信息，匿名对象返回 `nullptr`
+         */
+        [[nodiscard]] const CellStats* stats() const { return storage_.stats(); }
+
+    private:
+        struct alignas(64) ReaderSlot
+        {
+            std::atomic<std::uint64_t> readers{0};
+        };
+
+        void unlock_shared(std::size_t slot);
+
+        void unlock();
+
+        [[nodiscard]] bool no_readers() const;
+
+        detail::LazyStorage<T> storage_;
+        std::size_t slot_count_;
+        std::unique_ptr<ReaderSlot[]> slots_;
+        /// @brief 写标志：读者只读取，写者加锁和解锁时各写一次
+        alignas(64) std::atomic<bool> writer_{false};
+        std::mutex writer_mtx_;
+    };
+
+    // ---------------- 实现 ----------------
+
+    template <typename T>
+    LazyRwLock<T>::LazyRwLock(InitFn init_fn)
+        : storage_(std::move(init_fn)), slot_count_(detail::cpu_count()), slots_(new ReaderSlot[slot_count_])
+    {
+    }
+
+    template <typename T>
+    LazyRwLock<T>::LazyRwLock(std::string_view name, InitFn init_fn)
+        : storage_(name, std::move(init_fn)), slot_count_(detail::cpu_count()), slots_(new ReaderSlot[slot_count_])
+    {
+    }
+
+    template <typename T>
+    typename LazyRwLock<T>::ReadGuard LazyRwLock<T>::read()
+    {
+        const T* value = storage_.ensure();
+        const std::size_t slot = detail::current_cpu();
+        auto& readers = slots_[slot].readers;
+        for (;;)
+        {
+            // 与写者构成 Dekker 式的互斥：读者先增加计数再检查写标志，写者先设置写标志再检查计数，两边都是 seq_cst
+            readers.fetch_add(1, std::memory_order_seq_cst);
+            if (!writer_.load(std::memory_order_seq_cst))
+                return ReadGuard(this, slot, value);
+            unlock_shared(slot);
+            detail::park(&writer_, [&] { return !writer_.load(std::memory_order_acquire); });
+        }
+    }
+
+    template <typename T>
+    void LazyRwLock<T>::unlock_shared(std::size_t slot)
+    {
+        slots_[slot].readers.fetch_sub(1, std::memory_order_seq_cst);
+        // 写者可能正在等待读者离开
+        if (writer_.load(std::memory_order_seq_cst))
+            detail::unpark_all(&writer_);
+    }
+
+    template <typename T>
+    typename LazyRwLock<T>::WriteGuard LazyRwLock<T>::write()
+    {
+        T* value = storage_.ensure();
+        writer_mtx_.lock();
+        writer_.store(true, std::memory_order_seq_cst);
+        if (!no_readers())
+            detail::park(&writer_, [&] { return no_readers(); });
+        return WriteGuard(this, value);
+    }
+
+    template <typename T>
+    void LazyRwLock<T>::unlock()
+    {
+        writer_.store(false, std::memory_order_seq_cst);
+        writer_mtx_.unlock();
+        detail::unpark_all(&writer_);
+    }
+
+    template <typename T>
+    bool LazyRwLock<T>::no_readers() const
+    {
+        for (std::size_t i = 0; i < slot_count_; ++i)
+        {
+            if (slots_[i].readers.load(std::memory_order_seq_cst))
+                return false;
+        }
+        return true;
+    }
+}
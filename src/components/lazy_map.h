@@ -0,0 +1,321 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include "hash.h"
+#include "once_call.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace components
+{
+    /**
+     * @class LazyMap
+     * @brief 按键记忆计算结果的并发映射，每个键的值只计算一次
+     * @details
+     * 键按哈希值分散到多个分片，每个分片是一张开放寻址（线性探测）的指针表，
+     * 槽位中同时存放哈希值，探测时不必解引用条目就能跳过不匹配的键
+     * 条目单独分配且从不移动，返回的引用在映射析构之前一直有效；
+     * 每个条目带一个 OnceCell，同一个键的并发调用者合并为一次计算，等待方式与 OnceCell 相同
+     *
+     * 查找不加锁：读取当前表并探测；只有插入新键时才持有分片锁，
+     * 因此已存在键的读取不会被其他键的插入或计算阻塞
+     * 扩容时旧表保留到映射析构，并发的读取者可以继续在旧表上完成探测
+     *
+     * 条目不会被删除；计算抛出异常的键保留一个未初始化的条目，下一次调用会重新计算
+     * @tparam K 键类型
+     * @tparam V 值类型
+     * @tparam Hash 键的哈希函数
+     * @tparam KeyEqual 键的相等比较
+     */
+    template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+    class LazyMap
+    {
+    public:
+        /**
+         * @brief 构造一个空映射
+         * @param shard_count 分片数量，向上取整到 2 的幂
+         */
+        explicit LazyMap(std::size_t shard_count = 16);
+
+        /**
+         * @brief 析构所有条目
+         */
+        ~LazyMap();
+
+        LazyMap(const LazyMap&) = delete;
+
+        LazyMap& operator=(const LazyMap&) = delete;
+
+        /**
+         * @brief 获取键对应的值，如果尚未计算，则先进行计算
+         * @details 同一个键的并发调用者只有一个执行 fn，其余的等待并共享结果
+         * @tparam Fn 签名为 `V(const K&)` 或 `V()`
+         * @param key 键
+         * @param fn 计算函数，抛出异常时异常传播给调用者，之后的调用会重新计算
+         * @return 值的引用，在映射析构之前一直有效
+         * @throws LazyInitError 检查模式下发现重入或初始化死锁时抛出
+         */
+        template <typename Fn>
+        V& get_or_compute(const K& key, Fn&& fn);
+
+        /**
+         * @brief 查找已计算的值，不会触发计算，也不会加锁
+         * @return 已计算时返回值指针，否则返回 nullptr
+         */
+        [[nodiscard]] V* find(const K& key);
+
+        /**
+         * @brief 只读版本的 find
+         */
+        [[nodiscard]] const V* find(const K& key) const;
+
+        /**
+         * @brief 检查键的值是否已计算
+         */
+        [[nodiscard]] bool contains(const K& key) const { return find(key) != nullptr; }
+
+        /**
+         * @brief 条目数量
+         * @details 包括正在计算或上次计算失败的键
+         */
+        [[nodiscard]] std::size_t size() const;
+
+        /**
+         * @brief 访问所有已计算的键值，不会触发计算
+         * @details 遍历期间新插入的键可能被访问也可能不被访问
+         * @param fn 签名为 `void(const K&, V&)`
+         */
+        template <typename Fn>
+        void for_each(Fn&& fn);
+
+    private:
+        struct Entry
+        {
+            Entry(std::uint64_t hash, const K& key) : hash(hash), key(key)
+            {
+            }
+
+            const std::uint64_t hash;
+            const K key;
+            OnceCell<V> cell;
+        };
+
+        struct Slot
+        {
+            /// @brief 在 entry 发布之前写入，之后不再改变
+            std::atomic<std::uint64_t> hash{0};
+            std::atomic<Entry*> entry{nullptr};
+        };
+
+        struct Table
+        {
+            explicit Table(std::size_t capacity) : mask(capacity - 1), slots(new Slot[capacity])
+            {
+            }
+
+            const std::size_t mask;
+            std::unique_ptr<Slot[]> slots;
+        };
+
+        struct alignas(64) Shard
+        {
+            /// @brief 插入和扩容时持有，读取不需要
+            std::mutex mtx;
+            std::atomic<Table*> table{nullptr};
+            std::atomic<std::size_t> count{0};
+            /// @brief 当前表和所有旧表，映射析构时释放
+            std::vector<std::unique_ptr<Table>> tables;
+        };
+
+        static constexpr std::size_t kInitialCapacity = 16;
+
+        std::uint64_t hash_of(const K& key) const
+        {
+            return detail::mix_hash(static_cast<std::uint64_t>(Hash{}(key)));
+        }
+
+        Shard& shard_of(std::uint64_t hash) const { return shards_[(hash >> 32) & shard_mask_]; }
+
+        /**
+         * @brief 在表中线性探测键
+         * @return 找到时返回条目，遇到空槽位时返回 nullptr
+         */
+        static Entry* probe(const Table& table, std::uint64_t hash, const K& key);
+
+        Entry* find_entry(const K& key) const;
+
+        /**
+         * @brief 查找或插入条目，持有分片锁
+         */
+        Entry* insert_entry(std::uint64_t hash, const K& key);
+
+        /**
+         * @brief 把条目放入表中的空槽位，调用方持有分片锁
+         */
+        static void place(Table& table, Entry* entry);
+
+        std::size_t shard_mask_;
+        std::unique_ptr<Shard[]> shards_;
+    };
+
+    // ---------------- 实现 ----------------
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    LazyMap<K, V, Hash, KeyEqual>::LazyMap(std::size_t shard_count)
+    {
+        std::size_t n = 1;
+        while (n < shard_count)
+            n <<= 1;
+        shard_mask_ = n - 1;
+        shards_.reset(new Shard[n]);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto& shard = shards_[i];
+            shard.tables.push_back(std::make_unique<Table>(kInitialCapacity));
+            shard.table.store(shard.tables.back().get(), std::memory_order_relaxed);
+        }
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    LazyMap<K, V, Hash, KeyEqual>::~LazyMap()
+    {
+        for (std::size_t i = 0; i <= shard_mask_; ++i)
+        {
+            const Table& table = *shards_[i].table.load(std::memory_order_relaxed);
+            for (std::size_t s = 0; s <= table.mask; ++s)
+                delete table.slots[s].entry.load(std::memory_order_relaxed);
+        }
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    template <typename Fn>
+    V& LazyMap<K, V, Hash, KeyEqual>::get_or_compute(const K& key, Fn&& fn)
+    {
+        const std::uint64_t hash = hash_of(key);
+        Entry* entry = probe(*shard_of(hash).table.load(std::memory_order_acquire), hash, key);
+        if (!entry)
+            entry = insert_entry(hash, key);
+
+        return entry->cell.get_or_init([&]() -> V {
+            if constexpr (std::is_invocable_v<Fn&, const K&>)
+                return fn(entry->key);
+            else
+                return fn();
+        });
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    V* LazyMap<K, V, Hash, KeyEqual>::find(const K& key)
+    {
+        Entry* entry = find_entry(key);
+        return entry ? entry->cell.get() : nullptr;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    const V* LazyMap<K, V, Hash, KeyEqual>::find(const K& key) const
+    {
+        const Entry* entry = find_entry(key);
+        return entry ? entry->cell.try_get() : nullptr;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    std::size_t LazyMap<K, V, Hash, KeyEqual>::size() const
+    {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i <= shard_mask_; ++i)
+            n += shards_[i].count.load(std::memory_order_relaxed);
+        return n;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    template <typename Fn>
+    void LazyMap<K, V, Hash, KeyEqual>::for_each(Fn&& fn)
+    {
+        for (std::size_t i = 0; i <= shard_mask_; ++i)
+        {
+            const Table& table = *shards_[i].table.load(std::memory_order_acquire);
+            for (std::size_t s = 0; s <= table.mask; ++s)
+            {
+                Entry* entry = table.slots[s].entry.load(std::memory_order_acquire);
+                if (!entry)
+                    continue;
+                if (V* value = entry->cell.get())
+                    fn(entry->key, *value);
+            }
+        }
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    typename LazyMap<K, V, Hash, KeyEqual>::Entry*
+    LazyMap<K, V, Hash, KeyEqual>::probe(const Table& table, std::uint64_t hash, const K& key)
+    {
+        for (std::size_t i = hash & table.mask;; i = (i + 1) & table.mask)
+        {
+            const Slot& slot = table.slots[i];
+            Entry* entry = slot.entry.load(std::memory_order_acquire);
+            if (!entry)
+                return nullptr;
+            if (slot.hash.load(std::memory_order_relaxed) == hash && KeyEqual{}(entry->key, key))
+                return entry;
+        }
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    typename LazyMap<K, V, Hash, KeyEqual>::Entry* LazyMap<K, V, Hash, KeyEqual>::find_entry(const K& key) const
+    {
+        const std::uint64_t hash = hash_of(key);
+        return probe(*shard_of(hash).table.load(std::memory_order_acquire), hash, key);
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    typename LazyMap<K, V, Hash, KeyEqual>::Entry*
+    LazyMap<K, V, Hash, KeyEqual>::insert_entry(std::uint64_t hash, const K& key)
+    {
+        Shard& shard = shard_of(hash);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        Table* table = shard.table.load(std::memory_order_relaxed);
+        // 其他线程可能在我们加锁之前插入了同一个键
+        if (Entry* existing = probe(*table, hash, key))
+            return existing;
+
+        // 负载因子保持在 1/2 以下，探测序列很短，也保证表中始终有空槽位作为探测的终点
+        const std::size_t count = shard.count.load(std::memory_order_relaxed);
+        if ((count + 1) * 2 > table->mask + 1)
+        {
+            auto grown = std::make_unique<Table>((table->mask + 1) * 2);
+            for (std::size_t s = 0; s <= table->mask; ++s)
+            {
+                if (Entry* e = table->slots[s].entry.load(std::memory_order_relaxed))
+                    place(*grown, e);
+            }
+            table = grown.get();
+            shard.tables.push_back(std::move(grown));
+            shard.table.store(table, std::memory_order_release);
+        }
+
+        auto entry = std::make_unique<Entry>(hash, key);
+        place(*table, entry.get());
+        shard.count.store(count + 1, std::memory_order_relaxed);
+        return entry.release();
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    void LazyMap<K, V, Hash, KeyEqual>::place(Table& table, Entry* entry)
+    {
+        std::size_t i = entry->hash & table.mask;
+        while (table.slots[i].entry.load(std::memory_order_relaxed))
+            i = (i + 1) & table.mask;
+        table.slots[i].hash.store(entry->hash, std::memory_order_relaxed);
+        table.slots[i].entry.store(entry, std::memory_order_release);
+    }
+}
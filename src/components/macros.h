@@ -5,11 +5,13 @@
 #pragma once
 
 #include "lazy.h"
+#include "recycling_lazy.h"
 
 /**
  * @brief 定义一个静态的延迟初始化对象
  * @details
  * 这个宏创建了一个静态的 `components::Lazy` 实例，它将在首次访问时通过执行 `expr` 来初始化
+ * 实例不登记到 `components::LazyRegistry`，构造时没有堆分配也不获取登记表的锁，需要观察时使用 `LAZY_STATIC_NAMED`
  * @param type 对象的类型
  * @param name 对象的名称
  * @param expr 用于初始化对象的表达式
@@ -17,11 +19,19 @@
 #define LAZY_STATIC(type, name, expr) \
 static components::Lazy<type> name([] { return expr; })
 
+/**
+ * @brief 与 `LAZY_STATIC` 相同，实例以变量名登记到 `components::LazyRegistry`，可以通过指标导出观察
+ * @details 登记发生在静态初始化阶段，每个实例付出一次堆分配和一次登记表加锁
+ */
+#define LAZY_STATIC_NAMED(type, name, expr) \
+static components::Lazy<type> name(#name, [] { return expr; })
+
 /**
  * @brief 定义一个线程局部的延迟初始化对象
  * @details
  * 这个宏创建了一个线程局部的 `components::Lazy` 实例，每个线程都会有自己的独立实例，
  * 并在首次访问时通过执行 `expr` 来初始化
+ * 线程局部实例不登记到 `components::LazyRegistry`，避免每个线程产生一条重复记录
  * @param type 对象的类型
  * @param name 对象的名称
  * @param expr 用于初始化对象的表达式
@@ -29,12 +39,42 @@ static components::Lazy<type> name([] { return expr; })
 #define THREAD_LOCAL_LAZY(type, name, expr) \
 static thread_local components::Lazy<type> name([] { return expr; })
 
+/**
+ * @brief 定义一个线程局部的延迟初始化对象，线程退出时把值归还到有容量上限的对象池，供之后的线程复用
+ * @details
+ * 与 `THREAD_LOCAL_LAZY` 相同，每个线程有自己的独立实例；新线程第一次访问时优先复用已退出线程留下的值，
+ * 池为空时才执行 `expr`；池满时退出线程的值直接销毁
+ * 对象池以 `name##_pool` 命名，故意泄漏，分离的线程在静态析构之后退出时仍可安全归还
+ * @param type 对象的类型
+ * @param name 对象的名称
+ * @param expr 用于初始化对象的表达式
+ * @param capacity 对象池最多保存的对象数量
+ */
+#define THREAD_LOCAL_LAZY_RECYCLED(type, name, expr, capacity) \
+static components::RecyclePool<type>& name##_pool = *new components::RecyclePool<type>(capacity); \
+static thread_local components::RecyclingLazy<type> name(name##_pool, [] { return expr; })
+
+/**
+ * @brief 与 `THREAD_LOCAL_LAZY_RECYCLED` 相同，值归还到池之前由退出的线程调用 `reset`
+ * @param reset 签名为 `void(type&)` 的重置函数
+ */
+#define THREAD_LOCAL_LAZY_RECYCLED_RESET(type, name, expr, capacity, reset) \
+static components::RecyclePool<type>& name##_pool = *new components::RecyclePool<type>(capacity, reset); \
+static thread_local components::RecyclingLazy<type> name(name##_pool, [] { return expr; })
+
 /**
  * @brief 定义一个静态的延迟执行的 void 操作
  * @details
  * 这个宏创建了一个 `components::Lazy<void>` 实例，它将在首次访问时执行 `expr`
+ * 实例不登记到 `components::LazyRegistry`，需要观察时使用 `LAZY_STATIC_VOID_NAMED`
  * @param name 操作的名称
  * @param expr 要执行的表达式
  */
 #define LAZY_STATIC_VOID(name, expr) \
 static components::Lazy<void> name([] { expr; })
+
+/**
+ * @brief 与 `LAZY_STATIC_VOID` 相同，实例以变量名登记到 `components::LazyRegistry`
+ */
+#define LAZY_STATIC_VOID_NAMED(name, expr) \
+static components::Lazy<void> name(#name, [] { expr; })
@@ -0,0 +1,680 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include "hash.h"
+#include "once_call.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace components
+{
+    namespace detail
+    {
+        /**
+         * @brief 无锁读取者的延迟回收：摘除的对象在摘除之前进入的读取者全部离开后才释放
+         * @details
+         * 两个读取计数器轮换使用（与 SRCU 相同的思路）：
+         * 回收时切换计数器，新的读取者进入另一个计数器，旧计数器只会减少，不会因持续的读取而永远不归零
+         * 读取者增加计数之后重新读取纪元，纪元已经变化时撤回计数并在新的计数器上重试：
+         * 否则在读取纪元和增加计数之间被抢占的读取者，可能落在回收方已经检查过、认为空闲的计数器上
+         * retire 和 reclaim 由写入方在持有分片锁时调用；读取者通常只做一次原子加减
+         */
+        class ReadReclaimer
+        {
+        public:
+            /**
+             * @brief 读取区间，期间读到的已摘除对象不会被释放
+             */
+            class Guard
+            {
+            public:
+                explicit Guard(ReadReclaimer& r) : counter_(r.enter())
+                {
+                }
+
+                ~Guard() { counter_.fetch_sub(1, std::memory_order_release); }
+
+                Guard(const Guard&) = delete;
+
+                Guard& operator=(const Guard&) = delete;
+
+            private:
+                std::atomic<std::int64_t>& counter_;
+            };
+
+            /**
+             * @brief 登记一个已经从所有共享结构中摘除的对象
+             */
+            void retire(std::shared_ptr<void> object) { pending_.push_back(std::move(object)); }
+
+            /**
+             * @brief 释放已经没有读取者能看到的对象
+             */
+            void reclaim()
+            {
+                if (waiting_.empty() && pending_.empty())
+                    return;
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (!waiting_.empty())
+                {
+                    if (active_[waiting_epoch_ & 1].load(std::memory_order_seq_cst) != 0)
+                        return;
+                    waiting_.clear();
+                }
+                if (pending_.empty())
+                    return;
+                // 切换之后进入的读取者在另一个计数器上，而且看不到 pending_ 中已经摘除的对象
+                waiting_epoch_ = epoch_.fetch_add(1, std::memory_order_seq_cst);
+                waiting_.swap(pending_);
+                if (active_[waiting_epoch_ & 1].load(std::memory_order_seq_cst) == 0)
+                    waiting_.clear();
+            }
+
+        private:
+            /**
+             * @brief 在当前纪元的计数器上登记一个读取者
+             * @details
+             * 增加计数与回收方的切换都是 seq_cst：重新读到同一个纪元，说明增加计数发生在下一次切换之前，
+             * 切换之后对这个计数器的检查一定能看到它
+             */
+            std::atomic<std::int64_t>& enter() noexcept
+            {
+                unsigned epoch = epoch_.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    auto& counter = active_[epoch & 1];
+                    counter.fetch_add(1, std::memory_order_seq_cst);
+                    const unsigned now = epoch_.load(std::memory_order_seq_cst);
+                    if (now == epoch)
+                        return counter;
+                    counter.fetch_sub(1, std::memory_order_release);
+                    epoch = now;
+                }
+            }
+
+            std::atomic<unsigned> epoch_{0};
+            std::atomic<std::int64_t> active_[2] = {};
+            unsigned waiting_epoch_ = 0;
+            /// @brief 上次切换之前摘除的对象，等待旧计数器归零
+            std::vector<std::shared_ptr<void>> waiting_;
+            /// @brief 上次切换之后摘除的对象
+            std::vector<std::shared_ptr<void>> pending_;
+        };
+    }
+
+    /**
+     * @class MemoCache
+     * @brief 有容量上限的并发记忆缓存，使用 S3-FIFO 淘汰
+     * @details
+     * 键按哈希值分散到多个分片，每个分片独立管理自己那份容量：
+     * - 命中不加锁：读取者在读取区间内探测开放寻址表，复制值并递增条目的访问频率（最大为 3）；
+     * - 未命中按键合并：第一个调用者插入一个待计算的条目，同一个键的其他调用者在条目的 OnceCell 上等待，
+     *   计算抛出异常时异常传播给执行者，条目被移除，已经在等待的调用者按 OnceCell 的语义接手重试；
+     * - 淘汰使用 S3-FIFO：新条目进入小队列（约占容量的 10%），小队列出队时访问过不止一次的条目晋升到主队列，
+     *   其余的被淘汰并把哈希值记入幽灵队列；幽灵队列中的键再次插入时直接进入主队列；
+     *   主队列出队时频率不为零的条目减一后重新入队。一次性扫描只会冲刷小队列，不会挤掉主队列中的热点
+     *
+     * 被淘汰的条目在所有可能看到它的读取者离开之后才释放，见 detail::ReadReclaimer
+     * @tparam K 键类型
+     * @tparam V 值类型，必须可复制，命中时返回一份副本；较大的值可以使用 `std::shared_ptr<const T>`
+     * @tparam Hash 键的哈希函数
+     * @tparam KeyEqual 键的相等比较
+     */
+    template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+    class MemoCache
+    {
+    public:
+        /// @brief 条目的权重，默认每个条目为 1，此时容量就是条目数量
+        using Weigher = std::function<std::size_t(const K&, const V&)>;
+
+        /// @brief 统计信息快照
+        struct Stats
+        {
+            std::uint64_t hits = 0;
+            std::uint64_t misses = 0;
+            std::uint64_t evictions = 0;
+            /// @brief 缓存中已计算的条目数量
+            std::size_t size = 0;
+            /// @brief 缓存中已计算条目的总权重
+            std::size_t weight = 0;
+        };
+
+        /**
+         * @brief 构造一个空缓存
+         * @param capacity 总容量（权重之和），平均分配到各个分片
+         * @param shard_count 分片数量，向上取整到 2 的幂，并且不超过容量
+         * @param weigher 条目的权重函数，为空时每个条目的权重为 1
+         */
+        explicit MemoCache(std::size_t capacity, std::size_t shard_count = 16, Weigher weigher = {});
+
+        MemoCache(const MemoCache&) = delete;
+
+        MemoCache& operator=(const MemoCache&) = delete;
+
+        /**
+         * @brief 获取键对应的值，未命中时计算并放入缓存
+         * @details 同一个键的并发调用者只有一个执行 fn，其余的等待并共享结果
+         * @tparam Fn 签名为 `V(const K&)` 或 `V()`
+         * @return 值的副本
+         * @throws fn 抛出的异常；LazyInitError 检查模式下发现重入或初始化死锁时抛出
+         */
+        template <typename Fn>
+        V get_or_compute(const K& key, Fn&& fn);
+
+        /**
+         * @brief 查找已缓存的值，不会触发计算，也不会加锁
+         * @details 找到时计为一次命中并提升条目的访问频率，找不到时不计入未命中
+         */
+        [[nodiscard]] std::optional<V> get(const K& key);
+
+        /**
+         * @brief 从缓存中移除键
+         * @return 键存在时返回 true
+         */
+        bool erase(const K& key);
+
+        /**
+         * @brief 总容量
+         */
+        [[nodiscard]] std::size_t capacity() const { return shard_capacity_ * (shard_mask_ + 1); }
+
+        /**
+         * @brief 获取统计信息快照
+         */
+        [[nodiscard]] Stats stats() const;
+
+    private:
+        struct Entry : std::enable_shared_from_this<Entry>
+        {
+            Entry(std::uint64_t hash, const K& key) : hash(hash), key(key)
+            {
+            }
+
+            const std::uint64_t hash;
+            const K key;
+            OnceCell<V> cell;
+            /// @brief 命中次数，饱和于 3，读取者无锁递增
+            std::atomic<std::uint8_t> freq{0};
+            // 以下字段只在持有分片锁时访问
+            std::size_t weight = 0;
+            /// @brief 值已计算且权重已计入分片
+            bool weighed = false;
+            bool in_main = false;
+            /// @brief 已从索引中摘除，只等待从队列中出队
+            bool removed = false;
+        };
+
+        struct Slot
+        {
+            std::atomic<std::uint64_t> hash{0};
+            std::atomic<Entry*> entry{nullptr};
+        };
+
+        struct Table
+        {
+            explicit Table(std::size_t capacity) : mask(capacity - 1), slots(new Slot[capacity])
+            {
+            }
+
+            const std::size_t mask;
+            std::unique_ptr<Slot[]> slots;
+        };
+
+        struct alignas(64) Shard
+        {
+            detail::ReadReclaimer reclaimer;
+            std::atomic<Table*> table{nullptr};
+            std::atomic<std::uint64_t> hits{0};
+            std::atomic<std::uint64_t> misses{0};
+            std::atomic<std::uint64_t> evictions{0};
+
+            // 以下字段只在持有 mtx 时访问
+            std::mutex mtx;
+            std::unique_ptr<Table> owned_table;
+            /// @brief 索引中的条目数量和墓碑数量
+            std::size_t live = 0;
+            std::size_t tombstones = 0;
+            std::deque<std::shared_ptr<Entry>> small;
+            std::deque<std::shared_ptr<Entry>> main;
+            std::size_t small_weight = 0;
+            std::size_t main_weight = 0;
+            std::size_t resident = 0;
+            std::deque<std::uint64_t> ghost;
+            std::unordered_map<std::uint64_t, std::uint32_t> ghost_count;
+        };
+
+        static constexpr std::size_t kInitialCapacity = 16;
+        static constexpr std::uint8_t kMaxFreq = 3;
+
+        static Entry* tombstone() { return reinterpret_cast<Entry*>(alignof(Entry)); }
+
+        std::uint64_t hash_of(const K& key) const
+        {
+            return detail::mix_hash(static_cast<std::uint64_t>(Hash{}(key)));
+        }
+
+        Shard& shard_of(std::uint64_t hash) const { return shards_[(hash >> 32) & shard_mask_]; }
+
+        static Entry* probe(const Table& table, std::uint64_t hash, const K& key);
+
+        static void touch(Entry& e);
+
+        /**
+         * @brief 查找或插入待计算的条目，持有分片锁
+         */
+        std::shared_ptr<Entry> insert_pending(Shard& shard, std::uint64_t hash, const K& key);
+
+        /**
+         * @brief 计算完成后把条目计入分片并按需淘汰
+         */
+        void admit(Shard& shard, Entry& e, const V& value);
+
+        /**
+         * @brief 计算失败后从索引中移除条目（已被其他调用者重新计算成功的除外）
+         */
+        void abandon(Shard& shard, Entry& e);
+
+        // 以下函数调用方持有分片锁
+        void unlink(Shard& shard, Entry& e);
+
+        void retire(Shard& shard, std::shared_ptr<Entry> e);
+
+        void evict(Shard& shard);
+
+        bool evict_small(Shard& shard);
+
+        bool evict_main(Shard& shard);
+
+        void remember_ghost(Shard& shard, std::uint64_t hash);
+
+        bool take_ghost(Shard& shard, std::uint64_t hash);
+
+        static void place(Table& table, Entry* entry);
+
+        void rebuild(Shard& shard, std::size_t capacity);
+
+        std::size_t shard_mask_;
+        std::size_t shard_capacity_;
+        Weigher weigher_;
+        std::unique_ptr<Shard[]> shards_;
+    };
+
+    // ---------------- 实现 ----------------
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    MemoCache<K, V, Hash, KeyEqual>::MemoCache(std::size_t capacity, std::size_t shard_count, Weigher weigher)
+        : weigher_(std::move(weigher))
+    {
+        capacity = std::max<std::size_t>(capacity, 1);
+        std::size_t n = 1;
+        while (n < shard_count && n * 2 <= capacity)
+            n <<= 1;
+        shard_mask_ = n - 1;
+        shard_capacity_ = (capacity + n - 1) / n;
+        shards_.reset(new Shard[n]);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            shards_[i].owned_table = std::make_unique<Table>(kInitialCapacity);
+            shards_[i].table.store(shards_[i].owned_table.get(), std::memory_order_relaxed);
+        }
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    template <typename Fn>
+    V MemoCache<K, V, Hash, KeyEqual>::get_or_compute(const K& key, Fn&& fn)
+    {
+        const std::uint64_t hash = hash_of(key);
+        Shard& shard = shard_of(hash);
+        std::shared_ptr<Entry> entry;
+        {
+            detail::ReadReclaimer::Guard guard(shard.reclaimer);
+            if (Entry* e = probe(*shard.table.load(std::memory_order_acquire), hash, key))
+            {
+                if (const V* value = e->cell.try_get())
+                {
+                    touch(*e);
+                    shard.hits.fetch_add(1, std::memory_order_relaxed);
+                    return *value;
+                }
+                // 读取区间内条目不会被释放，分片或回收器仍持有它的所有权
+                entry = e->shared_from_this();
+            }
+        }
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        if (!entry)
+            entry = insert_pending(shard, hash, key);
+
+        bool computed = false;
+        try
+        {
+            const V& value = entry->cell.get_or_init([&]() -> V {
+                computed = true;
+                if constexpr (std::is_invocable_v<Fn&, const K&>)
+                    return fn(entry->key);
+                else
+                    return fn();
+            });
+            if (computed)
+                admit(shard, *entry, value);
+            return value;
+        }
+        catch (...)
+        {
+            if (computed)
+                abandon(shard, *entry);
+            throw;
+        }
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    std::optional<V> MemoCache<K, V, Hash, KeyEqual>::get(const K& key)
+    {
+        const std::uint64_t hash = hash_of(key);
+        Shard& shard = shard_of(hash);
+        detail::ReadReclaimer::Guard guard(shard.reclaimer);
+        if (Entry* e = probe(*shard.table.load(std::memory_order_acquire), hash, key))
+        {
+            if (const V* value = e->cell.try_get())
+            {
+                touch(*e);
+                shard.hits.fetch_add(1, std::memory_order_relaxed);
+                return *value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    bool MemoCache<K, V, Hash, KeyEqual>::erase(const K& key)
+    {
+        const std::uint64_t hash = hash_of(key);
+        Shard& shard = shard_of(hash);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        Entry* e = probe(*shard.table.load(std::memory_order_relaxed), hash, key);
+        if (!e)
+            return false;
+        unlink(shard, *e);
+        shard.reclaimer.reclaim();
+        return true;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    typename MemoCache<K, V, Hash, KeyEqual>::Stats MemoCache<K, V, Hash, KeyEqual>::stats() const
+    {
+        Stats s;
+        for (std::size_t i = 0; i <= shard_mask_; ++i)
+        {
+            Shard& shard = shards_[i];
+            s.hits += shard.hits.load(std::memory_order_relaxed);
+            s.misses += shard.misses.load(std::memory_order_relaxed);
+            s.evictions += shard.evictions.load(std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            s.size += shard.resident;
+            s.weight += shard.small_weight + shard.main_weight;
+        }
+        return s;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    typename MemoCache<K, V, Hash, KeyEqual>::Entry*
+    MemoCache<K, V, Hash, KeyEqual>::probe(const Table& table, std::uint64_t hash, const K& key)
+    {
+        for (std::size_t i = hash & table.mask;; i = (i + 1) & table.mask)
+        {
+            const Slot& slot = table.slots[i];
+            Entry* entry = slot.entry.load(std::memory_order_acquire);
+            if (!entry)
+                return nullptr;
+            if (entry != tombstone() && slot.hash.load(std::memory_order_relaxed) == hash &&
+                KeyEqual{}(entry->key, key))
+                return entry;
+        }
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    void MemoCache<K, V, Hash, KeyEqual>::touch(Entry& e)
+    {
+        // 已饱和时只读不写，热点条目的缓存行不会在核之间来回传递
+        std::uint8_t f = e.freq.load(std::memory_order_relaxed);
+        if (f < kMaxFreq)
+            e.freq.store(static_cast<std::uint8_t>(f + 1), std::memory_order_relaxed);
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    std::shared_ptr<typename MemoCache<K, V, Hash, KeyEqual>::Entry>
+    MemoCache<K, V, Hash, KeyEqual>::insert_pending(Shard& shard, std::uint64_t hash, const K& key)
+    {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        Table* table = shard.table.load(std::memory_order_relaxed);
+        if (Entry* existing = probe(*table, hash, key))
+            return existing->shared_from_this();
+
+        // 墓碑也会拉长探测序列，一并计入负载因子；重建时按存活条目数量决定新容量
+        if ((shard.live + shard.tombstones + 1) * 2 > table->mask + 1)
+        {
+            std::size_t capacity = kInitialCapacity;
+            while (capacity < (shard.live + 1) * 4)
+                capacity <<= 1;
+            rebuild(shard, capacity);
+            table = shard.table.load(std::memory_order_relaxed);
+        }
+
+        auto entry = std::make_shared<Entry>(hash, key);
+        place(*table, entry.get());
+        shard.live++;
+        if (take_ghost(shard, hash))
+        {
+            entry->in_main = true;
+            shard.main.push_back(entry);
+        }
+        else
+            shard.small.push_back(entry);
+        return entry;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    void MemoCache<K, V, Hash, KeyEqual>::admit(Shard& shard, Entry& e, const V& value)
+    {
+        const std::size_t weight = weigher_ ? weigher_(e.key, value) : 1;
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        // 计算期间条目可能已被 erase，此时结果只返回给调用者，不进入缓存
+        if (!e.removed && !e.weighed)
+        {
+            e.weight = weight;
+            e.weighed = true;
+            (e.in_main ? shard.main_weight : shard.small_weight) += weight;
+            shard.resident++;
+            evict(shard);
+        }
+        shard.reclaimer.reclaim();
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    void MemoCache<K, V, Hash, KeyEqual>::abandon(Shard& shard, Entry& e)
+    {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        if (!e.removed && !e.cell.is_initialized())
+            unlink(shard, e);
+        shard.reclaimer.reclaim();
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    void MemoCache<K, V, Hash, KeyEqual>::unlink(Shard& shard, Entry& e)
+    {
+        Table& table = *shard.table.load(std::memory_order_relaxed);
+        for (std::size_t i = e.hash & table.mask;; i = (i + 1) & table.mask)
+        {
+            if (table.slots[i].entry.load(std::memory_order_relaxed) == &e)
+            {
+                table.slots[i].entry.store(tombstone(), std::memory_order_release);
+                break;
+            }
+        }
+        shard.live--;
+        shard.tombstones++;
+        e.removed = true;
+        if (e.weighed)
+        {
+            (e.in_main ? shard.main_weight : shard.small_weight) -= e.weight;
+            shard.resident--;
+        }
+        // 条目仍留在队列中，出队时再交给回收器
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    void MemoCache<K, V, Hash, KeyEqual>::retire(Shard& shard, std::shared_ptr<Entry> e)
+    {
+        shard.reclaimer.retire(std::move(e));
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    void MemoCache<K, V, Hash, KeyEqual>::evict(Shard& shard)
+    {
+        const std::size_t small_target = std::max<std::size_t>(shard_capacity_ / 10, 1);
+        while (shard.small_weight + shard.main_weight > shard_capacity_)
+        {
+            const bool from_small = shard.small_weight > small_target || shard.main_weight == 0;
+            if (!(from_small ? evict_small(shard) : evict_main(shard)))
+                break;
+        }
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    bool MemoCache<K, V, Hash, KeyEqual>::evict_small(Shard& shard)
+    {
+        // 待计算的条目还没有权重，轮转到队尾；计数保证只有待计算条目时循环也会结束
+        for (std::size_t pending = 0; !shard.small.empty() && pending < shard.small.size();)
+        {
+            std::shared_ptr<Entry> e = std::move(shard.small.front());
+            shard.small.pop_front();
+            if (e->removed)
+            {
+                retire(shard, std::move(e));
+                continue;
+            }
+            if (!e->weighed)
+            {
+                shard.small.push_back(std::move(e));
+                pending++;
+                continue;
+            }
+            if (e->freq.load(std::memory_order_relaxed) > 1)
+            {
+                e->freq.store(0, std::memory_order_relaxed);
+                e->in_main = true;
+                shard.small_weight -= e->weight;
+                shard.main_weight += e->weight;
+                shard.main.push_back(std::move(e));
+                continue;
+            }
+            unlink(shard, *e);
+            remember_ghost(shard, e->hash);
+            retire(shard, std::move(e));
+            shard.evictions.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    bool MemoCache<K, V, Hash, KeyEqual>::evict_main(Shard& shard)
+    {
+        for (std::size_t pending = 0; !shard.main.empty() && pending < shard.main.size();)
+        {
+            std::shared_ptr<Entry> e = std::move(shard.main.front());
+            shard.main.pop_front();
+            if (e->removed)
+            {
+                retire(shard, std::move(e));
+                continue;
+            }
+            if (!e->weighed)
+            {
+                shard.main.push_back(std::move(e));
+                pending++;
+                continue;
+            }
+            const std::uint8_t f = e->freq.load(std::memory_order_relaxed);
+            if (f > 0)
+            {
+                e->freq.store(static_cast<std::uint8_t>(f - 1), std::memory_order_relaxed);
+                shard.main.push_back(std::move(e));
+                continue;
+            }
+            unlink(shard, *e);
+            retire(shard, std::move(e));
+            shard.evictions.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    void MemoCache<K, V, Hash, KeyEqual>::remember_ghost(Shard& shard, std::uint64_t hash)
+    {
+        shard.ghost.push_back(hash);
+        shard.ghost_count[hash]++;
+        // 幽灵队列的长度与缓存中的条目数量相当
+        const std::size_t limit = std::max<std::size_t>(shard.resident, kInitialCapacity);
+        while (shard.ghost.size() > limit)
+        {
+            auto it = shard.ghost_count.find(shard.ghost.front());
+            if (it != shard.ghost_count.end() && --it->second == 0)
+                shard.ghost_count.erase(it);
+            shard.ghost.pop_front();
+        }
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    bool MemoCache<K, V, Hash, KeyEqual>::take_ghost(Shard& shard, std::uint64_t hash)
+    {
+        // 只移除计数，队列中的旧记录按先进先出自然老化
+        auto it = shard.ghost_count.find(hash);
+        if (it == shard.ghost_count.end())
+            return false;
+        if (--it->second == 0)
+            shard.ghost_count.erase(it);
+        return true;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    void MemoCache<K, V, Hash, KeyEqual>::place(Table& table, Entry* entry)
+    {
+        std::size_t i = entry->hash & table.mask;
+        while (table.slots[i].entry.load(std::memory_order_relaxed))
+            i = (i + 1) & table.mask;
+        table.slots[i].hash.store(entry->hash, std::memory_order_relaxed);
+        table.slots[i].entry.store(entry, std::memory_order_release);
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    void MemoCache<K, V, Hash, KeyEqual>::rebuild(Shard& shard, std::size_t capacity)
+    {
+        auto fresh = std::make_unique<Table>(capacity);
+        const Table& old = *shard.owned_table;
+        for (std::size_t s = 0; s <= old.mask; ++s)
+        {
+            Entry* e = old.slots[s].entry.load(std::memory_order_relaxed);
+            if (e && e != tombstone())
+                place(*fresh, e);
+        }
+        shard.table.store(fresh.get(), std::memory_order_release);
+        shard.reclaimer.retire(std::shared_ptr<Table>(std::move(shard.owned_table)));
+        shard.owned_table = std::move(fresh);
+        shard.tombstones = 0;
+    }
+}
@@ -0,0 +1,190 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#include "metrics.h"
+#include "registry.h"
+
+#include <cstdint>
+#include <map>
+#include <sstream>
+
+namespace components
+{
+    namespace
+    {
+        /// @brief 同名单元合并后的统计信息
+        struct Aggregate
+        {
+            std::uint64_t cells = 0;
+            std::uint64_t initialized = 0;
+            std::uint64_t init_count = 0;
+            std::uint64_t failure_count = 0;
+            std::uint64_t wait_count = 0;
+            std::uint64_t reset_count = 0;
+            std::uint64_t reload_count = 0;
+            std::uint64_t init_ns_sum = 0;
+            std::uint64_t init_ns_max = 0;
+            std::uint64_t init_sampled_count = 0;
+            std::uint64_t estimated_bytes = 0;
+            std::uint64_t alloc_count = 0;
+            std::uint64_t alloc_bytes = 0;
+            std::int64_t live_alloc_bytes = 0;
+        };
+
+        /**
+         * @brief 按 Prometheus 文本格式转义标签值
+         */
+        std::string escape_label(const std::string& value)
+        {
+            std::string out;
+            out.reserve(value.size());
+            for (char c : value)
+            {
+                switch (c)
+                {
+                case '\\': out += "\\\\";
+                    break;
+                case '"': out += "\\\"";
+                    break;
+                case '\n': out += "\\n";
+                    break;
+                default: out += c;
+                }
+            }
+            return out;
+        }
+
+        double seconds(std::uint64_t ns)
+        {
+            return static_cast<double>(ns) / 1e9;
+        }
+
+        /**
+         * @brief 被采样计时的初始化占全部初始化的比例，没有初始化时为 1
+         */
+        double sample_ratio(const Aggregate& a)
+        {
+            if (a.init_count == 0)
+                return 1.0;
+            return static_cast<double>(a.init_sampled_count) / static_cast<double>(a.init_count);
+        }
+
+        /**
+         * @brief 按采样比例放大后的初始化总耗时
+         */
+        double scaled_init_seconds(const Aggregate& a)
+        {
+            if (a.init_sampled_count == 0)
+                return 0.0;
+            return seconds(a.init_ns_sum) / sample_ratio(a);
+        }
+
+        void write_header(std::ostream& os, const char* name, const char* type, const char* help)
+        {
+            os << "# HELP " << name << ' ' << help << '\n';
+            os << "# TYPE " << name << ' ' << type << '\n';
+        }
+
+        template <typename Getter>
+        void write_family(std::ostream& os, const std::map<std::string, Aggregate>& cells,
+                          const char* name, const char* type, const char* help, Getter getter)
+        {
+            write_header(os, name, type, help);
+            for (const auto& [label, agg] : cells)
+                os << name << "{lazy=\"" << label << "\"} " << getter(agg) << '\n';
+        }
+    }
+
+    void write_prometheus(std::ostream& os)
+    {
+        std::map<std::string, Aggregate> cells;
+        std::uint64_t initialized_cells = 0;
+        std::uint64_t total_cells = 0;
+
+        for (const auto& s : LazyRegistry::instance().snapshot())
+        {
+            auto& agg = cells[escape_label(s.name)];
+            agg.cells++;
+            agg.initialized += s.initialized ? 1 : 0;
+            agg.init_count += s.init_count;
+            agg.failure_count += s.failure_count;
+            agg.wait_count += s.wait_count;
+            agg.reset_count += s.reset_count;
+            agg.reload_count += s.reload_count;
+            agg.init_ns_sum += s.init_ns_sum;
+            agg.init_ns_max = agg.init_ns_max > s.init_ns_max ? agg.init_ns_max : s.init_ns_max;
+            agg.init_sampled_count += s.init_sampled_count;
+            agg.estimated_bytes += s.estimated_bytes;
+            agg.alloc_count += s.alloc_count;
+            agg.alloc_bytes += s.alloc_bytes;
+            agg.live_alloc_bytes += s.live_alloc_bytes;
+
+            total_cells++;
+            initialized_cells += s.initialized ? 1 : 0;
+        }
+
+        std::ostringstream out;
+        out.precision(9);
+
+        write_header(out, "cxxlazy_cells", "gauge", "Number of registered lazy cells.");
+        out << "cxxlazy_cells " << total_cells << '\n';
+        write_header(out, "cxxlazy_cells_initialized", "gauge", "Number of registered lazy cells holding a value.");
+        out << "cxxlazy_cells_initialized " << initialized_cells << '\n';
+
+        write_family(out, cells, "cxxlazy_initialized", "gauge",
+                     "Whether the lazy currently holds a value.",
+                     [](const Aggregate& a) { return a.initialized; });
+        write_family(out, cells, "cxxlazy_initializations_total", "counter",
+                     "Successful initializations.",
+                     [](const Aggregate& a) { return a.init_count; });
+
+        write_header(out, "cxxlazy_init_duration_seconds", "summary",
+                     "Time spent in successful initializers, scaled up from the timed sample.");
+        for (const auto& [label, agg] : cells)
+        {
+            out << "cxxlazy_init_duration_seconds_sum{lazy=\"" << label << "\"} " << scaled_init_seconds(agg) << '\n';
+            out << "cxxlazy_init_duration_seconds_count{lazy=\"" << label << "\"} " << agg.init_count << '\n';
+        }
+        write_family(out, cells, "cxxlazy_init_duration_max_seconds", "gauge",
+                     "Slowest timed successful initialization.",
+                     [](const Aggregate& a) { return seconds(a.init_ns_max); });
+        write_family(out, cells, "cxxlazy_init_duration_sample_ratio", "gauge",
+                     "Fraction of successful initializations that were timed.",
+                     [](const Aggregate& a) { return sample_ratio(a); });
+
+        write_family(out, cells, "cxxlazy_init_failures_total", "counter",
+                     "Initializers that threw an exception.",
+                     [](const Aggregate& a) { return a.failure_count; });
+        write_family(out, cells, "cxxlazy_waits_total", "counter",
+                     "Callers that blocked while another thread was initializing.",
+                     [](const Aggregate& a) { return a.wait_count; });
+        write_family(out, cells, "cxxlazy_resets_total", "counter",
+                     "Calls to reset.",
+                     [](const Aggregate& a) { return a.reset_count; });
+        write_family(out, cells, "cxxlazy_reloads_total", "counter",
+                     "Successful initializations after the first one.",
+                     [](const Aggregate& a) { return a.reload_count; });
+        write_family(out, cells, "cxxlazy_estimated_bytes", "gauge",
+                     "Estimated size of the held values.",
+                     [](const Aggregate& a) { return a.estimated_bytes; });
+        write_family(out, cells, "cxxlazy_init_allocations_total", "counter",
+                     "Heap allocations made while the initializer was running.",
+                     [](const Aggregate& a) { return a.alloc_count; });
+        write_family(out, cells, "cxxlazy_init_allocated_bytes_total", "counter",
+                     "Heap bytes allocated while the initializer was running.",
+                     [](const Aggregate& a) { return a.alloc_bytes; });
+        write_family(out, cells, "cxxlazy_init_live_bytes", "gauge",
+                     "Heap bytes allocated by the initializer and not yet freed.",
+                     [](const Aggregate& a) { return a.live_alloc_bytes; });
+
+        os << out.str();
+    }
+
+    std::string render_prometheus()
+    {
+        std::ostringstream os;
+        write_prometheus(os);
+        return os.str();
+    }
+}
@@ -0,0 +1,26 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include <ostream>
+#include <string>
+
+namespace components
+{
+    /**
+     * @brief 以 Prometheus 文本格式（0.0.4）写出所有已登记单元的统计信息
+     * @details
+     * 遍历 LazyRegistry，按单元名称打上 `lazy` 标签；同名单元的数据会被合并
+     * 采集过程只读取原子计数器，不获取任何单元的锁，不会阻塞 `get()` 路径
+     * @param os 输出流，例如管理端口的响应缓冲区
+     */
+    void write_prometheus(std::ostream& os);
+
+    /**
+     * @brief 以 Prometheus 文本格式渲染所有已登记单元的统计信息
+     * @return 渲染结果
+     */
+    std::string render_prometheus();
+}
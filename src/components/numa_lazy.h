@@ -0,0 +1,246 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include "cpu.h"
+#include "instrument.h"
+#include "slot_init.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace components
+{
+    /**
+     * @brief NumaLazy 创建其余节点副本的方式
+     */
+    enum class ReplicaMode
+    {
+        /// @brief 第一个读取的节点执行初始化函数，其余节点复制它的副本；T 不可复制时等同于 Build
+        Copy,
+        /// @brief 每个节点各自执行一次初始化函数
+        Build,
+    };
+
+    /**
+     * @class NumaLazy
+     * @brief 每个 NUMA 节点一份副本的只读惰性值，读取者访问本节点的副本
+     * @details
+     * 面向较大的、初始化后只读的数据（路由表、模型等）：单份数据位于一个节点上时，
+     * 其他节点上的读取者每次访问都要付出跨节点内存的延迟
+     * NumaLazy 在某个节点上第一次读取时才为该节点创建副本，由该节点上的线程构造，
+     * 依靠内核的首次访问（first-touch）策略把副本的内存放在本节点上
+     *
+     * - 拓扑从 /sys/devices/system/node 读取，不依赖 libnuma；读取失败或只有一个节点时只有一份副本，
+     *   开销与 `Lazy<T>` 相当；
+     * - 副本的认领与初始化和 PerCpuLazy 一样使用原子位图和全局的条带化等待表，初始化失败时下一次读取重新尝试
+     *
+     * 副本之间不同步，只提供 const 访问
+     * @tparam T 存储的数据类型
+     */
+    template <typename T>
+    class NumaLazy
+    {
+    public:
+        using InitFn = std::function<T()>;
+
+        /**
+         * @brief 构造一个匿名的按 NUMA 节点复制的惰性值
+         * @param init_fn 用于初始化值的函数
+         * @param mode 创建其余节点副本的方式
+         */
+        explicit NumaLazy(InitFn init_fn, ReplicaMode mode = ReplicaMode::Copy);
+
+        /**
+         * @brief 构造一个具名的按 NUMA 节点复制的惰性值，并将其登记到 LazyRegistry
+         * @details
+         * 所有副本共享一份统计信息：每个副本的创建计为一次初始化（不计为 reload），
+         * 估算字节数为所有已创建副本之和
+         */
+        NumaLazy(std::string_view name, InitFn init_fn, ReplicaMode mode = ReplicaMode::Copy);
+
+        /**
+         * @brief 析构所有副本，具名对象会从 LazyRegistry 注销
+         */
+        ~NumaLazy();
+
+        NumaLazy(const NumaLazy&) = delete;
+
+        NumaLazy& operator=(const NumaLazy&) = delete;
+
+        /**
+         * @brief 获取当前线程所在节点的副本，如果尚未创建，则先创建
+         */
+        const T& get() { return replica(detail::current_numa_node()); }
+
+        /**
+         * @brief 解引用操作符，等同于 get()
+         */
+        const T& operator*() { return get(); }
+
+        /**
+         * @brief 成员访问操作符，等同于 &get()
+         */
+        const T* operator->() { return &get(); }
+
+        /**
+         * @brief 获取指定节点的副本，如果尚未创建，则先创建
+         * @param node 节点下标，必须小于 replica_count()
+         */
+        const T& replica(std::size_t node);
+
+        /**
+         * @brief 检查是否已有任意一个副本被创建
+         */
+        [[nodiscard]] bool is_initialized() const { return initialized_count() > 0; }
+
+        /**
+         * @brief 副本数量上限，等于 NUMA 节点数量
+         */
+        [[nodiscard]] std::size_t replica_count() const { return count_; }
+
+        /**
+         * @brief 已创建的副本数量
+         */
+        [[nodiscard]] std::size_t initialized_count() const;
+
+        /**
+         * @brief 获取统计信息
+         * @return 具名对象返回其统计信息，匿名对象返回 `nullptr`
+         */
+        [[nodiscard]] const CellStats* stats() const { return stats_; }
+
+    private:
+        static constexpr std::size_t kWordBits = 64;
+
+        static std::size_t word_of(std::size_t node) { return node / kWordBits; }
+
+        static std::uint64_t bit_of(std::size_t node) { return std::uint64_t{1} << (node % kWordBits); }
+
+        const T& init_replica(std::size_t node);
+
+        /**
+         * @brief 复制模式下确定本节点副本的来源
+         * @details
+         * 第一个到达的节点成为主节点并执行初始化函数，返回 nullptr；
+         * 其余节点先确保主节点的副本已创建，返回它的地址供复制
+         * 主节点的副本在本节点的初始化作用域之外创建，两次初始化不会在同一份统计信息上嵌套
+         */
+        const T* copy_source(std::size_t node);
+
+        /**
+         * @brief 创建副本：有来源时复制来源，否则执行初始化函数
+         */
+        T* make_replica(const T* source);
+
+        static constexpr std::size_t kNoHome = ~std::size_t{0};
+
+        std::size_t count_;
+        std::size_t words_;
+        InitFn init_fn_;
+        ReplicaMode mode_;
+        /// @brief 已初始化位图
+        std::unique_ptr<std::atomic<std::uint64_t>[]> ready_;
+        /// @brief 已认领位图：正在初始化或已初始化
+        std::unique_ptr<std::atomic<std::uint64_t>[]> claimed_;
+        /// @brief 各节点的副本，在设置已初始化位之前发布，快速路径只读取这里
+        std::unique_ptr<std::atomic<T*>[]> replicas_;
+        /// @brief 主节点：复制模式下唯一执行初始化函数的节点
+        std::atomic<std::size_t> home_{kNoHome};
+        CellStats* stats_ = nullptr;
+    };
+
+    // ---------------- 实现 ----------------
+
+    template <typename T>
+    NumaLazy<T>::NumaLazy(InitFn init_fn, ReplicaMode mode)
+        : count_(detail::numa_node_count()), words_((count_ + kWordBits - 1) / kWordBits),
+          init_fn_(std::move(init_fn)), mode_(mode), ready_(new std::atomic<std::uint64_t>[words_]()),
+          claimed_(new std::atomic<std::uint64_t>[words_]()), replicas_(new std::atomic<T*>[count_]())
+    {
+    }
+
+    template <typename T>
+    NumaLazy<T>::NumaLazy(std::string_view name, InitFn init_fn, ReplicaMode mode)
+        : NumaLazy(std::move(init_fn), mode)
+    {
+        stats_ = LazyRegistry::instance().add(name);
+    }
+
+    template <typename T>
+    NumaLazy<T>::~NumaLazy()
+    {
+        for (std::size_t i = 0; i < count_; ++i)
+            delete replicas_[i].load(std::memory_order_acquire);
+        if (stats_)
+            LazyRegistry::instance().remove(stats_);
+    }
+
+    template <typename T>
+    const T& NumaLazy<T>::replica(std::size_t node)
+    {
+        if (const T* p = replicas_[node].load(std::memory_order_acquire))
+        {
+            trace::record(stats_, trace::AccessKind::Hit);
+            return *p;
+        }
+        return init_replica(node);
+    }
+
+    template <typename T>
+    const T& NumaLazy<T>::init_replica(std::size_t node)
+    {
+        const T* source = copy_source(node);
+        const std::uint64_t bit = bit_of(node);
+        detail::init_slot_once(&replicas_[node], stats_, claimed_[word_of(node)], bit, ready_[word_of(node)],
+                               bit, [&] {
+                                   T* p = make_replica(source);
+                                   replicas_[node].store(p, std::memory_order_release);
+                                   return ByteEstimator<T>{}(*p);
+                               });
+        return *replicas_[node].load(std::memory_order_acquire);
+    }
+
+    template <typename T>
+    const T* NumaLazy<T>::copy_source(std::size_t node)
+    {
+        if constexpr (std::is_copy_constructible_v<T>)
+        {
+            if (mode_ == ReplicaMode::Copy)
+            {
+                std::size_t home = kNoHome;
+                if (!home_.compare_exchange_strong(home, node, std::memory_order_acq_rel, std::memory_order_acquire) &&
+                    home != node)
+                    return &replica(home);
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename T>
+    T* NumaLazy<T>::make_replica(const T* source)
+    {
+        if constexpr (std::is_copy_constructible_v<T>)
+        {
+            if (source)
+                return new T(*source);
+        }
+        return new T(init_fn_());
+    }
+
+    template <typename T>
+    std::size_t NumaLazy<T>::initialized_count() const
+    {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < count_; ++i)
+            n += replicas_[i].load(std::memory_order_relaxed) != nullptr;
+        return n;
+    }
+}
@@ -6,11 +6,16 @@
 
 namespace components
 {
-    OnceCall::OnceCall() : state_(State::Uninitialized)
+    OnceCall::OnceCall(std::string_view name)
+        : state_(State::Uninitialized), stats_(LazyRegistry::instance().add(name))
     {
     }
 
-    OnceCall::~OnceCall() = default;
+    OnceCall::~OnceCall()
+    {
+        if (stats_)
+            LazyRegistry::instance().remove(stats_);
+    }
 
     bool OnceCall::is_initialized() const
     {
@@ -3,9 +3,12 @@
 //
 
 #pragma once
+#include "instrument.h"
 #include <mutex>
 #include <atomic>
+#include <memory>
 #include <optional>
+#include <string_view>
 #include <utility>
 
 namespace components
@@ -23,10 +26,18 @@ namespace components
     public:
         /**
          * @brief 构造一个新的 OnceCall 实例，初始状态为未初始化
+         * @details 常量初始化，全局实例不会在启动阶段执行任何构造代码
          */
-        OnceCall();
+        constexpr OnceCall() : state_(State::Uninitialized)
+        {
+        }
         /**
-         * @brief 默认析构函数
+         * @brief 构造一个具名的 OnceCall 实例，并将其登记到 LazyRegistry
+         * @param name 在统计信息和指标中使用的名称
+         */
+        explicit OnceCall(std::string_view name);
+        /**
+         * @brief 析构函数，具名实例会从 LazyRegistry 注销
          */
         ~OnceCall();
 
@@ -38,6 +49,7 @@ namespace components
          * 如果 `fn` 抛出异常，状态将回滚到未初始化，允许后续的 `call` 再次尝试
          * @tparam Fn 可调用对象的类型，例如函数指针、lambda 表达式等
          * @param fn 将要被执行的函数，签名为 `void()`
+         * @throws LazyInitError 检查模式下发现重入或初始化死锁时抛出
          */
         template <typename Fn>
         void call(Fn&& fn);
@@ -49,6 +61,9 @@ namespace components
         void reset() {
             std::lock_guard<std::mutex> lock(mtx_);
             state_.store(State::Uninitialized, std::memory_order_release);
+            if (stats_)
+                stats_->record_reset();
+            trace::record(stats_, trace::AccessKind::Reset);
         }
         /**
          * @brief 检查初始化是否已经成功完成
@@ -56,6 +71,12 @@ namespace components
          */
         bool is_initialized() const;
 
+        /**
+         * @brief 获取统计信息
+         * @return 具名实例返回其统计信息，匿名实例返回 `nullptr`
+         */
+        [[nodiscard]] const CellStats* stats() const { return stats_; }
+
     private:
         /// @brief 表示初始化状态的枚举
         enum class State { Uninitialized, Initializing, Initialized };
@@ -64,9 +85,27 @@ namespace components
         std::atomic<State> state_{};
         /// @brief 在初始化期间保护数据访问的互斥锁
         mutable std::mutex mtx_;
+        /// @brief 登记在 LazyRegistry 中的统计信息，匿名实例为空
+        CellStats* stats_ = nullptr;
     };
 
 
+    namespace detail
+    {
+        /**
+         * @brief OnceCell 默认使用的同步原语
+         * @details
+         * 可以替换为提供同名成员的类型，例如测试中由协作式调度器控制的模型原语，
+         * 用于系统地枚举状态转换的交错执行
+         */
+        struct StdSync
+        {
+            template <typename U>
+            using atomic = std::atomic<U>;
+            using mutex = std::mutex;
+        };
+    }
+
     /**
      * @class OnceCell
      * @brief 一个线程安全的、只能被赋值一次的容器
@@ -75,17 +114,24 @@ namespace components
      * 第一次调用 `get_or_init` 时会执行初始化函数并存储结果
      * 后续的访问将直接返回已存储的值，无需再次初始化
      * @tparam T 容器中存储的数据类型
+     * @tparam Sync 同步原语，默认为 std::atomic 和 std::mutex
      */
-    template <typename T>
+    template <typename T, typename Sync = detail::StdSync>
     class OnceCell
     {
     public:
         /**
          * @brief 构造一个新的、空的 OnceCell 实例
+         * @details 常量初始化，全局实例不会在启动阶段执行任何构造代码
          */
-        OnceCell();
+        constexpr OnceCell();
         /**
-         * @brief 默认析构函数
+         * @brief 构造一个具名的、空的 OnceCell 实例，并将其登记到 LazyRegistry
+         * @param name 在统计信息和指标中使用的名称
+         */
+        explicit OnceCell(std::string_view name);
+        /**
+         * @brief 析构函数，具名实例会从 LazyRegistry 注销
          */
         ~OnceCell();
 
@@ -98,6 +144,7 @@ namespace components
          * @tparam Fn 用于生成值的可调用对象的类型，其返回值必须可以转换为 `T`
          * @param fn 初始化函数
          * @return 对单元中值的引用
+         * @throws LazyInitError 检查模式下发现重入或初始化死锁时抛出
          */
         template <typename Fn>
         T& get_or_init(Fn&& fn);
@@ -123,7 +170,9 @@ namespace components
         /**
          * @brief 重置单元的状态，清除已存储的值
          * @details
-         * 这使得单元可以被重新初始化此操作是线程安全的
+         * 这使得单元可以被重新初始化
+         * 多个 reset 之间由互斥锁串行，但 reset 不能与 get / get_or_init / try_get 并发：
+         * 读取方拿到的引用没有任何生命周期保护，reset 销毁值之后该引用即悬空
          * 主要用于测试或需要动态更新配置的场景
          */
         void reset();
@@ -154,6 +203,12 @@ namespace components
          */
         const T* operator->() const { return &(*value_); }
 
+        /**
+         * @brief 获取统计信息
+         * @return 具名实例返回其统计信息，匿名实例返回 `nullptr`
+         */
+        [[nodiscard]] const CellStats* stats() const { return stats_; }
+
     private:
         /// @brief 表示初始化状态的枚举
         enum class State { Uninitialized, Initializing, Initialized };
@@ -161,9 +216,11 @@ namespace components
         /// @brief 使用 std::optional 存储值，以处理未初始化的情况
         std::optional<T> value_;
         /// @brief 原子地存储当前的状态
-        std::atomic<State> state_;
+        typename Sync::template atomic<State> state_;
         /// @brief 用于保护初始化过程的互斥锁
-        mutable std::mutex mtx_;
+        mutable typename Sync::mutex mtx_;
+        /// @brief 登记在 LazyRegistry 中的统计信息，匿名实例为空
+        CellStats* stats_ = nullptr;
     };
 
 
@@ -177,17 +234,28 @@ namespace components
     void OnceCall::call(Fn&& fn)
     {
         if (state_.load(std::memory_order_acquire) == State::Initialized)
+        {
+            trace::record(stats_, trace::AccessKind::Hit);
             return;
+        }
 
-        std::unique_lock<std::mutex> lock(mtx_);
+        detail::check_reentry(this, stats_);
+        std::unique_lock<std::mutex> lock(mtx_, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+            detail::WaitScope wait(this, stats_);
+            lock.lock();
+        }
         if (state_.load(std::memory_order_relaxed) == State::Initialized)
             return;
 
+        detail::InitScope scope(this, stats_);
         state_.store(State::Initializing, std::memory_order_relaxed);
         try
         {
             std::forward<Fn>(fn)(); // 完美转发
             state_.store(State::Initialized, std::memory_order_release);
+            scope.succeed(0);
         }
         catch (...)
         {
@@ -202,17 +270,32 @@ namespace components
      * @brief 构造一个新的 OnceCell 对象，初始状态为未初始化
      * @tparam T 单元中存储的数据类型
      */
-    template <typename T>
-    OnceCell<T>::OnceCell() : state_(State::Uninitialized)
+    template <typename T, typename Sync>
+    constexpr OnceCell<T, Sync>::OnceCell() : state_(State::Uninitialized)
     {
     }
 
     /**
-     * @brief 销毁 OnceCell 对象
+     * @brief 构造一个具名的 OnceCell 对象，并登记到 LazyRegistry
      * @tparam T 单元中存储的数据类型
+     * @param name 单元名称
      */
-    template <typename T>
-    OnceCell<T>::~OnceCell() = default;
+    template <typename T, typename Sync>
+    OnceCell<T, Sync>::OnceCell(std::string_view name)
+        : state_(State::Uninitialized), stats_(LazyRegistry::instance().add(name))
+    {
+    }
+
+    /**
+     * @brief 销毁 OnceCell 对象，具名单元会从 LazyRegistry 注销
+     * @tparam T 单元中存储的数据类型
+     */
+    template <typename T, typename Sync>
+    OnceCell<T, Sync>::~OnceCell()
+    {
+        if (stats_)
+            LazyRegistry::instance().remove(stats_);
+    }
 
     /**
      * @brief 获取单元中的值，如果单元未被初始化，则使用给定的函数进行初始化
@@ -221,22 +304,33 @@ namespace components
      * @param fn 用于初始化的函数（使用完美转发）
      * @return 单元中值的引用
      */
-    template <typename T>
+    template <typename T, typename Sync>
     template <typename Fn>
-    T& OnceCell<T>::get_or_init(Fn&& fn)
+    T& OnceCell<T, Sync>::get_or_init(Fn&& fn)
     {
         if (state_.load(std::memory_order_acquire) == State::Initialized)
+        {
+            trace::record(stats_, trace::AccessKind::Hit);
             return *value_;
+        }
 
-        std::unique_lock<std::mutex> lock(mtx_);
+        detail::check_reentry(this, stats_);
+        std::unique_lock<typename Sync::mutex> lock(mtx_, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+            detail::WaitScope wait(this, stats_);
+            lock.lock();
+        }
         if (state_.load(std::memory_order_relaxed) == State::Initialized)
             return *value_;
 
+        detail::InitScope scope(this, stats_);
         state_.store(State::Initializing, std::memory_order_relaxed);
         try
         {
             value_.emplace(std::forward<Fn>(fn)()); // 完美转发
             state_.store(State::Initialized, std::memory_order_release);
+            scope.succeed(ByteEstimator<T>{}(*value_));
             return *value_;
         }
         catch (...)
@@ -251,8 +345,8 @@ namespace components
      * @tparam T 单元中存储的数据类型
      * @return 如果单元已经被初始化，则返回 true，否则返回 false
      */
-    template <typename T>
-    bool OnceCell<T>::is_initialized() const
+    template <typename T, typename Sync>
+    bool OnceCell<T, Sync>::is_initialized() const
     {
         return state_.load(std::memory_order_acquire) == State::Initialized;
     }
@@ -262,8 +356,8 @@ namespace components
      * @tparam T 单元中存储的数据类型
      * @return 如果单元已经被初始化，则返回指向值的指针，否则返回 nullptr
      */
-    template <typename T>
-    T* OnceCell<T>::get()
+    template <typename T, typename Sync>
+    T* OnceCell<T, Sync>::get()
     {
         if (state_.load(std::memory_order_acquire) == State::Initialized)
             return &(*value_);
@@ -275,8 +369,8 @@ namespace components
      * @tparam T 单元中存储的数据类型
      * @return 如果单元已经被初始化，则返回指向值的只读指针，否则返回 nullptr
      */
-    template <typename T>
-    const T* OnceCell<T>::try_get() const
+    template <typename T, typename Sync>
+    const T* OnceCell<T, Sync>::try_get() const
     {
         if (state_.load(std::memory_order_acquire) == State::Initialized)
             return &(*value_);
@@ -287,11 +381,17 @@ namespace components
      * @brief 重置单元的状态，清除已存储的值，使其可以被重新初始化
      * @tparam T 单元中存储的数据类型
      */
-    template <typename T>
-    void OnceCell<T>::reset()
+    template <typename T, typename Sync>
+    void OnceCell<T, Sync>::reset()
     {
-        std::lock_guard<std::mutex> lock(mtx_);
-        value_.reset();
+        std::lock_guard<typename Sync::mutex> lock(mtx_);
+        // 先发布未初始化状态再销毁值，只是缩小了与并发读取交错时的窗口：
+        // 已经通过快速路径检查、或者已经持有引用的读取方仍会访问到被销毁的值，
+        // 因此调用方仍须保证 reset 不与任何读取并发
         state_.store(State::Uninitialized, std::memory_order_release);
+        value_.reset();
+        if (stats_)
+            stats_->record_reset();
+        trace::record(stats_, trace::AccessKind::Reset);
     }
 }
\ No newline at end of file
@@ -0,0 +1,242 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include "cpu.h"
+#include "instrument.h"
+#include "slot_init.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+
+namespace components
+{
+    /**
+     * @class PerCpuLazy
+     * @brief 每个 CPU 一份的惰性值，用于计数器、对象池、临时缓冲区等被频繁修改的热点状态
+     * @details
+     * 全局的 `Lazy<T>` 加互斥锁在值被频繁修改时会成为所有核心的竞争点；
+     * PerCpuLazy 按当前线程所在的 CPU 选择分片，不同核心上的线程修改不同的分片，互不竞争
+     *
+     * - 分片在该 CPU 上第一次访问时才分配和初始化，从未运行过相关代码的 CPU 不占用内存；
+     * - 每个分片独占缓存行，带有一把通常无竞争的互斥锁；
+     * - 分片的认领与初始化和 LazyArray 一样使用两张原子位图和全局的条带化等待表
+     *
+     * 线程随时可能被迁移到其他 CPU，同一个分片仍可能被多个线程同时访问：
+     * 需要独占访问时使用 with_local()，T 本身线程安全（例如原子计数器）时可以直接使用 local()
+     * @tparam T 分片中存储的数据类型
+     */
+    template <typename T>
+    class PerCpuLazy
+    {
+    public:
+        using InitFn = std::function<T(std::size_t)>;
+
+        /**
+         * @brief 构造一个匿名的按 CPU 分片的惰性值
+         * @param init_fn 分片的初始化函数，参数为 CPU 编号
+         */
+        explicit PerCpuLazy(InitFn init_fn);
+
+        /**
+         * @brief 构造一个具名的按 CPU 分片的惰性值，并将其登记到 LazyRegistry
+         * @details
+         * 所有分片共享一份统计信息：每个分片的初始化计为一次初始化（不计为 reload），
+         * 估算字节数为所有已初始化分片之和，多个分片同时初始化时按计数报告为进行中
+         */
+        PerCpuLazy(std::string_view name, InitFn init_fn);
+
+        /**
+         * @brief 析构并释放所有已初始化的分片，具名对象会从 LazyRegistry 注销
+         */
+        ~PerCpuLazy();
+
+        PerCpuLazy(const PerCpuLazy&) = delete;
+
+        PerCpuLazy& operator=(const PerCpuLazy&) = delete;
+
+        /**
+         * @brief 获取当前 CPU 的分片，如果尚未初始化，则先进行初始化
+         * @warning 不持有分片锁，T 必须能承受并发访问
+         */
+        T& local() { return get(detail::current_cpu()); }
+
+        /**
+         * @brief 持有当前 CPU 分片的锁调用 fn
+         * @param fn 签名为 `R(T&)`
+         * @return fn 的返回值
+         */
+        template <typename Fn>
+        decltype(auto) with_local(Fn&& fn);
+
+        /**
+         * @brief 获取指定 CPU 的分片，如果尚未初始化，则先进行初始化
+         * @param cpu CPU 编号，必须小于 shard_count()
+         */
+        T& get(std::size_t cpu);
+
+        /**
+         * @brief 尝试获取指定 CPU 的分片，不会触发初始化
+         * @return 已初始化时返回值指针，否则返回 nullptr
+         */
+        [[nodiscard]] const T* try_get(std::size_t cpu) const;
+
+        /**
+         * @brief 按 CPU 编号顺序访问所有已初始化的分片，不会触发初始化
+         * @details 访问每个分片时持有该分片的锁，与 with_local() 互斥；遍历期间新初始化的分片可能被访问也可能不被访问
+         * @param fn 签名为 `void(const T&)`
+         */
+        template <typename Fn>
+        void aggregate(Fn&& fn) const;
+
+        /**
+         * @brief 分片数量，等于系统配置的 CPU 数量
+         */
+        [[nodiscard]] std::size_t shard_count() const { return count_; }
+
+        /**
+         * @brief 已初始化的分片数量
+         */
+        [[nodiscard]] std::size_t initialized_count() const;
+
+        /**
+         * @brief 获取统计信息
+         * @return 具名对象返回其统计信息，匿名对象返回 `nullptr`
+         */
+        [[nodiscard]] const CellStats* stats() const { return stats_; }
+
+    private:
+        struct alignas(64) Shard
+        {
+            /// @brief 值直接由初始化函数的返回值构造，T 不需要可移动
+            Shard(const InitFn& init_fn, std::size_t cpu) : value(init_fn(cpu))
+            {
+            }
+
+            mutable std::mutex mtx;
+            T value;
+        };
+
+        static constexpr std::size_t kWordBits = 64;
+
+        static std::size_t word_of(std::size_t cpu) { return cpu / kWordBits; }
+
+        static std::uint64_t bit_of(std::size_t cpu) { return std::uint64_t{1} << (cpu % kWordBits); }
+
+        Shard& shard(std::size_t cpu);
+
+        Shard& init_shard(std::size_t cpu);
+
+        std::size_t count_;
+        std::size_t words_;
+        InitFn init_fn_;
+        /// @brief 已初始化位图
+        std::unique_ptr<std::atomic<std::uint64_t>[]> ready_;
+        /// @brief 已认领位图：正在初始化或已初始化
+        std::unique_ptr<std::atomic<std::uint64_t>[]> claimed_;
+        /// @brief 分片指针，在设置已初始化位之前发布，快速路径只读取这里
+        std::unique_ptr<std::atomic<Shard*>[]> shards_;
+        CellStats* stats_ = nullptr;
+    };
+
+    // ---------------- 实现 ----------------
+
+    template <typename T>
+    PerCpuLazy<T>::PerCpuLazy(InitFn init_fn)
+        : count_(detail::cpu_count()), words_((count_ + kWordBits - 1) / kWordBits), init_fn_(std::move(init_fn)),
+          ready_(new std::atomic<std::uint64_t>[words_]()), claimed_(new std::atomic<std::uint64_t>[words_]()),
+          shards_(new std::atomic<Shard*>[count_]())
+    {
+    }
+
+    template <typename T>
+    PerCpuLazy<T>::PerCpuLazy(std::string_view name, InitFn init_fn) : PerCpuLazy(std::move(init_fn))
+    {
+        stats_ = LazyRegistry::instance().add(name);
+    }
+
+    template <typename T>
+    PerCpuLazy<T>::~PerCpuLazy()
+    {
+        for (std::size_t i = 0; i < count_; ++i)
+            delete shards_[i].load(std::memory_order_acquire);
+        if (stats_)
+            LazyRegistry::instance().remove(stats_);
+    }
+
+    template <typename T>
+    typename PerCpuLazy<T>::Shard& PerCpuLazy<T>::shard(std::size_t cpu)
+    {
+        if (Shard* s = shards_[cpu].load(std::memory_order_acquire))
+        {
+            trace::record(stats_, trace::AccessKind::Hit);
+            return *s;
+        }
+        return init_shard(cpu);
+    }
+
+    template <typename T>
+    typename PerCpuLazy<T>::Shard& PerCpuLazy<T>::init_shard(std::size_t cpu)
+    {
+        const std::uint64_t bit = bit_of(cpu);
+        detail::init_slot_once(&shards_[cpu], stats_, claimed_[word_of(cpu)], bit, ready_[word_of(cpu)], bit,
+                               [&] {
+                                   auto* s = new Shard(init_fn_, cpu);
+                                   shards_[cpu].store(s, std::memory_order_release);
+                                   return sizeof(Shard) + ByteEstimator<T>{}(s->value) - sizeof(T);
+                               });
+        return *shards_[cpu].load(std::memory_order_acquire);
+    }
+
+    template <typename T>
+    T& PerCpuLazy<T>::get(std::size_t cpu)
+    {
+        return shard(cpu).value;
+    }
+
+    template <typename T>
+    template <typename Fn>
+    decltype(auto) PerCpuLazy<T>::with_local(Fn&& fn)
+    {
+        Shard& s = shard(detail::current_cpu());
+        std::lock_guard<std::mutex> lock(s.mtx);
+        return std::forward<Fn>(fn)(s.value);
+    }
+
+    template <typename T>
+    const T* PerCpuLazy<T>::try_get(std::size_t cpu) const
+    {
+        const Shard* s = shards_[cpu].load(std::memory_order_acquire);
+        return s ? &s->value : nullptr;
+    }
+
+    template <typename T>
+    std::size_t PerCpuLazy<T>::initialized_count() const
+    {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < count_; ++i)
+            n += shards_[i].load(std::memory_order_relaxed) != nullptr;
+        return n;
+    }
+
+    template <typename T>
+    template <typename Fn>
+    void PerCpuLazy<T>::aggregate(Fn&& fn) const
+    {
+        for (std::size_t i = 0; i < count_; ++i)
+        {
+            if (const Shard* s = shards_[i].load(std::memory_order_acquire))
+            {
+                std::lock_guard<std::mutex> lock(s->mtx);
+                fn(static_cast<const T&>(s->value));
+            }
+        }
+    }
+}
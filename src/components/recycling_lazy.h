@@ -0,0 +1,245 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace components
+{
+    /**
+     * @class RecyclePool
+     * @brief 有容量上限的无锁对象池，保存线程退出时归还的线程局部值
+     * @details
+     * 池由固定数量的原子指针槽位组成：归还时把空槽位比较交换为对象指针，取出时把槽位交换为空，
+     * 每个对象只会被一个线程取到，不存在 ABA 问题；池满时归还失败，由调用方销毁对象
+     *
+     * 可选的重置函数在对象归还时、由退出的线程调用，下一个线程拿到的对象已经处于可用状态
+     * 重置函数抛出异常时对象不进入池，直接销毁
+     * @tparam T 池中对象的类型
+     */
+    template <typename T>
+    class RecyclePool
+    {
+    public:
+        using ResetFn = std::function<void(T&)>;
+
+        /**
+         * @brief 构造一个对象池
+         * @param capacity 最多保存的对象数量
+         * @param reset_fn 对象归还时调用的重置函数，可以为空
+         */
+        explicit RecyclePool(std::size_t capacity, ResetFn reset_fn = {});
+
+        /**
+         * @brief 销毁池中剩余的对象
+         */
+        ~RecyclePool();
+
+        RecyclePool(const RecyclePool&) = delete;
+
+        RecyclePool& operator=(const RecyclePool&) = delete;
+
+        /**
+         * @brief 取出一个对象
+         * @return 池为空时返回 nullptr
+         */
+        std::unique_ptr<T> take();
+
+        /**
+         * @brief 重置并归还一个对象，池满或重置失败时销毁对象
+         * @return 对象是否进入了池
+         */
+        bool give(std::unique_ptr<T> value) noexcept;
+
+        /**
+         * @brief 最多保存的对象数量
+         */
+        [[nodiscard]] std::size_t capacity() const { return capacity_; }
+
+        /**
+         * @brief 池中当前的对象数量（近似值）
+         */
+        [[nodiscard]] std::size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief 从池中取出、被复用的对象总数
+         */
+        [[nodiscard]] std::uint64_t reused_count() const { return reused_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief 因池满或重置失败而被销毁的对象总数
+         */
+        [[nodiscard]] std::uint64_t discarded_count() const { return discarded_.load(std::memory_order_relaxed); }
+
+    private:
+        std::size_t capacity_;
+        ResetFn reset_fn_;
+        std::unique_ptr<std::atomic<T*>[]> slots_;
+        std::atomic<std::size_t> size_{0};
+        std::atomic<std::uint64_t> reused_{0};
+        std::atomic<std::uint64_t> discarded_{0};
+    };
+
+    /**
+     * @class RecyclingLazy
+     * @brief 线程退出时把值归还到对象池的线程局部惰性值
+     * @details
+     * 作为 thread_local 变量使用：第一次访问时优先从池中取一个之前的线程留下的值，池为空时才调用初始化函数；
+     * 线程退出时值被重置并归还到池中，供下一个线程复用
+     * 适合线程频繁创建和退出的线程池中，构造代价较高的缓冲区、解析器、随机数状态等，
+     * 新线程不必从头构建，也减少了分配器的抖动
+     *
+     * 值在堆上分配，在线程之间转移时不移动也不复制
+     * @tparam T 存储的数据类型
+     */
+    template <typename T>
+    class RecyclingLazy
+    {
+    public:
+        using InitFn = std::function<T()>;
+
+        /**
+         * @brief 构造一个可回收的线程局部惰性值
+         * @param pool 归还和复用值的对象池，生命周期必须长于所有使用它的线程
+         * @param init_fn 池为空时用于初始化值的函数
+         */
+        RecyclingLazy(RecyclePool<T>& pool, InitFn init_fn);
+
+        /**
+         * @brief 把已初始化的值归还到对象池
+         */
+        ~RecyclingLazy() { pool_->give(std::move(value_)); }
+
+        RecyclingLazy(const RecyclingLazy&) = delete;
+
+        RecyclingLazy& operator=(const RecyclingLazy&) = delete;
+
+        /**
+         * @brief 获取值，如果尚未初始化，则先从池中取出或进行初始化
+         * @return 值的引用
+         */
+        T& get()
+        {
+            if (!value_)
+                acquire();
+            return *value_;
+        }
+
+        /**
+         * @brief 解引用操作符，获取值的引用
+         */
+        T& operator*() { return get(); }
+
+        /**
+         * @brief 成员访问操作符，获取值的指针
+         */
+        T* operator->() { return &get(); }
+
+        /**
+         * @brief 检查值是否已经初始化
+         */
+        [[nodiscard]] bool is_initialized() const { return value_ != nullptr; }
+
+        /**
+         * @brief 当前的值是否来自对象池
+         */
+        [[nodiscard]] bool is_recycled() const { return recycled_; }
+
+    private:
+        void acquire();
+
+        RecyclePool<T>* pool_;
+        InitFn init_fn_;
+        std::unique_ptr<T> value_;
+        bool recycled_ = false;
+    };
+
+    // ---------------- 实现 ----------------
+
+    template <typename T>
+    RecyclePool<T>::RecyclePool(std::size_t capacity, ResetFn reset_fn)
+        : capacity_(capacity), reset_fn_(std::move(reset_fn)), slots_(new std::atomic<T*>[capacity]())
+    {
+    }
+
+    template <typename T>
+    RecyclePool<T>::~RecyclePool()
+    {
+        for (std::size_t i = 0; i < capacity_; ++i)
+            delete slots_[i].load(std::memory_order_acquire);
+    }
+
+    template <typename T>
+    std::unique_ptr<T> RecyclePool<T>::take()
+    {
+        if (size_.load(std::memory_order_relaxed) == 0)
+            return nullptr;
+        for (std::size_t i = 0; i < capacity_; ++i)
+        {
+            if (!slots_[i].load(std::memory_order_relaxed))
+                continue;
+            if (T* p = slots_[i].exchange(nullptr, std::memory_order_acquire))
+            {
+                size_.fetch_sub(1, std::memory_order_relaxed);
+                reused_.fetch_add(1, std::memory_order_relaxed);
+                return std::unique_ptr<T>(p);
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename T>
+    bool RecyclePool<T>::give(std::unique_ptr<T> value) noexcept
+    {
+        if (!value)
+            return false;
+        if (size_.load(std::memory_order_relaxed) < capacity_)
+        {
+            try
+            {
+                if (reset_fn_)
+                    reset_fn_(*value);
+            }
+            catch (...)
+            {
+                discarded_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            for (std::size_t i = 0; i < capacity_; ++i)
+            {
+                T* expected = nullptr;
+                if (slots_[i].load(std::memory_order_relaxed) == nullptr &&
+                    slots_[i].compare_exchange_strong(expected, value.get(), std::memory_order_release,
+                                                      std::memory_order_relaxed))
+                {
+                    value.release();
+                    size_.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+        discarded_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    template <typename T>
+    RecyclingLazy<T>::RecyclingLazy(RecyclePool<T>& pool, InitFn init_fn)
+        : pool_(&pool), init_fn_(std::move(init_fn))
+    {
+    }
+
+    template <typename T>
+    void RecyclingLazy<T>::acquire()
+    {
+        value_ = pool_->take();
+        recycled_ = value_ != nullptr;
+        if (!value_)
+            value_.reset(new T(init_fn_()));
+    }
+}
@@ -0,0 +1,166 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#include "registry.h"
+
+#include <algorithm>
+
+namespace components
+{
+    namespace
+    {
+        std::atomic<std::uint32_t> next_cell_id{0};
+    }
+
+    CellStats::CellStats(std::string_view name)
+        : name_(name), id_(next_cell_id.fetch_add(1, std::memory_order_relaxed) + 1)
+    {
+    }
+
+    void CellStats::record_timing(std::uint64_t ns, bool sampled) noexcept
+    {
+        if (!sampled)
+            return;
+        init_sampled_count_.fetch_add(1, std::memory_order_relaxed);
+        init_ns_sum_.fetch_add(ns, std::memory_order_relaxed);
+        std::uint64_t prev = init_ns_max_.load(std::memory_order_relaxed);
+        while (prev < ns && !init_ns_max_.compare_exchange_weak(prev, ns, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void CellStats::record_init(std::uint64_t ns, std::size_t bytes, bool sampled) noexcept
+    {
+        if (init_count_.fetch_add(1, std::memory_order_relaxed) > 0)
+            reload_count_.fetch_add(1, std::memory_order_relaxed);
+        record_timing(ns, sampled);
+        estimated_bytes_.store(bytes, std::memory_order_relaxed);
+        initialized_.store(true, std::memory_order_release);
+        initializing_.fetch_sub(1, std::memory_order_release);
+    }
+
+    void CellStats::record_slot_init(std::uint64_t ns, std::size_t bytes, bool sampled) noexcept
+    {
+        init_count_.fetch_add(1, std::memory_order_relaxed);
+        record_timing(ns, sampled);
+        estimated_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        initialized_.store(true, std::memory_order_release);
+        initializing_.fetch_sub(1, std::memory_order_release);
+    }
+
+    void CellStats::record_failure() noexcept
+    {
+        failure_count_.fetch_add(1, std::memory_order_relaxed);
+        initializing_.fetch_sub(1, std::memory_order_release);
+    }
+
+    void CellStats::record_wait() noexcept
+    {
+        wait_count_.fetch_add(1, std::memory_order_relaxed);
+        waiters_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void CellStats::record_reset() noexcept
+    {
+        reset_count_.fetch_add(1, std::memory_order_relaxed);
+        estimated_bytes_.store(0, std::memory_order_relaxed);
+        initialized_.store(false, std::memory_order_release);
+    }
+
+    CellSnapshot CellStats::snapshot() const
+    {
+        CellSnapshot s;
+        s.name = name_;
+        s.initialized = initialized_.load(std::memory_order_acquire);
+        s.init_count = init_count_.load(std::memory_order_relaxed);
+        s.failure_count = failure_count_.load(std::memory_order_relaxed);
+        s.wait_count = wait_count_.load(std::memory_order_relaxed);
+        s.reset_count = reset_count_.load(std::memory_order_relaxed);
+        s.reload_count = reload_count_.load(std::memory_order_relaxed);
+        s.init_ns_sum = init_ns_sum_.load(std::memory_order_relaxed);
+        s.init_ns_max = init_ns_max_.load(std::memory_order_relaxed);
+        s.init_sampled_count = init_sampled_count_.load(std::memory_order_relaxed);
+        s.estimated_bytes = estimated_bytes_.load(std::memory_order_relaxed);
+        s.alloc_count = alloc_count_.load(std::memory_order_relaxed);
+        s.alloc_bytes = alloc_bytes_.load(std::memory_order_relaxed);
+        s.live_alloc_bytes = live_alloc_bytes_.load(std::memory_order_relaxed);
+        s.initializing_count = initializing_.load(std::memory_order_acquire);
+        s.initializing = s.initializing_count > 0;
+        s.init_started_ns = s.initializing ? init_started_ns_.load(std::memory_order_relaxed) : 0;
+        s.init_thread = init_thread_.load(std::memory_order_relaxed);
+        s.waiters = waiters_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    LazyRegistry& LazyRegistry::instance()
+    {
+        // 故意泄漏：全局惰性对象可能在静态析构阶段才注销
+        static auto* registry = new LazyRegistry();
+        return *registry;
+    }
+
+    CellStats* LazyRegistry::add(std::string_view name)
+    {
+        auto stats = std::make_shared<CellStats>(name);
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (auto it = sampling_.find(name); it != sampling_.end())
+            stats->set_sampling(it->second);
+        cells_.push_back(stats);
+        return stats.get();
+    }
+
+    void LazyRegistry::remove(const CellStats* stats)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto it = std::find_if(cells_.begin(), cells_.end(),
+                               [stats](const std::shared_ptr<CellStats>& p) { return p.get() == stats; });
+        if (it == cells_.end())
+            return;
+        prune_retired();
+        if ((*it)->live_alloc_bytes() != 0)
+            retired_.push_back(*it);
+        cells_.erase(it);
+    }
+
+    void LazyRegistry::prune_retired() const
+    {
+        retired_.erase(std::remove_if(retired_.begin(), retired_.end(),
+                                      [](const std::shared_ptr<CellStats>& p) { return p->live_alloc_bytes() == 0; }),
+                       retired_.end());
+    }
+
+    std::vector<std::shared_ptr<const CellStats>> LazyRegistry::cells() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        prune_retired();
+        return {cells_.begin(), cells_.end()};
+    }
+
+    std::size_t LazyRegistry::retired_count() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return retired_.size();
+    }
+
+    std::vector<CellSnapshot> LazyRegistry::snapshot() const
+    {
+        auto list = cells();
+        std::vector<CellSnapshot> result;
+        result.reserve(list.size());
+        for (const auto& stats : list)
+            result.push_back(stats->snapshot());
+        return result;
+    }
+
+    void LazyRegistry::set_sampling(std::string_view name, const SamplingPolicy& policy)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        sampling_[std::string(name)] = policy;
+        for (const auto& stats : cells_)
+        {
+            if (stats->name() == name)
+                stats->set_sampling(policy);
+        }
+    }
+}
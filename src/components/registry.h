@@ -0,0 +1,374 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace components
+{
+    class DependencyGraph;
+
+    namespace detail
+    {
+        struct DependencyCounter;
+    }
+
+    /**
+     * @brief 初始化耗时的采样策略
+     * @details
+     * 计数器始终精确，只有计时（读取时钟）会被采样
+     * 两种方式可以同时使用：先按 1/N 抽样，再限制每个单元在一个周期内最多计时一次
+     */
+    struct SamplingPolicy
+    {
+        /// @brief 每 N 次事件随机计时一次；1 表示每次都计时，0 表示从不计时
+        std::uint32_t one_in = 1;
+        /// @brief 大于 0 时，每个单元在该周期内最多计时一次（不论由哪个线程初始化）
+        std::chrono::nanoseconds period{0};
+    };
+
+    /**
+     * @brief 某一时刻单元统计信息的普通值拷贝
+     */
+    struct CellSnapshot
+    {
+        std::string name;
+        bool initialized = false;
+        std::uint64_t init_count = 0;
+        std::uint64_t failure_count = 0;
+        std::uint64_t wait_count = 0;
+        std::uint64_t reset_count = 0;
+        std::uint64_t reload_count = 0;
+        /// @brief 被采样计时的初始化的耗时之和
+        std::uint64_t init_ns_sum = 0;
+        /// @brief 被采样计时的初始化中最慢的一次
+        std::uint64_t init_ns_max = 0;
+        /// @brief 被采样计时的成功初始化次数，init_count / init_sampled_count 即放大倍数
+        std::uint64_t init_sampled_count = 0;
+        std::uint64_t estimated_bytes = 0;
+        std::uint64_t alloc_count = 0;
+        std::uint64_t alloc_bytes = 0;
+        std::int64_t live_alloc_bytes = 0;
+        /// @brief 当前是否有线程正在执行初始化函数
+        bool initializing = false;
+        /// @brief 正在进行的初始化数量；容器的多个槽位可以同时初始化，单个单元最多为 1
+        std::uint32_t initializing_count = 0;
+        /// @brief 本次初始化开始的 steady_clock 时间（纳秒），未被采样计时或没有正在进行的初始化时为 0
+        std::int64_t init_started_ns = 0;
+        /// @brief 正在执行初始化函数的线程
+        std::thread::id init_thread;
+        /// @brief 当前阻塞等待初始化完成的线程数
+        std::uint32_t waiters = 0;
+    };
+
+    /**
+     * @class CellStats
+     * @brief 一个具名惰性单元的统计信息，由 LazyRegistry 持有
+     * @details
+     * 所有计数器都是原子变量，只在初始化、等待、重置等慢路径上更新
+     * 读取方（例如指标导出）无需获取任何单元的锁，因此不会阻塞 `get()` 快速路径
+     */
+    class CellStats : public std::enable_shared_from_this<CellStats>
+    {
+    public:
+        /**
+         * @brief 构造统计信息
+         * @param name 单元名称
+         */
+        explicit CellStats(std::string_view name);
+
+        CellStats(const CellStats&) = delete;
+
+        CellStats& operator=(const CellStats&) = delete;
+
+        /**
+         * @brief 单元名称
+         */
+        [[nodiscard]] const std::string& name() const { return name_; }
+
+        /**
+         * @brief 进程内唯一的单元编号，从 1 开始，用于访问追踪等紧凑记录
+         */
+        [[nodiscard]] std::uint32_t id() const { return id_; }
+
+        /**
+         * @brief 记录当前线程开始执行初始化函数
+         * @details 与 record_init / record_slot_init / record_failure 成对调用，进行中的初始化按计数跟踪
+         * @param started_ns 开始时间，steady_clock 纳秒；未被采样计时时为 0
+         */
+        void begin_init(std::int64_t started_ns) noexcept
+        {
+            init_thread_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+            init_started_ns_.store(started_ns, std::memory_order_relaxed);
+            initializing_.fetch_add(1, std::memory_order_release);
+        }
+
+        /**
+         * @brief 记录一次成功的初始化
+         * @details 第二次及之后的初始化（重置后重新加载）计为 reload，估算字节数被本次的值替换
+         * @param ns 初始化耗时（纳秒），未被采样计时时忽略
+         * @param bytes 估算的值占用字节数
+         * @param sampled 本次初始化是否被采样计时
+         */
+        void record_init(std::uint64_t ns, std::size_t bytes, bool sampled = true) noexcept;
+
+        /**
+         * @brief 记录容器中一个槽位的成功初始化
+         * @details
+         * 供多个槽位共享一份统计信息的容器（LazyArray、PerCpuLazy、NumaLazy 等）使用：
+         * 每个槽位计为一次初始化但不计为 reload，估算字节数累加到所有槽位之和
+         * @param ns 初始化耗时（纳秒），未被采样计时时忽略
+         * @param bytes 估算的该槽位值占用字节数
+         * @param sampled 本次初始化是否被采样计时
+         */
+        void record_slot_init(std::uint64_t ns, std::size_t bytes, bool sampled = true) noexcept;
+
+        /**
+         * @brief 记录一次失败（抛出异常）的初始化
+         */
+        void record_failure() noexcept;
+
+        /**
+         * @brief 记录一个线程因其他线程正在初始化而开始阻塞等待
+         * @details 与 end_wait 成对调用
+         */
+        void record_wait() noexcept;
+
+        /**
+         * @brief 一个线程结束阻塞等待
+         */
+        void end_wait() noexcept
+        {
+            waiters_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief 记录一次重置
+         */
+        void record_reset() noexcept;
+
+        /**
+         * @brief 记录一次归属于该单元初始化函数的内存分配
+         * @param bytes 分配的字节数
+         */
+        void record_alloc(std::size_t bytes) noexcept
+        {
+            alloc_count_.fetch_add(1, std::memory_order_relaxed);
+            alloc_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+            live_alloc_bytes_.fetch_add(static_cast<std::int64_t>(bytes), std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief 记录一次归属于该单元的内存释放
+         * @param bytes 释放的字节数
+         */
+        void record_free(std::size_t bytes) noexcept
+        {
+            live_alloc_bytes_.fetch_sub(static_cast<std::int64_t>(bytes), std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief 归属于该单元、尚未释放的字节数
+         */
+        [[nodiscard]] std::int64_t live_alloc_bytes() const noexcept
+        {
+            return live_alloc_bytes_.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief 为该单元单独设置采样策略
+         */
+        void set_sampling(const SamplingPolicy& policy) noexcept
+        {
+            sample_one_in_.store(policy.one_in, std::memory_order_relaxed);
+            sample_period_ns_.store(policy.period.count(), std::memory_order_relaxed);
+            custom_sampling_.store(true, std::memory_order_release);
+        }
+
+        /**
+         * @brief 获取该单元单独设置的采样策略
+         * @param policy 输出参数
+         * @return 没有单独设置时返回 false，此时应使用全局策略
+         */
+        bool sampling(SamplingPolicy& policy) const noexcept
+        {
+            if (!custom_sampling_.load(std::memory_order_acquire))
+                return false;
+            policy.one_in = sample_one_in_.load(std::memory_order_relaxed);
+            policy.period = std::chrono::nanoseconds(sample_period_ns_.load(std::memory_order_relaxed));
+            return true;
+        }
+
+        /**
+         * @brief 按采样周期认领一次计时
+         * @details 截止时间保存在单元自己的统计信息中，不同单元、不同策略之间互不影响
+         * @param now_ns 当前时间，纳秒
+         * @param period_ns 采样周期，纳秒
+         * @return 本单元在当前周期内尚未计时并且认领成功时返回 true
+         */
+        bool claim_sample_period(std::int64_t now_ns, std::int64_t period_ns) noexcept
+        {
+            std::int64_t deadline = next_sample_ns_.load(std::memory_order_relaxed);
+            if (now_ns < deadline)
+                return false;
+            // 多个线程同时到达周期边界时只有一个能推进截止时间
+            return next_sample_ns_.compare_exchange_strong(deadline, now_ns + period_ns, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief 读取当前统计信息的拷贝，不加锁
+         */
+        [[nodiscard]] CellSnapshot snapshot() const;
+
+    private:
+        friend class DependencyGraph;
+
+        /**
+         * @brief 累加一次被采样计时的初始化耗时
+         */
+        void record_timing(std::uint64_t ns, bool sampled) noexcept;
+
+        const std::string name_;
+        const std::uint32_t id_;
+        std::atomic<bool> initialized_{false};
+        std::atomic<std::uint64_t> init_count_{0};
+        std::atomic<std::uint64_t> failure_count_{0};
+        std::atomic<std::uint64_t> wait_count_{0};
+        std::atomic<std::uint64_t> reset_count_{0};
+        std::atomic<std::uint64_t> reload_count_{0};
+        std::atomic<std::uint64_t> init_ns_sum_{0};
+        std::atomic<std::uint64_t> init_ns_max_{0};
+        std::atomic<std::uint64_t> init_sampled_count_{0};
+        std::atomic<std::uint64_t> estimated_bytes_{0};
+        std::atomic<std::uint64_t> alloc_count_{0};
+        std::atomic<std::uint64_t> alloc_bytes_{0};
+        std::atomic<std::int64_t> live_alloc_bytes_{0};
+        /// @brief 正在进行的初始化数量
+        std::atomic<std::uint32_t> initializing_{0};
+        std::atomic<std::int64_t> init_started_ns_{0};
+        std::atomic<std::thread::id> init_thread_{};
+        std::atomic<std::uint32_t> waiters_{0};
+        std::atomic<bool> custom_sampling_{false};
+        std::atomic<std::uint32_t> sample_one_in_{1};
+        std::atomic<std::int64_t> sample_period_ns_{0};
+        /// @brief 下一次允许按周期计时的时间（纳秒）
+        std::atomic<std::int64_t> next_sample_ns_{0};
+        /// @brief 该单元作为子节点上一次记录的依赖边，由 DependencyGraph 读写
+        std::atomic<detail::DependencyCounter*> last_dependency_{nullptr};
+    };
+
+    /**
+     * @class LazyRegistry
+     * @brief 进程内所有具名惰性单元的登记表
+     * @details
+     * 单元在构造时登记、析构时注销，登记表的互斥锁只在这两个时刻以及遍历时获取，
+     * 从不出现在 `get()` 路径上
+     * 登记表本身故意不析构，避免与全局惰性对象之间的析构顺序问题
+     */
+    class LazyRegistry
+    {
+    public:
+        /**
+         * @brief 获取全局登记表
+         */
+        static LazyRegistry& instance();
+
+        /**
+         * @brief 登记一个具名单元
+         * @details 统计信息由登记表持有，单元只保存一个裸指针，匿名单元的指针为空，不占用额外空间
+         * @param name 单元名称
+         * @return 该单元的统计信息，在调用 remove 之前一直有效
+         */
+        CellStats* add(std::string_view name);
+
+        /**
+         * @brief 注销一个单元
+         * @details
+         * 如果仍有归属于该单元的内存未释放，统计信息会被保留（但不再出现在列表中），
+         * 以便这些内存释放时仍能安全地记账；这些内存全部释放后，保留的统计信息在下一次
+         * remove 或 cells()（例如指标导出）时被丢弃
+         * @param stats add 返回的统计信息
+         */
+        void remove(const CellStats* stats);
+
+        /**
+         * @brief 获取当前已登记单元的列表
+         * @details 只在复制指针列表时持有登记表的锁，读取计数器时不持有任何锁
+         */
+        [[nodiscard]] std::vector<std::shared_ptr<const CellStats>> cells() const;
+
+        /**
+         * @brief 已注销但仍有未释放内存、因此被保留的单元数量
+         */
+        [[nodiscard]] std::size_t retired_count() const;
+
+        /**
+         * @brief 获取所有已登记单元的统计信息拷贝
+         */
+        [[nodiscard]] std::vector<CellSnapshot> snapshot() const;
+
+        /**
+         * @brief 为指定名称的单元设置采样策略
+         * @details 对已登记和之后登记的同名单元都生效
+         * @param name 单元名称
+         * @param policy 采样策略
+         */
+        void set_sampling(std::string_view name, const SamplingPolicy& policy);
+
+    private:
+        LazyRegistry() = default;
+
+        /**
+         * @brief 丢弃内存已全部释放的已注销单元，调用方持有 mtx_
+         */
+        void prune_retired() const;
+
+        mutable std::mutex mtx_;
+        std::vector<std::shared_ptr<CellStats>> cells_;
+        /// @brief 已注销但仍有未释放内存的单元，在只读的遍历中也会被清理
+        mutable std::vector<std::shared_ptr<CellStats>> retired_;
+        /// @brief 按名称设置的采样策略
+        std::map<std::string, SamplingPolicy, std::less<>> sampling_;
+    };
+
+    /**
+     * @brief 估算值占用的字节数，用于统计信息
+     * @details 默认返回 `sizeof(T)`，可以为自定义类型特化以计入堆内存
+     * @tparam T 值的类型
+     */
+    template <typename T>
+    struct ByteEstimator
+    {
+        std::size_t operator()(const T&) const noexcept { return sizeof(T); }
+    };
+
+    template <typename C, typename Tr, typename A>
+    struct ByteEstimator<std::basic_string<C, Tr, A>>
+    {
+        std::size_t operator()(const std::basic_string<C, Tr, A>& s) const noexcept
+        {
+            return sizeof(s) + s.capacity() * sizeof(C);
+        }
+    };
+
+    template <typename E, typename A>
+    struct ByteEstimator<std::vector<E, A>>
+    {
+        std::size_t operator()(const std::vector<E, A>& v) const noexcept
+        {
+            return sizeof(v) + v.capacity() * sizeof(E);
+        }
+    };
+}
@@ -0,0 +1,24 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#include "sampling.h"
+
+#if defined(__linux__)
+#include <time.h>
+#endif
+
+namespace components::sampling
+{
+    std::int64_t coarse_now_ns() noexcept
+    {
+#if defined(__linux__)
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return static_cast<std::int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+}
@@ -0,0 +1,76 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include "registry.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace components::sampling
+{
+    /// @brief 全局 1/N 采样参数
+    inline std::atomic<std::uint32_t> global_one_in{1};
+    /// @brief 全局采样周期（纳秒）
+    inline std::atomic<std::int64_t> global_period_ns{0};
+
+    /**
+     * @brief 设置全局采样策略，对没有单独设置策略的单元生效
+     */
+    inline void set_global(const SamplingPolicy& policy) noexcept
+    {
+        global_one_in.store(policy.one_in, std::memory_order_relaxed);
+        global_period_ns.store(policy.period.count(), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 获取全局采样策略
+     */
+    inline SamplingPolicy global() noexcept
+    {
+        SamplingPolicy policy;
+        policy.one_in = global_one_in.load(std::memory_order_relaxed);
+        policy.period = std::chrono::nanoseconds(global_period_ns.load(std::memory_order_relaxed));
+        return policy;
+    }
+
+    /**
+     * @brief 低精度但廉价的单调时钟（纳秒），只用于判断采样周期
+     */
+    std::int64_t coarse_now_ns() noexcept;
+
+    /**
+     * @brief 线程局部的 xorshift 伪随机数
+     */
+    inline std::uint64_t next_random() noexcept
+    {
+        thread_local std::uint64_t state = 0;
+        if (state == 0)
+            state = reinterpret_cast<std::uintptr_t>(&state) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    /**
+     * @brief 决定本次事件是否计时
+     * @param stats 单元的统计信息，其单独设置的策略优先于全局策略；按周期采样的截止时间也保存在这里
+     */
+    inline bool should_sample(CellStats& stats) noexcept
+    {
+        SamplingPolicy policy;
+        if (!stats.sampling(policy))
+            policy = global();
+
+        if (policy.one_in == 0)
+            return false;
+        if (policy.one_in > 1 && next_random() % policy.one_in != 0)
+            return false;
+        if (policy.period.count() > 0)
+            return stats.claim_sample_period(coarse_now_ns(), policy.period.count());
+        return true;
+    }
+}
@@ -0,0 +1,181 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include "hash.h"
+#include "once_call.h"
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace components
+{
+    /**
+     * @class SingleFlight
+     * @brief 合并同一个键上并发进行的调用，但不缓存结果
+     * @details
+     * 同一个键同时只有一次调用在执行，期间到达的调用者等待并共享它的结果或异常；
+     * 调用结束后键立即从进行中表里移除，之后的调用会重新执行
+     * 适用于刷新令牌、拉取最新快照等需要去重但不能记忆的场景，需要记忆时使用 LazyMap
+     *
+     * 每次调用对应一个 OnceCell，等待方式与 OnceCell 相同；
+     * 进行中表按键分片，每个分片一把锁，只在调用开始和结束时短暂持有
+     * @tparam K 键类型
+     * @tparam V 结果类型，必须可复制，每个调用者得到一份副本
+     * @tparam Hash 键的哈希函数
+     * @tparam KeyEqual 键的相等比较
+     */
+    template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+    class SingleFlight
+    {
+    public:
+        /**
+         * @brief 构造一个空的进行中表
+         * @param shard_count 分片数量，向上取整到 2 的幂
+         */
+        explicit SingleFlight(std::size_t shard_count = 16);
+
+        SingleFlight(const SingleFlight&) = delete;
+
+        SingleFlight& operator=(const SingleFlight&) = delete;
+
+        /**
+         * @brief 执行 fn，或者加入同一个键上正在进行的调用
+         * @tparam Fn 签名为 `V(const K&)` 或 `V()`
+         * @param key 键
+         * @param fn 执行函数，只有本次调用成为执行者时才会被调用
+         * @return 本次执行的结果
+         * @throws 执行函数抛出的异常，所有共享这次执行的调用者都会收到同一个异常
+         */
+        template <typename Fn>
+        V run(const K& key, Fn&& fn);
+
+        /**
+         * @brief 正在进行的调用数量
+         */
+        [[nodiscard]] std::size_t in_flight() const;
+
+    private:
+        /// @brief 一次执行的结果：值或异常
+        struct Outcome
+        {
+            std::optional<V> value;
+            std::exception_ptr error;
+        };
+
+        struct Call
+        {
+            OnceCell<Outcome> cell;
+        };
+
+        struct alignas(64) Shard
+        {
+            mutable std::mutex mtx;
+            std::unordered_map<K, std::shared_ptr<Call>, Hash, KeyEqual> calls;
+        };
+
+        Shard& shard_of(const K& key)
+        {
+            return shards_[detail::mix_hash(static_cast<std::uint64_t>(Hash{}(key))) & shard_mask_];
+        }
+
+        std::size_t shard_mask_;
+        std::unique_ptr<Shard[]> shards_;
+    };
+
+    // ---------------- 实现 ----------------
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    SingleFlight<K, V, Hash, KeyEqual>::SingleFlight(std::size_t shard_count)
+    {
+        std::size_t n = 1;
+        while (n < shard_count)
+            n <<= 1;
+        shard_mask_ = n - 1;
+        shards_.reset(new Shard[n]);
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    template <typename Fn>
+    V SingleFlight<K, V, Hash, KeyEqual>::run(const K& key, Fn&& fn)
+    {
+        Shard& shard = shard_of(key);
+        std::shared_ptr<Call> call;
+        bool owner = false;
+        {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            if (auto it = shard.calls.find(key); it != shard.calls.end())
+            {
+                call = it->second;
+            }
+            else
+            {
+                // 先创建调用再插入，分配失败时表中不会留下空指针
+                call = std::make_shared<Call>();
+                shard.calls.emplace(key, call);
+                owner = true;
+            }
+        }
+
+        // 执行者在任何退出路径上（包括 get_or_init 本身抛出异常）都移除自己插入的调用，
+        // 否则键会一直留在表中，之后的调用者拿到的是过期的结果
+        struct EraseGuard
+        {
+            ~EraseGuard()
+            {
+                if (!call)
+                    return;
+                std::lock_guard<std::mutex> lock(shard->mtx);
+                if (auto it = shard->calls.find(*key); it != shard->calls.end() && it->second.get() == call)
+                    shard->calls.erase(it);
+            }
+
+            Shard* shard;
+            const K* key;
+            const Call* call;
+        };
+        EraseGuard guard{&shard, &key, owner ? call.get() : nullptr};
+
+        // 异常作为结果的一部分保存下来，单元本身总是初始化成功，等待者不会接手重新执行
+        const Outcome& outcome = call->cell.get_or_init([&]() -> Outcome {
+            Outcome o;
+            try
+            {
+                if constexpr (std::is_invocable_v<Fn&, const K&>)
+                    o.value.emplace(fn(key));
+                else
+                    o.value.emplace(fn());
+            }
+            catch (...)
+            {
+                o.error = std::current_exception();
+            }
+            return o;
+        });
+
+        if (outcome.error)
+            std::rethrow_exception(outcome.error);
+        return *outcome.value;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    std::size_t SingleFlight<K, V, Hash, KeyEqual>::in_flight() const
+    {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i <= shard_mask_; ++i)
+        {
+            std::lock_guard<std::mutex> lock(shards_[i].mtx);
+            n += shards_[i].calls.size();
+        }
+        return n;
+    }
+}
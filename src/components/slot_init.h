@@ -0,0 +1,70 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include "instrument.h"
+#include "wait_table.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace components::detail
+{
+    /**
+     * @brief 用两个原子位（已认领、已初始化）保护一个槽位的一次性初始化
+     * @details
+     * 供不为每个槽位单独携带互斥锁的容器使用（LazyArray、LazyFields 等）：
+     * 第一个设置认领位的线程执行 construct，成功后设置初始化位；
+     * 其余线程停在条带化等待表上，直到槽位初始化完成或认领位被清除
+     * construct 抛出异常时清除认领位、唤醒等待者并重新抛出，等待者之一会重新尝试
+     * 各槽位共享一份统计信息：每个槽位计为一次初始化（不计为 reload），估算字节数累加，
+     * 同时进行的多个槽位初始化按计数跟踪
+     *
+     * 两个位可以在同一个字里，也可以在不同的字里
+     * 调用方应先用 acquire 读取初始化位完成快速路径，只在未初始化时调用本函数
+     * @param key 等待表的键，通常是槽位值的地址
+     * @param stats 统计信息，匿名时为空
+     * @param construct 在槽位上构造值，返回估算的字节数
+     * @throws construct 抛出的异常；LazyInitError 检查模式下发现重入或初始化死锁时抛出
+     */
+    template <typename Construct>
+    void init_slot_once(const void* key, CellStats* stats, std::atomic<std::uint64_t>& claimed,
+                        std::uint64_t claimed_bit, std::atomic<std::uint64_t>& ready, std::uint64_t ready_bit,
+                        Construct&& construct)
+    {
+        check_reentry(key, stats);
+        for (;;)
+        {
+            if (!(claimed.fetch_or(claimed_bit, std::memory_order_acq_rel) & claimed_bit))
+            {
+                // 认领成功：只有初始化失败才会清除认领位，因此此时槽位一定未初始化
+                try
+                {
+                    InitScope scope(key, stats, true);
+                    const std::size_t bytes = construct();
+                    ready.fetch_or(ready_bit, std::memory_order_release);
+                    scope.succeed(bytes);
+                }
+                catch (...)
+                {
+                    claimed.fetch_and(~claimed_bit, std::memory_order_release);
+                    unpark_all(key);
+                    throw;
+                }
+                unpark_all(key);
+                return;
+            }
+            if (ready.load(std::memory_order_acquire) & ready_bit)
+                return;
+
+            WaitScope wait(key, stats);
+            park(key, [&] {
+                return (ready.load(std::memory_order_acquire) & ready_bit) ||
+                    !(claimed.load(std::memory_order_acquire) & claimed_bit);
+            });
+            // 被唤醒时要么已初始化，要么初始化失败、认领位已清除，回到开头重新尝试
+        }
+    }
+}
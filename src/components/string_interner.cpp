@@ -0,0 +1,158 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#include "string_interner.h"
+
+#include "hash.h"
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace components
+{
+    namespace
+    {
+        constexpr std::size_t kInitialCapacity = 64;
+        constexpr std::size_t kBlockBytes = 64 * 1024;
+
+        std::uint64_t hash_of(std::string_view s)
+        {
+            return detail::mix_hash(static_cast<std::uint64_t>(std::hash<std::string_view>{}(s)));
+        }
+    }
+
+    StringInterner::~StringInterner()
+    {
+        for (auto& shard : shards_)
+        {
+            for (Table* t = shard.table.load(std::memory_order_relaxed); t;)
+                delete std::exchange(t, t->prev);
+            for (Block* b = shard.blocks; b;)
+                delete std::exchange(b, b->next);
+        }
+    }
+
+    StringInterner& StringInterner::global()
+    {
+        // 与登记表相同，故意泄漏：静态析构阶段的代码仍可能持有或查询驻留的字符串
+        static auto* interner = new StringInterner();
+        return *interner;
+    }
+
+    std::optional<StringInterner::Id> StringInterner::probe(const Table* table, std::uint64_t hash,
+                                                            std::string_view s) const
+    {
+        if (!table)
+            return std::nullopt;
+        for (std::size_t i = hash & table->mask;; i = (i + 1) & table->mask)
+        {
+            const Slot& slot = table->slots[i];
+            const std::uint32_t id = slot.id.load(std::memory_order_acquire);
+            if (id == 0)
+                return std::nullopt;
+            if (slot.hash.load(std::memory_order_relaxed) == hash && strings_[id - 1] == s)
+                return id - 1;
+        }
+    }
+
+    std::optional<StringInterner::Id> StringInterner::find(std::string_view s) const
+    {
+        const std::uint64_t hash = hash_of(s);
+        const Shard& shard = shards_[(hash >> 32) % kShards];
+        return probe(shard.table.load(std::memory_order_acquire), hash, s);
+    }
+
+    StringInterner::Id StringInterner::intern(std::string_view s)
+    {
+        const std::uint64_t hash = hash_of(s);
+        Shard& shard = shards_[(hash >> 32) % kShards];
+        if (auto id = probe(shard.table.load(std::memory_order_acquire), hash, s))
+            return *id;
+
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        Table* table = shard.table.load(std::memory_order_relaxed);
+        // 其他线程可能在我们加锁之前驻留了同一个字符串
+        if (auto id = probe(table, hash, s))
+            return *id;
+
+        if (!table || (shard.count + 1) * 2 > table->mask + 1)
+        {
+            auto* grown = new Table(table ? (table->mask + 1) * 2 : kInitialCapacity, table);
+            if (table)
+            {
+                for (std::size_t i = 0; i <= table->mask; ++i)
+                {
+                    const Slot& slot = table->slots[i];
+                    if (const std::uint32_t id = slot.id.load(std::memory_order_relaxed))
+                        place(*grown, slot.hash.load(std::memory_order_relaxed), id - 1);
+                }
+            }
+            table = grown;
+            shard.table.store(table, std::memory_order_release);
+        }
+
+        if (strings_.size() >= std::numeric_limits<Id>::max())
+            throw std::length_error("StringInterner: id space exhausted");
+        // 先写入 id 到字符串的映射，再发布到索引，读取者看到槽位时 view(id) 一定可用
+        const auto id = static_cast<Id>(strings_.push_back(store(shard, s)));
+        place(*table, hash, id);
+        shard.count++;
+        return id;
+    }
+
+    std::size_t StringInterner::arena_bytes() const
+    {
+        std::size_t n = 0;
+        for (auto& shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            n += shard.arena_bytes;
+        }
+        return n;
+    }
+
+    std::string_view StringInterner::store(Shard& shard, std::string_view s)
+    {
+        if (s.empty())
+            return {};
+        char* dst;
+        // 较长的字符串单独分配，避免浪费当前块剩余的空间
+        if (s.size() > kBlockBytes / 4)
+        {
+            dst = allocate_block(shard, s.size());
+        }
+        else
+        {
+            if (shard.remaining < s.size())
+            {
+                shard.cursor = allocate_block(shard, kBlockBytes);
+                shard.remaining = kBlockBytes;
+            }
+            dst = shard.cursor;
+            shard.cursor += s.size();
+            shard.remaining -= s.size();
+        }
+        std::memcpy(dst, s.data(), s.size());
+        return {dst, s.size()};
+    }
+
+    char* StringInterner::allocate_block(Shard& shard, std::size_t bytes)
+    {
+        std::unique_ptr<char[]> data(new char[bytes]);
+        shard.blocks = new Block{shard.blocks, std::move(data)};
+        shard.arena_bytes += bytes;
+        return shard.blocks->bytes.get();
+    }
+
+    void StringInterner::place(Table& table, std::uint64_t hash, Id id)
+    {
+        std::size_t i = hash & table.mask;
+        while (table.slots[i].id.load(std::memory_order_relaxed))
+            i = (i + 1) & table.mask;
+        table.slots[i].hash.store(hash, std::memory_order_relaxed);
+        table.slots[i].id.store(id + 1, std::memory_order_release);
+    }
+}
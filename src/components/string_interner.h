@@ -0,0 +1,145 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include "append_only_vec.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+
+namespace components
+{
+    /**
+     * @class StringInterner
+     * @brief 并发字符串驻留表：相同的字符串得到相同的稠密整数 id 和稳定的 string_view
+     * @details
+     * - 查找已存在的字符串不加锁：按哈希值选择分片，在分片当前的开放寻址表中探测，
+     *   槽位同时存放哈希值和 id，只在哈希值相同时才比较字符串内容；
+     * - 插入新字符串时持有分片锁并重新检查，同一个字符串的并发插入只有一个生效，其余返回同一个 id；
+     * - 字符串内容复制到分片自己的内存块（arena）中，返回的 string_view 在驻留表析构之前一直有效；
+     * - id 从 0 开始连续分配，id 到字符串的映射存放在 AppendOnlyVec 中，按 id 读取也不加锁
+     *
+     * 默认构造是 constexpr 且不分配内存（分片只持有原始指针，所有权在析构函数中处理），
+     * 全局实例常量初始化，没有启动开销和初始化顺序问题；
+     * 需要在静态析构阶段仍可使用时，使用故意泄漏的 global()
+     */
+    class StringInterner
+    {
+    public:
+        using Id = std::uint32_t;
+
+        constexpr StringInterner() noexcept = default;
+
+        ~StringInterner();
+
+        StringInterner(const StringInterner&) = delete;
+
+        StringInterner& operator=(const StringInterner&) = delete;
+
+        /**
+         * @brief 进程级的驻留表，故意泄漏，静态析构阶段仍可安全使用
+         */
+        static StringInterner& global();
+
+        /**
+         * @brief 驻留字符串
+         * @return 字符串的 id，已存在时返回已有的 id
+         */
+        Id intern(std::string_view s);
+
+        /**
+         * @brief 查找已驻留的字符串，不会插入，也不会加锁
+         */
+        [[nodiscard]] std::optional<Id> find(std::string_view s) const;
+
+        /**
+         * @brief 获取 id 对应的字符串
+         * @param id 必须是 intern 返回的 id
+         */
+        [[nodiscard]] std::string_view view(Id id) const { return strings_[id]; }
+
+        /**
+         * @brief 驻留并返回稳定的 string_view
+         */
+        std::string_view intern_view(std::string_view s) { return view(intern(s)); }
+
+        /**
+         * @brief 已驻留的字符串数量
+         */
+        [[nodiscard]] std::size_t size() const { return strings_.size(); }
+
+        /**
+         * @brief 内存块占用的字节数（不含索引）
+         */
+        [[nodiscard]] std::size_t arena_bytes() const;
+
+    private:
+        struct Slot
+        {
+            std::atomic<std::uint64_t> hash{0};
+            /// @brief id + 1，0 表示空槽位；在 hash 之后发布
+            std::atomic<std::uint32_t> id{0};
+        };
+
+        struct Table
+        {
+            Table(std::size_t capacity, Table* prev) : mask(capacity - 1), slots(new Slot[capacity]), prev(prev)
+            {
+            }
+
+            const std::size_t mask;
+            std::unique_ptr<Slot[]> slots;
+            /// @brief 扩容前的旧表，驻留表析构时才释放：并发的读取者可能仍在旧表上探测
+            Table* prev;
+        };
+
+        /// @brief 内存块，字符串内容的存放位置
+        struct Block
+        {
+            Block* next;
+            std::unique_ptr<char[]> bytes;
+        };
+
+        struct alignas(64) Shard
+        {
+            std::atomic<Table*> table{nullptr};
+
+            // 以下字段只在持有 mtx 时访问
+            std::mutex mtx;
+            std::size_t count = 0;
+            Block* blocks = nullptr;
+            char* cursor = nullptr;
+            std::size_t remaining = 0;
+            std::size_t arena_bytes = 0;
+        };
+
+        static constexpr std::size_t kShards = 64;
+
+        std::optional<Id> probe(const Table* table, std::uint64_t hash, std::string_view s) const;
+
+        /**
+         * @brief 把字符串复制到分片的内存块中，调用方持有分片锁
+         */
+        static std::string_view store(Shard& shard, std::string_view s);
+
+        /**
+         * @brief 为分片分配一个新的内存块，调用方持有分片锁
+         */
+        static char* allocate_block(Shard& shard, std::size_t bytes);
+
+        /**
+         * @brief 把 id 放入表中的空槽位，调用方持有分片锁
+         */
+        static void place(Table& table, std::uint64_t hash, Id id);
+
+        mutable std::array<Shard, kShards> shards_{};
+        AppendOnlyVec<std::string_view> strings_;
+    };
+}
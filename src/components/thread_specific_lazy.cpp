@@ -0,0 +1,92 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#include "thread_specific_lazy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace components::detail
+{
+    namespace
+    {
+        struct IndexPool
+        {
+            std::mutex mtx;
+            std::size_t next = 0;
+            std::vector<std::size_t> free;
+        };
+
+        IndexPool& index_pool()
+        {
+            // 与登记表相同，故意泄漏：静态对象的析构函数中仍可能归还下标
+            static auto* pool = new IndexPool();
+            return *pool;
+        }
+
+        /**
+         * @brief 线程退出时释放本线程的槽位表
+         */
+        struct TlsTableReaper
+        {
+            ~TlsTableReaper()
+            {
+                delete[] std::exchange(tls_entries, nullptr);
+                tls_capacity = 0;
+            }
+        };
+    }
+
+    std::size_t acquire_tls_index()
+    {
+        IndexPool& pool = index_pool();
+        std::lock_guard<std::mutex> lock(pool.mtx);
+        if (pool.free.empty())
+            return pool.next++;
+        const std::size_t index = pool.free.back();
+        pool.free.pop_back();
+        return index;
+    }
+
+    void release_tls_index(std::size_t index) noexcept
+    {
+        IndexPool& pool = index_pool();
+        std::lock_guard<std::mutex> lock(pool.mtx);
+        try
+        {
+            pool.free.push_back(index);
+        }
+        catch (...)
+        {
+            // 内存不足时放弃复用这个下标
+        }
+    }
+
+    std::uint64_t next_tls_serial() noexcept
+    {
+        static std::atomic<std::uint64_t> serial{0};
+        return serial.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    TlsEntry& tls_entry_slow(std::size_t index)
+    {
+        if (index >= tls_capacity)
+        {
+            if (!tls_entries)
+            {
+                thread_local TlsTableReaper reaper;
+                (void)reaper;
+            }
+            const std::size_t capacity = std::max<std::size_t>({16, tls_capacity * 2, index + 1});
+            auto* grown = new TlsEntry[capacity]();
+            std::copy(tls_entries, tls_entries + tls_capacity, grown);
+            delete[] std::exchange(tls_entries, grown);
+            tls_capacity = capacity;
+        }
+        return tls_entries[index];
+    }
+}
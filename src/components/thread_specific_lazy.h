@@ -0,0 +1,238 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace components
+{
+    namespace detail
+    {
+        /**
+         * @brief 线程局部槽位表中的一项：某个 ThreadSpecificLazy 在本线程的实例
+         */
+        struct TlsEntry
+        {
+            void* node;
+            /// @brief 所属对象的序号，0 表示空；对象析构或清空后序号失效，槽位下标可以被复用
+            std::uint64_t serial;
+        };
+
+        /// @brief 本线程的槽位表，按 ThreadSpecificLazy 的槽位下标索引
+        /// 平凡类型、常量初始化，访问时没有线程局部变量的初始化检查
+        inline thread_local TlsEntry* tls_entries = nullptr;
+        inline thread_local std::size_t tls_capacity = 0;
+
+        /**
+         * @brief 分配一个槽位下标，对象析构时通过 release_tls_index 归还
+         */
+        std::size_t acquire_tls_index();
+
+        /**
+         * @brief 归还槽位下标
+         */
+        void release_tls_index(std::size_t index) noexcept;
+
+        /**
+         * @brief 分配一个进程内唯一、非 0 的序号
+         */
+        std::uint64_t next_tls_serial() noexcept;
+
+        /**
+         * @brief 确保本线程的槽位表能容纳 index，返回对应的项
+         * @details 第一次扩容时登记线程退出回调，线程退出时只释放槽位表本身，不触碰各对象的实例
+         */
+        TlsEntry& tls_entry_slow(std::size_t index);
+    }
+
+    /**
+     * @class ThreadSpecificLazy
+     * @brief 可枚举的线程局部惰性值，类似 TBB 的 enumerable_thread_specific
+     * @details
+     * 每个线程第一次调用 local() 时创建自己的实例，此后的访问只读取本线程的槽位表，开销与读取 thread_local 变量相当；
+     * 与 `THREAD_LOCAL_LAZY` 不同，所有实例都挂在对象的无锁链表上：
+     * - for_each() / combine() 可以访问或归约所有线程的实例，例如汇总每个线程的计数器、合并每个线程的直方图；
+     * - 线程退出后实例仍然保留，直到 clear() 或对象析构时才销毁，已退出线程的数据不会丢失
+     *
+     * 实例只应由创建它的线程修改；在其他线程上调用 for_each() / combine() 时，
+     * 调用方需要保证与各线程的修改同步（例如在 join 之后），或者 T 本身线程安全
+     * @tparam T 每个线程持有的数据类型
+     */
+    template <typename T>
+    class ThreadSpecificLazy
+    {
+    public:
+        using InitFn = std::function<T()>;
+
+        /**
+         * @brief 构造一个可枚举的线程局部惰性值
+         * @param init_fn 每个线程第一次访问时调用的初始化函数
+         */
+        explicit ThreadSpecificLazy(InitFn init_fn);
+
+        /**
+         * @brief 销毁所有线程的实例
+         * @warning 不能与任何线程上的 local() 并发
+         */
+        ~ThreadSpecificLazy();
+
+        ThreadSpecificLazy(const ThreadSpecificLazy&) = delete;
+
+        ThreadSpecificLazy& operator=(const ThreadSpecificLazy&) = delete;
+
+        /**
+         * @brief 获取本线程的实例，如果尚未创建，则先进行初始化
+         * @return 值的引用，在 clear() 或对象析构之前有效
+         */
+        T& local()
+        {
+            if (index_ < detail::tls_capacity)
+            {
+                const detail::TlsEntry& e = detail::tls_entries[index_];
+                if (e.serial == serial_)
+                    return static_cast<Node*>(e.node)->value;
+            }
+            return local_slow();
+        }
+
+        /**
+         * @brief 等同于 local()
+         */
+        T& operator*() { return local(); }
+
+        /**
+         * @brief 等同于 &local()
+         */
+        T* operator->() { return &local(); }
+
+        /**
+         * @brief 访问所有线程的实例（包括已退出的线程），不会创建新实例
+         * @details 遍历期间新创建的实例可能被访问也可能不被访问
+         * @param fn 签名为 `void(T&)`
+         */
+        template <typename Fn>
+        void for_each(Fn&& fn);
+
+        /**
+         * @brief for_each 的只读版本
+         * @param fn 签名为 `void(const T&)`
+         */
+        template <typename Fn>
+        void for_each(Fn&& fn) const;
+
+        /**
+         * @brief 用二元操作归约所有线程的实例
+         * @param op 签名为 `T(const T&, const T&)`
+         * @return 归约结果；没有任何实例时返回初始化函数的结果
+         */
+        template <typename Op>
+        T combine(Op&& op) const;
+
+        /**
+         * @brief 已创建的实例数量
+         */
+        [[nodiscard]] std::size_t size() const { return size_.load(std::memory_order_acquire); }
+
+        /**
+         * @brief 销毁所有线程的实例，各线程下一次访问时重新初始化
+         * @warning 不能与任何线程上的 local()、for_each() 并发，通常在所有工作线程结束之后调用
+         */
+        void clear();
+
+    private:
+        struct Node
+        {
+            explicit Node(const InitFn& init_fn) : value(init_fn())
+            {
+            }
+
+            T value;
+            Node* next = nullptr;
+        };
+
+        T& local_slow();
+
+        std::size_t index_;
+        std::uint64_t serial_;
+        InitFn init_fn_;
+        std::atomic<Node*> head_{nullptr};
+        std::atomic<std::size_t> size_{0};
+    };
+
+    // ---------------- 实现 ----------------
+
+    template <typename T>
+    ThreadSpecificLazy<T>::ThreadSpecificLazy(InitFn init_fn)
+        : index_(detail::acquire_tls_index()), serial_(detail::next_tls_serial()), init_fn_(std::move(init_fn))
+    {
+    }
+
+    template <typename T>
+    ThreadSpecificLazy<T>::~ThreadSpecificLazy()
+    {
+        clear();
+        detail::release_tls_index(index_);
+    }
+
+    template <typename T>
+    T& ThreadSpecificLazy<T>::local_slow()
+    {
+        auto* node = new Node(init_fn_);
+        node->next = head_.load(std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+        size_.fetch_add(1, std::memory_order_release);
+
+        detail::TlsEntry& e = detail::tls_entry_slow(index_);
+        e.node = node;
+        e.serial = serial_;
+        return node->value;
+    }
+
+    template <typename T>
+    template <typename Fn>
+    void ThreadSpecificLazy<T>::for_each(Fn&& fn)
+    {
+        for (Node* n = head_.load(std::memory_order_acquire); n; n = n->next)
+            fn(n->value);
+    }
+
+    template <typename T>
+    template <typename Fn>
+    void ThreadSpecificLazy<T>::for_each(Fn&& fn) const
+    {
+        for (const Node* n = head_.load(std::memory_order_acquire); n; n = n->next)
+            fn(static_cast<const T&>(n->value));
+    }
+
+    template <typename T>
+    template <typename Op>
+    T ThreadSpecificLazy<T>::combine(Op&& op) const
+    {
+        const Node* n = head_.load(std::memory_order_acquire);
+        if (!n)
+            return init_fn_();
+        T result = n->value;
+        for (n = n->next; n; n = n->next)
+            result = op(static_cast<const T&>(result), static_cast<const T&>(n->value));
+        return result;
+    }
+
+    template <typename T>
+    void ThreadSpecificLazy<T>::clear()
+    {
+        Node* n = head_.exchange(nullptr, std::memory_order_acq_rel);
+        while (n)
+            delete std::exchange(n, n->next);
+        size_.store(0, std::memory_order_release);
+        // 换一个序号，各线程槽位表中指向已销毁实例的项随之失效
+        serial_ = detail::next_tls_serial();
+    }
+}
@@ -0,0 +1,41 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#include "wait_table.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace components::detail
+{
+    namespace
+    {
+        constexpr std::size_t kStripeBits = 7;
+        constexpr std::size_t kStripes = std::size_t{1} << kStripeBits;
+
+        WaitStripe* stripes()
+        {
+            // 与登记表相同，故意泄漏：静态初始化和析构阶段的惰性对象也可能在这里等待
+            static auto* table = new WaitStripe[kStripes];
+            return table;
+        }
+    }
+
+    WaitStripe& wait_stripe(const void* key) noexcept
+    {
+        // Fibonacci 散列，取高位作为条带下标
+        const auto h = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(key)) * 0x9e3779b97f4a7c15ULL;
+        return stripes()[h >> (64 - kStripeBits)];
+    }
+
+    void unpark_all(const void* key)
+    {
+        WaitStripe& stripe = wait_stripe(key);
+        {
+            // 持锁一次，保证在检查条件与开始等待之间的线程能看到状态变化
+            std::lock_guard<std::mutex> lock(stripe.mtx);
+        }
+        stripe.cv.notify_all();
+    }
+}
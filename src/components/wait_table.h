@@ -0,0 +1,47 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+
+namespace components::detail
+{
+    /**
+     * @brief 全局等待表的一个条带，独占一条缓存行
+     */
+    struct alignas(64) WaitStripe
+    {
+        std::mutex mtx;
+        std::condition_variable cv;
+    };
+
+    /**
+     * @brief 按等待对象的地址选择条带
+     * @details
+     * 大量惰性槽位共享一张固定大小的等待表，槽位本身不需要携带互斥锁或条件变量；
+     * 不同对象可能落在同一个条带上，被误唤醒的等待者会重新检查条件后继续等待
+     * @param key 等待对象的地址，只用于散列，不会被解引用
+     */
+    WaitStripe& wait_stripe(const void* key) noexcept;
+
+    /**
+     * @brief 阻塞当前线程，直到 ready() 返回 true
+     * @details 在条带锁内检查条件，配合 unpark_all 不会丢失唤醒
+     */
+    template <typename Pred>
+    void park(const void* key, Pred ready)
+    {
+        WaitStripe& stripe = wait_stripe(key);
+        std::unique_lock<std::mutex> lock(stripe.mtx);
+        stripe.cv.wait(lock, ready);
+    }
+
+    /**
+     * @brief 唤醒等待 key 的所有线程
+     * @details 必须在改变 park 所检查的状态之后调用
+     */
+    void unpark_all(const void* key);
+}
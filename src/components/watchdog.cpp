@@ -0,0 +1,118 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#include "watchdog.h"
+#include "registry.h"
+
+#include <iostream>
+
+namespace components
+{
+    namespace
+    {
+        std::int64_t now_ns()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+    }
+
+    InitWatchdog::InitWatchdog() : InitWatchdog(Options{})
+    {
+    }
+
+    InitWatchdog::InitWatchdog(Options options) : options_(std::move(options))
+    {
+        thread_ = std::thread([this] { run(); });
+    }
+
+    InitWatchdog::~InitWatchdog()
+    {
+        stop();
+    }
+
+    void InitWatchdog::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    std::vector<StuckInit> InitWatchdog::scan() const
+    {
+        std::vector<StuckInit> result;
+        const std::int64_t now = now_ns();
+        const std::chrono::steady_clock::time_point now_tp{std::chrono::nanoseconds(now)};
+
+        std::lock_guard<std::mutex> lock(seen_mtx_);
+        decltype(first_seen_) seen;
+        for (const auto& stats : LazyRegistry::instance().cells())
+        {
+            auto s = stats->snapshot();
+            if (!s.initializing)
+                continue;
+
+            std::chrono::steady_clock::time_point started{std::chrono::nanoseconds(s.init_started_ns)};
+            if (s.init_started_ns == 0)
+            {
+                // 未被采样计时，只能从第一次观察到它开始计算
+                auto key = std::make_pair(static_cast<const void*>(stats.get()), s.init_count + s.failure_count);
+                auto it = first_seen_.find(key);
+                started = it != first_seen_.end() ? it->second : now_tp;
+                seen.emplace(key, started);
+            }
+
+            auto budget = options_.budget;
+            if (auto it = options_.budgets.find(s.name); it != options_.budgets.end())
+                budget = it->second;
+
+            auto elapsed = now_tp - started;
+            if (elapsed < budget)
+                continue;
+            result.push_back(StuckInit{s.name, s.init_thread, started, elapsed, s.waiters});
+        }
+        first_seen_ = std::move(seen);
+        return result;
+    }
+
+    void InitWatchdog::run()
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        while (!cv_.wait_for(lock, options_.interval, [this] { return stopping_; }))
+        {
+            lock.unlock();
+            auto stuck = scan();
+            lock.lock();
+
+            std::set<std::pair<std::string, std::chrono::steady_clock::time_point>> still_stuck;
+            for (const auto& s : stuck)
+            {
+                auto key = std::make_pair(s.name, s.started);
+                still_stuck.insert(key);
+                if (reported_.count(key))
+                    continue;
+                lock.unlock();
+                report(s);
+                lock.lock();
+            }
+            reported_ = std::move(still_stuck);
+        }
+    }
+
+    void InitWatchdog::report(const StuckInit& stuck) const
+    {
+        if (options_.on_stuck)
+        {
+            options_.on_stuck(stuck);
+            return;
+        }
+        std::cerr << "[cxxlazy] lazy '" << stuck.name << "' has been initializing for "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(stuck.elapsed).count()
+            << " ms on thread " << stuck.thread << ", " << stuck.waiters << " waiter(s) blocked\n";
+    }
+}
@@ -0,0 +1,114 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace components
+{
+    /**
+     * @brief 一次超出预算的初始化
+     */
+    struct StuckInit
+    {
+        /// @brief 单元名称
+        std::string name;
+        /// @brief 正在执行初始化函数的线程
+        std::thread::id thread;
+        /// @brief 初始化开始的时间；未被采样计时的初始化为看门狗第一次观察到它的时间
+        std::chrono::steady_clock::time_point started;
+        /// @brief 初始化已经持续的时间
+        std::chrono::nanoseconds elapsed{0};
+        /// @brief 当前阻塞等待该单元的线程数
+        std::uint32_t waiters = 0;
+    };
+
+    /**
+     * @class InitWatchdog
+     * @brief 监视卡在初始化状态的具名单元
+     * @details
+     * 后台线程周期性地通过 LazyRegistry 读取各单元的初始化状态，不在 `get()` 路径上增加任何操作
+     * 某个单元的初始化超出预算时，报告其名称、初始化线程、已耗时间和等待线程数，
+     * 每次初始化只报告一次
+     * 未设置回调时报告写到标准错误输出
+     */
+    class InitWatchdog
+    {
+    public:
+        using Callback = std::function<void(const StuckInit&)>;
+
+        /**
+         * @brief 看门狗配置
+         */
+        struct Options
+        {
+            /// @brief 默认的初始化时间预算
+            std::chrono::milliseconds budget{std::chrono::seconds(5)};
+            /// @brief 扫描间隔
+            std::chrono::milliseconds interval{std::chrono::seconds(1)};
+            /// @brief 按单元名称覆盖的预算
+            std::map<std::string, std::chrono::milliseconds> budgets;
+            /// @brief 超出预算时调用的回调，例如转储卡住线程的调用栈
+            Callback on_stuck;
+        };
+
+        /**
+         * @brief 使用默认配置启动看门狗线程
+         */
+        InitWatchdog();
+
+        /**
+         * @brief 启动看门狗线程
+         * @param options 看门狗配置
+         */
+        explicit InitWatchdog(Options options);
+
+        InitWatchdog(const InitWatchdog&) = delete;
+
+        InitWatchdog& operator=(const InitWatchdog&) = delete;
+
+        /**
+         * @brief 停止并等待看门狗线程退出
+         */
+        ~InitWatchdog();
+
+        /**
+         * @brief 停止看门狗线程，可以重复调用
+         */
+        void stop();
+
+        /**
+         * @brief 立即扫描一次，不区分是否已经报告过
+         * @return 当前所有超出预算的初始化
+         */
+        [[nodiscard]] std::vector<StuckInit> scan() const;
+
+    private:
+        void run();
+
+        void report(const StuckInit& stuck) const;
+
+        Options options_;
+        /// @brief 已经报告过的初始化，以（名称，开始时间）区分
+        std::set<std::pair<std::string, std::chrono::steady_clock::time_point>> reported_;
+        /// @brief 未被采样计时的初始化第一次被观察到的时间，以（单元，第几次初始化）区分
+        mutable std::map<std::pair<const void*, std::uint64_t>, std::chrono::steady_clock::time_point> first_seen_;
+        mutable std::mutex seen_mtx_;
+        std::mutex mtx_;
+        std::condition_variable cv_;
+        bool stopping_ = false;
+        std::thread thread_;
+    };
+}
@@ -0,0 +1,177 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/access_trace.h>
+#include <cxxlazy/components/lazy.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+/**
+ * @brief 统计某个单元某种事件的数量
+ */
+std::size_t count_events(const trace::Trace& t, std::uint32_t cell, trace::AccessKind kind)
+{
+    std::size_t n = 0;
+    for (const auto& e : t.events)
+        n += e.cell == cell && e.kind == kind;
+    return n;
+}
+
+/**
+ * @brief 测试访问追踪的记录和读取。
+ *
+ * 验证：
+ * 1. 命中、初始化、失败、重置事件都被记录，Init 带有耗时和字节数。
+ * 2. 追踪开始前已初始化的单元和之后新建的单元都出现在名称表中，匿名单元不被记录。
+ * 3. 多个线程的事件按时间戳合并，缓冲区足够大时没有事件被丢弃。
+ * 4. 追踪关闭后不再记录。
+ */
+void test_record_and_read()
+{
+    const std::string path = "access_trace_test.bin";
+    Lazy<int> early("early", [] { return 1; });
+    *early;
+
+    assert(trace::start(path, 256));
+    assert(!trace::start(path));
+
+    int attempts = 0;
+    Lazy<std::string> value("value", [&] {
+        if (++attempts == 1)
+            throw std::runtime_error("first attempt fails");
+        return std::string(100, 'x');
+    });
+    Lazy<int> anonymous([] { return 3; });
+    try
+    {
+        *value;
+        assert(false);
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+    *value;
+    for (int i = 0; i < 20; ++i)
+        *value;
+    *early;
+    *anonymous;
+    value.reset();
+
+    std::thread other([&] {
+        for (int i = 0; i < 30; ++i)
+            *early;
+    });
+    other.join();
+    trace::stop();
+    *early;
+
+    std::ifstream in(path, std::ios::binary);
+    trace::Trace t;
+    assert(trace::read(in, t));
+    std::remove(path.c_str());
+
+    const std::uint32_t early_id = early.stats()->id();
+    const std::uint32_t value_id = value.stats()->id();
+    bool saw_early = false, saw_value = false;
+    for (const auto& cell : t.cells)
+    {
+        saw_early |= cell.id == early_id && cell.name == "early";
+        saw_value |= cell.id == value_id && cell.name == "value";
+    }
+    assert(saw_early && saw_value);
+    assert(t.cells.size() >= 2);
+
+    assert(count_events(t, value_id, trace::AccessKind::Failure) == 1);
+    assert(count_events(t, value_id, trace::AccessKind::Init) == 1);
+    assert(count_events(t, value_id, trace::AccessKind::Hit) == 20);
+    assert(count_events(t, value_id, trace::AccessKind::Reset) == 1);
+    assert(count_events(t, early_id, trace::AccessKind::Hit) == 31);
+    assert(t.events.size() == 54);
+    assert(trace::dropped_events() == 0);
+
+    bool two_threads = false;
+    for (std::size_t i = 0; i < t.events.size(); ++i)
+    {
+        const auto& e = t.events[i];
+        assert(i == 0 || t.events[i - 1].timestamp_ns <= e.timestamp_ns);
+        two_threads |= e.thread != t.events[0].thread;
+        if (e.kind == trace::AccessKind::Init)
+            assert(e.bytes >= 100 && e.duration_ns > 0);
+    }
+    assert(two_threads);
+    std::cout << "[OK] test_record_and_read" << std::endl;
+}
+
+/**
+ * @brief 测试缓冲区写满时的行为。
+ *
+ * 验证：
+ * 1. 记录事件的线程不写文件：缓冲区写满后新事件被丢弃并计数，写出的与丢弃的合计等于产生的事件数。
+ * 2. 刷写线程在追踪期间把缓冲区写出，两次突发之间留出时间时不会丢弃事件。
+ */
+void test_overflow_and_flusher()
+{
+    const std::string path = "access_trace_overflow.bin";
+    Lazy<int> cell("overflow", [] { return 1; });
+    *cell;
+
+    assert(trace::start(path, 4));
+    for (int i = 0; i < 1000; ++i)
+        *cell;
+    trace::stop();
+    {
+        std::ifstream in(path, std::ios::binary);
+        trace::Trace t;
+        assert(trace::read(in, t));
+        assert(trace::dropped_events() > 0);
+        assert(t.events.size() + trace::dropped_events() == 1000);
+    }
+
+    assert(trace::start(path, 64));
+    for (int burst = 0; burst < 5; ++burst)
+    {
+        for (int i = 0; i < 48; ++i)
+            *cell;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    trace::stop();
+    {
+        std::ifstream in(path, std::ios::binary);
+        trace::Trace t;
+        assert(trace::read(in, t));
+        assert(trace::dropped_events() == 0);
+        assert(t.events.size() == 5 * 48);
+    }
+    std::remove(path.c_str());
+    std::cout << "[OK] test_overflow_and_flusher" << std::endl;
+}
+
+/**
+ * @brief 测试损坏的文件被拒绝
+ */
+void test_read_rejects_garbage()
+{
+    std::ofstream("access_trace_garbage.bin", std::ios::binary) << "not a trace";
+    std::ifstream in("access_trace_garbage.bin", std::ios::binary);
+    trace::Trace t;
+    assert(!trace::read(in, t));
+    std::remove("access_trace_garbage.bin");
+    std::cout << "[OK] test_read_rejects_garbage" << std::endl;
+}
+
+int main()
+{
+    test_record_and_read();
+    test_overflow_and_flusher();
+    test_read_rejects_garbage();
+    return 0;
+}
@@ -0,0 +1,161 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/alloc_tracking.h>
+#include <cxxlazy/components/lazy.h>
+#include <cxxlazy/components/metrics.h>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+CXXLAZY_TRACK_GLOBAL_ALLOCATIONS()
+
+using namespace components;
+
+/**
+ * @brief 测试嵌套初始化时的内存归属。
+ *
+ * 验证：
+ * 1. 内层单元的分配记到内层名下，不计入外层。
+ * 2. 重置后值的内存被释放，存活字节数随之下降。
+ * 3. 在其他线程释放的内存同样会被记账。
+ */
+void test_nested_attribution()
+{
+    Lazy<std::vector<char>> inner("inner", [] { return std::vector<char>(64 * 1024); });
+    Lazy<std::vector<char>> outer("outer", [&] {
+        std::vector<char> v(4 * 1024);
+        v[0] = inner->at(0);
+        return v;
+    });
+
+    outer.get();
+
+    auto in = inner.stats()->snapshot();
+    auto out = outer.stats()->snapshot();
+    assert(in.alloc_count >= 1);
+    assert(in.alloc_bytes >= 64 * 1024);
+    assert(in.live_alloc_bytes >= 64 * 1024);
+    assert(out.alloc_bytes >= 4 * 1024);
+    assert(out.alloc_bytes < 64 * 1024);
+
+    inner.reset();
+    assert(inner.stats()->live_alloc_bytes() < 64 * 1024);
+
+    std::thread([&] { outer.reset(); }).join();
+    assert(outer.stats()->live_alloc_bytes() < 4 * 1024);
+
+    std::cout << "[OK] test_nested_attribution" << std::endl;
+}
+
+/**
+ * @brief 测试 TrackingAllocator。
+ *
+ * 验证：
+ * 1. 在初始化函数中构造的分配器归属到该单元。
+ * 2. 在初始化函数之外构造的分配器不记账。
+ */
+void test_tracking_allocator()
+{
+    using TrackedVec = std::vector<int, TrackingAllocator<int>>;
+
+    Lazy<TrackedVec> tracked("tracked", [] {
+        TrackedVec v;
+        v.reserve(1000);
+        return v;
+    });
+
+    tracked.get();
+    assert(tracked->get_allocator().owner().get() == tracked.stats());
+    assert(tracked.stats()->live_alloc_bytes() >= static_cast<std::int64_t>(1000 * sizeof(int)));
+
+    tracked->clear();
+    tracked->shrink_to_fit();
+    assert(tracked.stats()->live_alloc_bytes() == 0);
+
+    TrackedVec outside;
+    assert(outside.get_allocator().owner() == nullptr);
+
+    std::cout << "[OK] test_tracking_allocator" << std::endl;
+}
+
+/**
+ * @brief 测试分配统计出现在指标中。
+ */
+void test_metrics()
+{
+    Lazy<std::string> text("text", [] { return std::string(1000, 'x'); });
+    text.get();
+
+    std::string rendered = render_prometheus();
+    assert(rendered.find("cxxlazy_init_allocations_total{lazy=\"text\"} 1\n") != std::string::npos);
+    assert(rendered.find("cxxlazy_init_live_bytes{lazy=\"text\"} 1001\n") != std::string::npos);
+
+    std::cout << "[OK] test_metrics" << std::endl;
+}
+
+/**
+ * @brief 测试已注销单元的统计信息在内存全部释放后被清理。
+ *
+ * 验证：
+ * 1. 单元析构时仍有未释放的内存，统计信息被保留，释放时仍能记账。
+ * 2. 内存全部释放后，下一次遍历登记表时保留的统计信息被丢弃。
+ */
+void test_retired_pruned()
+{
+    // 先遍历一次，清理前面的测试留下的已注销单元
+    (void)LazyRegistry::instance().cells();
+    const std::size_t before = LazyRegistry::instance().retired_count();
+    std::vector<char>* escaped = nullptr;
+    {
+        Lazy<int> leaky("leaky", [&] {
+            escaped = new std::vector<char>(16 * 1024);
+            return 1;
+        });
+        leaky.get();
+        assert(leaky.stats()->live_alloc_bytes() > 0);
+    }
+    assert(LazyRegistry::instance().retired_count() == before + 1);
+
+    delete escaped;
+    (void)LazyRegistry::instance().cells();
+    assert(LazyRegistry::instance().retired_count() == before);
+
+    std::cout << "[OK] test_retired_pruned" << std::endl;
+}
+
+/**
+ * @brief 测试插桩自身的分配不归属到外层单元。
+ *
+ * 验证：
+ * 1. 嵌套初始化在依赖图中新增一条边时，边的内存不计入外层单元。
+ * 2. 两个单元析构后，外层单元不会因此被保留在已注销列表中。
+ */
+void test_instrumentation_not_attributed()
+{
+    (void)LazyRegistry::instance().cells();
+    const std::size_t before = LazyRegistry::instance().retired_count();
+    {
+        Lazy<int> child("attribution_child", [] { return 1; });
+        Lazy<int> parent("attribution_parent", [&] { return *child + 1; });
+        assert(*parent == 2);
+        assert(parent.stats()->live_alloc_bytes() == 0);
+        assert(parent.stats()->snapshot().alloc_count == 0);
+    }
+    (void)LazyRegistry::instance().cells();
+    assert(LazyRegistry::instance().retired_count() == before);
+
+    std::cout << "[OK] test_instrumentation_not_attributed" << std::endl;
+}
+
+int main()
+{
+    test_nested_attribution();
+    test_tracking_allocator();
+    test_metrics();
+    test_retired_pruned();
+    test_instrumentation_not_attributed();
+    return 0;
+}
@@ -0,0 +1,142 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/append_only_vec.h>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+// 默认构造是 constexpr，全局对象常量初始化，没有启动开销
+static AppendOnlyVec<int> global_vec;
+
+/**
+ * @brief 测试顺序追加和读取。
+ *
+ * 验证：
+ * 1. push_back 返回连续的下标，跨越多个桶后仍能正确读取。
+ * 2. 越界或尚未写入的下标返回 nullptr。
+ * 3. 元素地址在后续追加之后保持不变。
+ */
+void test_sequential()
+{
+    AppendOnlyVec<std::string> vec;
+    assert(vec.size() == 0);
+    assert(vec.get(0) == nullptr);
+
+    assert(vec.push_back("first") == 0);
+    const std::string* first = vec.get(0);
+    for (int i = 1; i < 5000; ++i)
+        assert(vec.emplace_back(std::to_string(i)) == static_cast<std::size_t>(i));
+
+    assert(vec.size() == 5000);
+    assert(vec.get(0) == first);
+    assert(*first == "first");
+    assert(vec[31] == "31");
+    assert(vec[32] == "32");
+    assert(vec[4999] == "4999");
+    assert(vec.get(5000) == nullptr);
+
+    std::size_t visited = 0;
+    vec.for_each([&](std::size_t i, const std::string& s) {
+        assert(i == 0 || s == std::to_string(i));
+        ++visited;
+    });
+    assert(visited == 5000);
+
+    global_vec.push_back(1);
+    assert(global_vec[0] == 1);
+    std::cout << "[OK] test_sequential" << std::endl;
+}
+
+/**
+ * @brief 测试并发追加与读取。
+ *
+ * 验证：
+ * 1. 每个线程写入的元素都出现且只出现一次。
+ * 2. 读取者在追加进行中读到的元素要么为空，要么是完整的值。
+ */
+void test_concurrent()
+{
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 20000;
+    AppendOnlyVec<std::pair<int, int>> vec;
+    std::atomic<bool> done{false};
+    std::atomic<bool> ok{true};
+
+    std::thread reader([&] {
+        while (!done.load())
+        {
+            const std::size_t n = vec.size();
+            for (std::size_t i = n > 64 ? n - 64 : 0; i < n; ++i)
+            {
+                if (const auto* p = vec.get(i); p && (p->first < 0 || p->first >= kThreads || p->second < 0))
+                    ok = false;
+            }
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        writers.emplace_back([&, t] {
+            for (int i = 0; i < kPerThread; ++i)
+            {
+                const std::size_t index = vec.emplace_back(t, i);
+                if (vec[index].first != t || vec[index].second != i)
+                    ok = false;
+            }
+        });
+    }
+    for (auto& w : writers)
+        w.join();
+    done = true;
+    reader.join();
+
+    assert(ok);
+    assert(vec.size() == static_cast<std::size_t>(kThreads * kPerThread));
+    std::vector<std::vector<int>> seen(kThreads, std::vector<int>(kPerThread, 0));
+    vec.for_each([&](std::size_t, const std::pair<int, int>& p) {
+        seen[static_cast<std::size_t>(p.first)][static_cast<std::size_t>(p.second)]++;
+    });
+    for (const auto& row : seen)
+    {
+        for (int c : row)
+            assert(c == 1);
+    }
+    std::cout << "[OK] test_concurrent" << std::endl;
+}
+
+/**
+ * @brief 测试析构时只析构已写入的元素。
+ */
+void test_destruction()
+{
+    static int live = 0;
+    struct Counted
+    {
+        Counted() { ++live; }
+        Counted(const Counted&) { ++live; }
+        ~Counted() { --live; }
+    };
+    {
+        AppendOnlyVec<Counted> vec;
+        for (int i = 0; i < 100; ++i)
+            vec.emplace_back();
+        assert(live == 100);
+    }
+    assert(live == 0);
+    std::cout << "[OK] test_destruction" << std::endl;
+}
+
+int main()
+{
+    test_sequential();
+    test_concurrent();
+    test_destruction();
+    return 0;
+}
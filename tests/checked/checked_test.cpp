@@ -0,0 +1,140 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/lazy.h>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+/**
+ * @brief 测试初始化函数直接访问自己。
+ *
+ * 验证：
+ * 1. 检查模式下抛出 LazyInitError 而不是死锁。
+ * 2. 名称链首尾都是该单元。
+ * 3. 失败后单元可以正常重试。
+ */
+void test_direct_reentry()
+{
+    bool recurse = true;
+    Lazy<int> self("self", [&]() -> int {
+        if (recurse)
+            return *self + 1;
+        return 1;
+    });
+
+    try
+    {
+        self.get();
+        assert(false);
+    }
+    catch (const LazyInitError& e)
+    {
+        std::cout << e.what() << std::endl;
+        assert(e.code() == ErrorCode::ReentrantInitialization);
+        assert((e.chain() == std::vector<std::string>{"self", "self"}));
+    }
+
+    recurse = false;
+    assert(self.get() == 1);
+    std::cout << "[OK] test_direct_reentry" << std::endl;
+}
+
+/**
+ * @brief 测试经由其他单元的间接重入，包括匿名单元。
+ */
+void test_indirect_reentry()
+{
+    Lazy<int>* a_ptr = nullptr;
+    Lazy<int> b("b", [&] { return **a_ptr; });
+    Lazy<int> hidden([&] { return *b; });
+    Lazy<int> a("a", [&] { return *hidden; });
+    a_ptr = &a;
+
+    try
+    {
+        a.get();
+        assert(false);
+    }
+    catch (const LazyInitError& e)
+    {
+        std::cout << e.what() << std::endl;
+        assert(e.code() == ErrorCode::ReentrantInitialization);
+        assert(e.chain().size() == 4);
+        assert(e.chain()[0] == "a");
+        assert(e.chain()[1].rfind("<anonymous@", 0) == 0);
+        assert(e.chain()[2] == "b");
+        assert(e.chain()[3] == "a");
+    }
+    std::cout << "[OK] test_indirect_reentry" << std::endl;
+}
+
+/**
+ * @brief 测试两个线程的初始化相互等待。
+ *
+ * 验证：
+ * 1. 不会挂起，至少一个线程收到 InitializationDeadlock。
+ * 2. 名称链包含两个单元。
+ */
+void test_cross_thread_deadlock()
+{
+    std::atomic<bool> a_started{false};
+    std::atomic<bool> b_started{false};
+    Lazy<int>* b_ptr = nullptr;
+
+    Lazy<int> a("left", [&] {
+        a_started = true;
+        while (!b_started)
+            std::this_thread::yield();
+        return **b_ptr;
+    });
+    Lazy<int> b("right", [&] {
+        b_started = true;
+        while (!a_started)
+            std::this_thread::yield();
+        return *a;
+    });
+    b_ptr = &b;
+
+    std::atomic<int> deadlocks{0};
+    std::vector<std::string> chain;
+    auto run = [&](Lazy<int>& target) {
+        try
+        {
+            target.get();
+        }
+        catch (const LazyInitError& e)
+        {
+            if (e.code() == ErrorCode::InitializationDeadlock && deadlocks++ == 0)
+            {
+                std::cout << e.what() << std::endl;
+                chain = e.chain();
+            }
+        }
+    };
+
+    std::thread t1(run, std::ref(a));
+    std::thread t2(run, std::ref(b));
+    t1.join();
+    t2.join();
+
+    assert(deadlocks >= 1);
+    assert(chain.size() == 3);
+    assert(chain.front() == chain.back());
+    assert((chain[0] == "left" && chain[1] == "right") || (chain[0] == "right" && chain[1] == "left"));
+    std::cout << "[OK] test_cross_thread_deadlock" << std::endl;
+}
+
+int main()
+{
+    checked::set_enabled(true);
+    test_direct_reentry();
+    test_indirect_reentry();
+    test_cross_thread_deadlock();
+    return 0;
+}
@@ -0,0 +1,85 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/dependency_graph.h>
+#include <cxxlazy/components/lazy.h>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+/**
+ * @brief 测试嵌套初始化产生的依赖图。
+ *
+ * 验证：
+ * 1. 每条嵌套关系记录为一条边，匿名单元归属到具名外层单元。
+ * 2. 关键路径沿着耗时最长的子节点前进。
+ * 3. DOT 和 JSON 导出包含节点、边和关键路径。
+ * 4. 重复的嵌套初始化累加到已有的边上，清空后计数归零。
+ */
+void test_dependency_graph()
+{
+    auto sleep_ms = [](int ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); };
+
+    Lazy<int> leaf("leaf", [&] { sleep_ms(30); return 1; });
+    Lazy<int> fast("fast", [&] { return 2; });
+    Lazy<int> hidden([&] { return *leaf; });
+    Lazy<int> config("config", [&] { return *hidden + 1; });
+    Lazy<int> app("app", [&] { return *config + *fast; });
+
+    assert(*app == 4);
+
+    auto edges = DependencyGraph::instance().edges();
+    assert(edges.size() == 3);
+    assert(edges[0].parent == "app" && edges[0].child == "config" && edges[0].count == 1);
+    assert(edges[1].parent == "app" && edges[1].child == "fast");
+    assert(edges[2].parent == "config" && edges[2].child == "leaf");
+
+    auto path = DependencyGraph::instance().critical_path();
+    assert((path == std::vector<std::string>{"app", "config", "leaf"}));
+
+    std::string dot = render_dependency_dot();
+    std::cout << dot;
+    assert(dot.rfind("digraph cxxlazy {", 0) == 0);
+    assert(dot.find("\"app\" -> \"config\" [label=\"1\", color=red") != std::string::npos);
+    assert(dot.find("\"app\" -> \"fast\" [label=\"1\"];") != std::string::npos);
+
+    std::string json = render_dependency_json();
+    std::cout << json;
+    assert(json.find("{\"from\":\"config\",\"to\":\"leaf\",\"count\":1}") != std::string::npos);
+    assert(json.find("\"critical_path\":[\"app\",\"config\",\"leaf\"]") != std::string::npos);
+
+    config.reset();
+    assert(*config == 2);
+    assert(DependencyGraph::instance().edges().size() == 3);
+
+    // 同一个父单元再次初始化子单元时走缓存的边，计数照样累加
+    leaf.reset();
+    hidden.reset();
+    config.reset();
+    app.reset();
+    assert(*app == 4);
+    edges = DependencyGraph::instance().edges();
+    assert(edges.size() == 3);
+    assert(edges[0].count == 2 && edges[1].count == 1 && edges[2].count == 2);
+
+    DependencyGraph::instance().clear();
+    assert(DependencyGraph::instance().edges().empty());
+
+    config.reset();
+    app.reset();
+    assert(*app == 4);
+    edges = DependencyGraph::instance().edges();
+    assert(edges.size() == 1 && edges[0].child == "config" && edges[0].count == 1);
+    DependencyGraph::instance().clear();
+    std::cout << "[OK] test_dependency_graph" << std::endl;
+}
+
+int main()
+{
+    test_dependency_graph();
+    return 0;
+}
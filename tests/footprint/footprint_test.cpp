@@ -0,0 +1,109 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/lazy.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <cassert>
+
+using namespace components;
+
+// 单元常被嵌入大量分配的对象中，布局变化会直接放大为内存占用
+// 预算按组成部分表达：值本身、互斥锁、统计信息指针，再加一个字用于状态和对齐
+
+/// @brief 状态变量加对齐填充的预算
+constexpr std::size_t kStateBudget = sizeof(void*);
+
+template <typename T>
+constexpr std::size_t once_cell_budget()
+{
+    return sizeof(std::optional<T>) + sizeof(std::mutex) + sizeof(CellStats*) + kStateBudget;
+}
+
+constexpr std::size_t kOnceCallBudget = sizeof(std::mutex) + sizeof(CellStats*) + kStateBudget;
+
+template <typename T>
+constexpr std::size_t lazy_budget()
+{
+    return once_cell_budget<T>() + sizeof(std::function<T()>);
+}
+
+static_assert(sizeof(OnceCall) <= kOnceCallBudget, "OnceCall grew");
+static_assert(sizeof(OnceCell<int>) <= once_cell_budget<int>(), "OnceCell<int> grew");
+static_assert(sizeof(OnceCell<std::uint64_t>) <= once_cell_budget<std::uint64_t>(), "OnceCell<uint64_t> grew");
+static_assert(sizeof(OnceCell<std::string>) <= once_cell_budget<std::string>(), "OnceCell<string> grew");
+static_assert(sizeof(OnceCell<std::array<char, 256>>) <= once_cell_budget<std::array<char, 256>>(),
+              "OnceCell<array<char, 256>> grew");
+static_assert(sizeof(Lazy<int>) <= lazy_budget<int>(), "Lazy<int> grew");
+static_assert(sizeof(Lazy<std::string>) <= lazy_budget<std::string>(), "Lazy<string> grew");
+static_assert(sizeof(Lazy<void>) <= kOnceCallBudget + sizeof(std::function<void()>), "Lazy<void> grew");
+
+// 值内联存放：对于大对象，单元的额外开销不随 T 变化
+static_assert(sizeof(OnceCell<std::array<char, 256>>) - sizeof(std::array<char, 256>)
+              <= once_cell_budget<char>(), "OnceCell overhead depends on T");
+
+#if defined(__x86_64__) && defined(__GLIBCXX__)
+// 在主要目标平台上锁定精确数值，任何布局变化都需要同时更新这里
+// 以引入 LazyRegistry 之前的布局为基线，之后每一项增长都单独列出，而不是把当前大小加上余量当作预算，
+// 这样像统计信息指针从 shared_ptr（16 字节）换成裸指针（8 字节）这样的变化会直接体现在差值上
+
+/// @brief 基线布局（没有统计信息）：状态 + 互斥锁（+ 值）
+constexpr std::size_t kBaselineOnceCall = 48;
+constexpr std::size_t kBaselineOnceCellInt = 56;
+constexpr std::size_t kBaselineLazyInt = 88;
+constexpr std::size_t kBaselineLazyVoid = 80;
+
+/// @brief 相对基线的增长：具名单元的统计信息指针，匿名单元为空
+constexpr std::size_t kStatsPointerDelta = sizeof(CellStats*);
+
+static_assert(kStatsPointerDelta == 8, "stats pointer delta changed");
+static_assert(sizeof(OnceCall) == kBaselineOnceCall + kStatsPointerDelta, "OnceCall layout changed");
+static_assert(sizeof(OnceCell<int>) == kBaselineOnceCellInt + kStatsPointerDelta, "OnceCell<int> layout changed");
+static_assert(sizeof(Lazy<int>) == kBaselineLazyInt + kStatsPointerDelta, "Lazy<int> layout changed");
+static_assert(sizeof(Lazy<void>) == kBaselineLazyVoid + kStatsPointerDelta, "Lazy<void> layout changed");
+#endif
+
+/**
+ * @brief 打印各单元类型的大小，便于在不同平台上对比
+ */
+void report_sizes()
+{
+    std::cout << "sizeof(OnceCall)            = " << sizeof(OnceCall) << "\n"
+        << "sizeof(OnceCell<int>)       = " << sizeof(OnceCell<int>) << "\n"
+        << "sizeof(OnceCell<string>)    = " << sizeof(OnceCell<std::string>) << "\n"
+        << "sizeof(Lazy<int>)           = " << sizeof(Lazy<int>) << "\n"
+        << "sizeof(Lazy<string>)        = " << sizeof(Lazy<std::string>) << "\n"
+        << "sizeof(Lazy<void>)          = " << sizeof(Lazy<void>) << "\n";
+}
+
+/**
+ * @brief 测试匿名单元在初始化前后都不分配统计信息。
+ *
+ * 验证：
+ * 1. 匿名单元的 stats() 始终为空，额外占用只有对象本身。
+ */
+void test_anonymous_cells_have_no_stats()
+{
+    OnceCell<int> cell;
+    assert(cell.stats() == nullptr);
+    cell.get_or_init([] { return 1; });
+    assert(cell.stats() == nullptr);
+
+    Lazy<int> lazy([] { return 2; });
+    assert(*lazy == 2);
+    assert(lazy.stats() == nullptr);
+}
+
+int main()
+{
+    report_sizes();
+    test_anonymous_cells_have_no_stats();
+    return 0;
+}
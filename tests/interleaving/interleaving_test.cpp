@@ -0,0 +1,306 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include "model.h"
+#include <cxxlazy/components/once_call.h>
+#include <array>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <cassert>
+
+using namespace components;
+
+namespace
+{
+    constexpr int kAlive = 0x600d;
+    constexpr int kDead = 0xdead;
+
+    /**
+     * @brief 一次执行中所有值的记账
+     */
+    struct Probe
+    {
+        int inits = 0;
+        int live = 0;
+    };
+
+    /**
+     * @brief 被测单元中存放的值，记录自己是第几次初始化的结果
+     * @details 析构时把 magic 改为 kDead，重置后仍被读取的引用可以据此发现
+     */
+    struct Value
+    {
+        Value(Probe& probe, int epoch) : probe(&probe), epoch(epoch)
+        {
+            if (++probe.live > 1)
+                model::Scheduler::fail("two values alive at the same time");
+        }
+
+        /// @brief 只有 emplace 时转移所有权，被移走的对象不再计入存活数
+        Value(Value&& other) noexcept : probe(other.probe), epoch(other.epoch)
+        {
+            other.owner = false;
+        }
+
+        Value& operator=(Value&&) = delete;
+
+        ~Value()
+        {
+            magic = kDead;
+            if (owner)
+                probe->live--;
+        }
+
+        Probe* probe;
+        int epoch;
+        int magic = kAlive;
+        bool owner = true;
+    };
+
+    using Cell = OnceCell<Value, model::Sync>;
+
+    /**
+     * @brief 获取值并立即检查它没有被重置销毁
+     */
+    const Value& checked_get(Cell& cell, Probe& probe)
+    {
+        const Value& v = cell.get_or_init([&]() -> Value { return Value(probe, ++probe.inits); });
+        if (v.magic != kAlive)
+            model::Scheduler::fail("use after reset: get returned a destroyed value");
+        return v;
+    }
+
+    model::Options exhaustive(int preemption_bound)
+    {
+        model::Options o;
+        o.preemption_bound = preemption_bound;
+        return o;
+    }
+
+    model::Options random(std::size_t executions, std::uint64_t seed)
+    {
+        model::Options o;
+        o.mode = model::Options::Mode::Random;
+        o.max_executions = executions;
+        o.seed = seed;
+        return o;
+    }
+
+    void report(const char* name, const model::Result& r)
+    {
+        std::cout << "[" << (r.failed ? "FAIL" : "OK") << "] " << name << ": executions=" << r.executions
+            << (r.complete ? " (complete)" : "");
+        if (r.failed)
+        {
+            std::cout << " failure=\"" << r.failure << "\" schedule=";
+            for (int c : r.schedule)
+                std::cout << c;
+        }
+        std::cout << std::endl;
+    }
+}
+
+/**
+ * @brief 测试多个线程同时获取冷单元。
+ *
+ * 验证：
+ * 1. 在所有（受抢占上限约束的）交错下，初始化函数只执行一次。
+ * 2. 每个线程都拿到同一个值，等待锁的线程不会丢失唤醒。
+ */
+void test_single_initialization()
+{
+    auto r = model::Scheduler::explore(exhaustive(3), [](model::Execution& ex) {
+        auto probe = std::make_shared<Probe>();
+        auto cell = std::make_shared<Cell>();
+        auto seen = std::make_shared<std::array<int, 3>>();
+        for (int t = 0; t < 3; ++t)
+            ex.thread([=] { (*seen)[static_cast<std::size_t>(t)] = checked_get(*cell, *probe).epoch; });
+        ex.after([=] {
+            if (probe->inits != 1)
+                model::Scheduler::fail("initializer ran " + std::to_string(probe->inits) + " times");
+            for (int epoch : *seen)
+            {
+                if (epoch != 1)
+                    model::Scheduler::fail("a thread saw epoch " + std::to_string(epoch));
+            }
+        });
+    });
+    report("single_initialization", r);
+    assert(!r.failed && r.complete && r.executions > 1);
+}
+
+/**
+ * @brief 测试初始化失败后其他线程接手。
+ *
+ * 验证：
+ * 1. 第一次初始化抛出异常后状态回到未初始化，等待的线程会重新尝试而不是永远阻塞。
+ * 2. 最多只有一次成功的初始化，拿到值的线程看到的都是它。
+ */
+void test_failure_then_retry()
+{
+    auto r = model::Scheduler::explore(exhaustive(3), [](model::Execution& ex) {
+        auto probe = std::make_shared<Probe>();
+        auto cell = std::make_shared<Cell>();
+        auto attempts = std::make_shared<int>(0);
+        auto successes = std::make_shared<int>(0);
+        for (int t = 0; t < 2; ++t)
+        {
+            ex.thread([=] {
+                try
+                {
+                    const Value& v = cell->get_or_init([&]() -> Value {
+                        if (++*attempts == 1)
+                            throw std::runtime_error("first attempt fails");
+                        return Value(*probe, ++probe->inits);
+                    });
+                    if (v.magic != kAlive || v.epoch != 1)
+                        model::Scheduler::fail("saw a bad value after retry");
+                    ++*successes;
+                }
+                catch (const std::runtime_error&)
+                {
+                }
+            });
+        }
+        ex.after([=] {
+            if (probe->inits > 1)
+                model::Scheduler::fail("more than one successful initialization");
+            if (*successes > 0 && probe->inits != 1)
+                model::Scheduler::fail("a thread returned without an initialized value");
+        });
+    });
+    report("failure_then_retry", r);
+    assert(!r.failed && r.complete);
+}
+
+/**
+ * @brief 测试 reset 之后的并发获取。
+ *
+ * reset 不能与读取并发，因此场景中的 reset 都与读取有先后关系：
+ * 第一次 reset 在线程启动之前，第二次在所有线程结束之后。
+ *
+ * 验证：
+ * 1. reset 之后并发的 get 只重新初始化一次，所有线程看到同一个新值。
+ * 2. 任意时刻最多只有一个值存活，get 返回的值没有被销毁。
+ * 3. 线程结束之后再次 reset，下一次 get 看到的是更新的值。
+ */
+void test_reset_interleavings()
+{
+    auto scenario = [](model::Execution& ex) {
+        auto probe = std::make_shared<Probe>();
+        auto cell = std::make_shared<Cell>();
+        auto seen = std::make_shared<std::array<int, 2>>();
+        // 线程启动之前：初始化一次后重置，重置先于所有读取
+        checked_get(*cell, *probe);
+        cell->reset();
+        for (int t = 0; t < 2; ++t)
+            ex.thread([=] { (*seen)[static_cast<std::size_t>(t)] = checked_get(*cell, *probe).epoch; });
+        ex.after([=] {
+            if (probe->inits != 2)
+                model::Scheduler::fail("reinitialized " + std::to_string(probe->inits - 1) + " times after reset");
+            for (int epoch : *seen)
+            {
+                if (epoch != 2)
+                    model::Scheduler::fail("stale value after reset: epoch " + std::to_string(epoch));
+            }
+            // 所有线程结束之后：再次重置，读到的一定是新值
+            cell->reset();
+            if (probe->live != 0)
+                model::Scheduler::fail("reset left a value alive");
+            if (checked_get(*cell, *probe).epoch != 3)
+                model::Scheduler::fail("stale value after the second reset");
+        });
+    };
+
+    auto r = model::Scheduler::explore(exhaustive(2), scenario);
+    report("reset_interleavings (exhaustive)", r);
+    assert(!r.failed && r.complete);
+
+    r = model::Scheduler::explore(random(2000, 42), scenario);
+    report("reset_interleavings (random)", r);
+    assert(!r.failed && r.executions == 2000);
+}
+
+/**
+ * @brief 确认调度器能发现典型的错误实现：加锁后没有再次检查状态。
+ */
+void test_explorer_finds_double_init()
+{
+    struct NaiveCell
+    {
+        model::Atomic<bool> ready{false};
+        model::Mutex mtx;
+        int inits = 0;
+
+        void get()
+        {
+            if (ready.load())
+                return;
+            std::lock_guard<model::Mutex> lock(mtx);
+            ++inits;
+            ready.store(true);
+        }
+    };
+
+    auto r = model::Scheduler::explore(exhaustive(2), [](model::Execution& ex) {
+        auto cell = std::make_shared<NaiveCell>();
+        ex.thread([=] { cell->get(); });
+        ex.thread([=] { cell->get(); });
+        ex.after([=] {
+            if (cell->inits != 1)
+                model::Scheduler::fail("initializer ran " + std::to_string(cell->inits) + " times");
+        });
+    });
+    report("explorer_finds_double_init (expected failure)", r);
+    assert(r.failed && r.failure == "initializer ran 2 times");
+}
+
+/**
+ * @brief 确认调度器能发现丢失的唤醒，而 futex 式的“比较后阻塞”不会丢失。
+ */
+void test_explorer_finds_lost_wakeup()
+{
+    auto broken = model::Scheduler::explore(exhaustive(2), [](model::Execution& ex) {
+        auto flag = std::make_shared<model::Atomic<bool>>(false);
+        ex.thread([=] {
+            if (!flag->load())
+            {
+                // 检查和阻塞之间没有保护，例如没有持锁就调用条件变量的 wait
+                model::Scheduler::schedule_point();
+                model::Scheduler::block(flag.get());
+            }
+        });
+        ex.thread([=] {
+            flag->store(true);
+            flag->notify_all();
+        });
+    });
+    report("explorer_finds_lost_wakeup (expected failure)", broken);
+    assert(broken.failed && broken.failure.rfind("deadlock", 0) == 0);
+
+    auto futex = model::Scheduler::explore(exhaustive(-1), [](model::Execution& ex) {
+        auto flag = std::make_shared<model::Atomic<bool>>(false);
+        ex.thread([=] {
+            while (!flag->load())
+                flag->wait(false);
+        });
+        ex.thread([=] {
+            flag->store(true);
+            flag->notify_all();
+        });
+    });
+    report("futex_wait_no_lost_wakeup", futex);
+    assert(!futex.failed && futex.complete);
+}
+
+int main()
+{
+    test_single_initialization();
+    test_failure_then_retry();
+    test_reset_interleavings();
+    test_explorer_finds_double_init();
+    test_explorer_finds_lost_wakeup();
+    return 0;
+}
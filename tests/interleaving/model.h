@@ -0,0 +1,476 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+// 协作式调度器与模型同步原语
+//
+// 每个逻辑线程是一个真实线程，但任意时刻只有一个在运行；
+// 模型原子变量和互斥锁的每次操作之前都是一个调度点，由调度器决定接下来运行哪个线程
+// 调度器可以系统地（深度优先，带抢占次数上限）或随机地枚举这些选择，
+// 所有线程都阻塞而仍有线程未结束时报告死锁（例如丢失的唤醒）
+//
+// 调度是顺序一致的：它枚举操作的交错顺序，但不模拟弱内存序下的重排
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace model
+{
+    /**
+     * @brief 执行被中止（发现死锁或违反不变式）时，用于让其余逻辑线程退出
+     * @details 故意不继承 std::exception，避免被被测代码中的 catch 吞掉
+     */
+    struct Abort
+    {
+    };
+
+    /**
+     * @brief 一次执行：登记逻辑线程和结束后的检查
+     */
+    class Execution
+    {
+    public:
+        /**
+         * @brief 添加一个逻辑线程
+         */
+        void thread(std::function<void()> fn) { threads_.push_back(std::move(fn)); }
+
+        /**
+         * @brief 所有线程结束后执行的检查，发现问题时调用 fail
+         */
+        void after(std::function<void()> fn) { after_.push_back(std::move(fn)); }
+
+    private:
+        friend class Scheduler;
+        std::vector<std::function<void()>> threads_;
+        std::vector<std::function<void()>> after_;
+    };
+
+    struct Options
+    {
+        enum class Mode { Exhaustive, Random } mode = Mode::Exhaustive;
+        /// @brief 执行次数上限，穷举模式下达到上限时 complete 为 false
+        std::size_t max_executions = 100000;
+        /// @brief 穷举模式下每次执行最多的抢占次数，负数表示不限制
+        int preemption_bound = 2;
+        std::uint64_t seed = 1;
+    };
+
+    struct Result
+    {
+        std::size_t executions = 0;
+        /// @brief 穷举模式下是否遍历了所有（受抢占上限约束的）交错
+        bool complete = false;
+        bool failed = false;
+        std::string failure;
+        /// @brief 失败执行的调度选择序列，可用于复现
+        std::vector<int> schedule;
+    };
+
+    class Scheduler
+    {
+    public:
+        /**
+         * @brief 正在执行中的调度器，不在模型线程中时为空
+         */
+        static Scheduler*& active()
+        {
+            static Scheduler* s = nullptr;
+            return s;
+        }
+
+        /**
+         * @brief 当前逻辑线程编号，不是模型线程时为 -1
+         */
+        static int& self()
+        {
+            thread_local int id = -1;
+            return id;
+        }
+
+        /**
+         * @brief 反复执行场景，直到枚举完所有交错、达到次数上限或发现问题
+         * @param setup 每次执行前调用，构造新的共享状态并登记线程
+         */
+        static Result explore(const Options& options, const std::function<void(Execution&)>& setup)
+        {
+            Result result;
+            std::mt19937_64 rng(options.seed);
+            std::vector<int> prefix;
+            while (result.executions < options.max_executions)
+            {
+                Scheduler s(options, prefix, rng);
+                Execution ex;
+                setup(ex);
+                s.run(ex);
+                result.executions++;
+                if (!s.failure_.empty())
+                {
+                    result.failed = true;
+                    result.failure = s.failure_;
+                    for (const auto& d : s.decisions_)
+                        result.schedule.push_back(d.first);
+                    return result;
+                }
+                if (options.mode == Options::Mode::Random)
+                    continue;
+
+                // 深度优先：回溯到最后一个还有未尝试选项的决策点
+                auto& d = s.decisions_;
+                while (!d.empty() && d.back().first + 1 >= d.back().second)
+                    d.pop_back();
+                if (d.empty())
+                {
+                    result.complete = true;
+                    return result;
+                }
+                d.back().first++;
+                prefix.clear();
+                for (const auto& [choice, n] : d)
+                    prefix.push_back(choice);
+            }
+            return result;
+        }
+
+        /**
+         * @brief 记录违反不变式，中止本次执行
+         */
+        static void fail(const std::string& message)
+        {
+            Scheduler* s = active();
+            if (s && s->failure_.empty())
+                s->failure_ = message;
+        }
+
+        /**
+         * @brief 调度点：在每个模型操作之前调用
+         */
+        static void schedule_point()
+        {
+            Scheduler* s = active();
+            if (!s || self() < 0)
+                return;
+            s->switch_from(self());
+        }
+
+        /**
+         * @brief 阻塞当前逻辑线程，直到 wake(obj) 被调用
+         */
+        static void block(const void* obj)
+        {
+            Scheduler* s = active();
+            if (!s || self() < 0)
+                return;
+            if (s->aborted_)
+                throw Abort{};
+            s->threads_[static_cast<std::size_t>(self())].blocked_on = obj;
+            s->switch_from(self());
+        }
+
+        /**
+         * @brief 唤醒所有阻塞在 obj 上的逻辑线程，本身不是调度点
+         */
+        static void wake(const void* obj)
+        {
+            Scheduler* s = active();
+            if (!s)
+                return;
+            for (auto& t : s->threads_)
+            {
+                if (t.blocked_on == obj)
+                    t.blocked_on = nullptr;
+            }
+        }
+
+    private:
+        struct ThreadState
+        {
+            bool finished = false;
+            const void* blocked_on = nullptr;
+        };
+
+        Scheduler(const Options& options, const std::vector<int>& prefix, std::mt19937_64& rng)
+            : options_(options), prefix_(prefix), rng_(rng)
+        {
+        }
+
+        void run(Execution& ex)
+        {
+            threads_.assign(ex.threads_.size(), ThreadState{});
+            active() = this;
+            std::vector<std::thread> real;
+            for (std::size_t i = 0; i < ex.threads_.size(); ++i)
+            {
+                real.emplace_back([this, &ex, i] {
+                    self() = static_cast<int>(i);
+                    try
+                    {
+                        if (wait_turn(static_cast<int>(i)))
+                            ex.threads_[i]();
+                    }
+                    catch (const Abort&)
+                    {
+                    }
+                    catch (const std::exception& e)
+                    {
+                        fail(std::string("uncaught exception: ") + e.what());
+                    }
+                    finish(static_cast<int>(i));
+                    self() = -1;
+                });
+            }
+            {
+                std::unique_lock<std::mutex> lock(m_);
+                running_ = pick(-1);
+                cv_.notify_all();
+                cv_.wait(lock, [&] { return running_ == kDone; });
+            }
+            for (auto& t : real)
+                t.join();
+            if (failure_.empty())
+            {
+                for (auto& check : ex.after_)
+                    check();
+            }
+            active() = nullptr;
+        }
+
+        static constexpr int kDone = -2;
+
+        bool enabled(std::size_t i) const
+        {
+            return !threads_[i].finished && (aborted_ || threads_[i].blocked_on == nullptr);
+        }
+
+        /**
+         * @brief 选择下一个运行的线程
+         * @param current 当前线程，-1 表示没有
+         * @return 所有线程都结束时返回 kDone
+         */
+        int pick(int current)
+        {
+            std::vector<int> options;
+            bool unfinished = false;
+            for (std::size_t i = 0; i < threads_.size(); ++i)
+            {
+                unfinished |= !threads_[i].finished;
+                if (enabled(i))
+                    options.push_back(static_cast<int>(i));
+            }
+            if (options.empty())
+            {
+                if (!unfinished)
+                    return kDone;
+                std::ostringstream os;
+                os << "deadlock: every unfinished thread is blocked:";
+                for (std::size_t i = 0; i < threads_.size(); ++i)
+                {
+                    if (!threads_[i].finished)
+                        os << " " << i;
+                }
+                fail(os.str());
+                aborted_ = true;
+                return pick(current);
+            }
+
+            const bool current_enabled = current >= 0 && enabled(static_cast<std::size_t>(current));
+            if (aborted_)
+                return current_enabled ? current : options.front();
+            if (!failure_.empty())
+            {
+                aborted_ = true;
+                return current_enabled ? current : options.front();
+            }
+            if (options.size() == 1)
+                return options.front();
+            if (current_enabled && options_.mode == Options::Mode::Exhaustive && options_.preemption_bound >= 0 &&
+                preemptions_ >= options_.preemption_bound)
+                return current;
+
+            int index;
+            const auto n = static_cast<int>(options.size());
+            if (decisions_.size() < prefix_.size())
+                index = prefix_[decisions_.size()];
+            else if (options_.mode == Options::Mode::Random)
+                index = static_cast<int>(rng_() % options.size());
+            else
+                index = 0;
+            decisions_.emplace_back(index, n);
+            const int next = options[static_cast<std::size_t>(index)];
+            if (current_enabled && next != current)
+                preemptions_++;
+            return next;
+        }
+
+        /**
+         * @return 执行已被中止时返回 false，线程不应再开始运行
+         */
+        bool wait_turn(int id)
+        {
+            std::unique_lock<std::mutex> lock(m_);
+            cv_.wait(lock, [&] { return running_ == id; });
+            return !aborted_;
+        }
+
+        void switch_from(int id)
+        {
+            std::unique_lock<std::mutex> lock(m_);
+            const bool was_aborted = aborted_;
+            const int next = pick(id);
+            if (next != id)
+            {
+                running_ = next;
+                cv_.notify_all();
+                cv_.wait(lock, [&] { return running_ == id; });
+            }
+            // 中止后，停在调度点或阻塞中的线程依次恢复并退出
+            auto& self_state = threads_[static_cast<std::size_t>(id)];
+            if (aborted_ && (!was_aborted || self_state.blocked_on))
+            {
+                self_state.blocked_on = nullptr;
+                throw Abort{};
+            }
+        }
+
+        void finish(int id)
+        {
+            std::unique_lock<std::mutex> lock(m_);
+            threads_[static_cast<std::size_t>(id)].finished = true;
+            threads_[static_cast<std::size_t>(id)].blocked_on = nullptr;
+            running_ = pick(-1);
+            cv_.notify_all();
+        }
+
+        const Options& options_;
+        const std::vector<int>& prefix_;
+        std::mt19937_64& rng_;
+        std::mutex m_;
+        std::condition_variable cv_;
+        int running_ = -1;
+        bool aborted_ = false;
+        int preemptions_ = 0;
+        std::vector<ThreadState> threads_;
+        /// @brief (选择的下标, 可选数量)
+        std::vector<std::pair<int, int>> decisions_;
+        std::string failure_;
+    };
+
+    /**
+     * @brief 模型原子变量：每次操作前都是一个调度点
+     */
+    template <typename T>
+    class Atomic
+    {
+    public:
+        constexpr Atomic() noexcept = default;
+
+        constexpr Atomic(T v) noexcept : v_(v) // NOLINT(google-explicit-constructor)
+        {
+        }
+
+        T load(std::memory_order = std::memory_order_seq_cst) const
+        {
+            Scheduler::schedule_point();
+            return v_;
+        }
+
+        void store(T v, std::memory_order = std::memory_order_seq_cst)
+        {
+            Scheduler::schedule_point();
+            v_ = v;
+        }
+
+        T exchange(T v, std::memory_order = std::memory_order_seq_cst)
+        {
+            Scheduler::schedule_point();
+            return std::exchange(v_, v);
+        }
+
+        bool compare_exchange_strong(T& expected, T desired, std::memory_order = std::memory_order_seq_cst)
+        {
+            Scheduler::schedule_point();
+            if (v_ == expected)
+            {
+                v_ = desired;
+                return true;
+            }
+            expected = v_;
+            return false;
+        }
+
+        /**
+         * @brief 类似 futex：值仍等于 expected 时阻塞，直到 notify_all
+         */
+        void wait(T expected) const
+        {
+            Scheduler::schedule_point();
+            if (v_ == expected)
+                Scheduler::block(this);
+        }
+
+        void notify_all() const { Scheduler::wake(this); }
+
+    private:
+        T v_{};
+    };
+
+    /**
+     * @brief 模型互斥锁：lock/try_lock 是调度点，锁被占用时阻塞当前逻辑线程
+     */
+    class Mutex
+    {
+    public:
+        constexpr Mutex() noexcept = default;
+
+        Mutex(const Mutex&) = delete;
+
+        Mutex& operator=(const Mutex&) = delete;
+
+        void lock()
+        {
+            Scheduler::schedule_point();
+            while (locked_)
+                Scheduler::block(this);
+            locked_ = true;
+        }
+
+        bool try_lock()
+        {
+            Scheduler::schedule_point();
+            if (locked_)
+                return false;
+            locked_ = true;
+            return true;
+        }
+
+        void unlock() noexcept
+        {
+            locked_ = false;
+            Scheduler::wake(this);
+        }
+
+    private:
+        bool locked_ = false;
+    };
+
+    /**
+     * @brief 供 OnceCell 使用的模型同步原语
+     */
+    struct Sync
+    {
+        template <typename U>
+        using atomic = Atomic<U>;
+        using mutex = Mutex;
+    };
+}
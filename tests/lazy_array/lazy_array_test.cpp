@@ -0,0 +1,245 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/lazy_array.h>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+/**
+ * @brief 登记表中是否存在指定名称的单元
+ */
+bool registered(const std::string& name)
+{
+    for (const auto& stats : LazyRegistry::instance().cells())
+    {
+        if (stats->name() == name)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 测试基本的按下标初始化。
+ *
+ * 验证：
+ * 1. 初始化函数收到槽位下标，只在第一次访问时执行。
+ * 2. try_get / is_initialized 不会触发初始化。
+ */
+void test_basic()
+{
+    int calls = 0;
+    LazyArray<std::string> arr(100, [&](std::size_t i) {
+        ++calls;
+        return "slot-" + std::to_string(i);
+    });
+
+    assert(arr.size() == 100);
+    assert(arr.initialized_count() == 0);
+    assert(arr.try_get(7) == nullptr);
+    assert(!arr.is_initialized(7));
+
+    assert(arr.get(7) == "slot-7");
+    assert(arr[7] == "slot-7");
+    assert(arr[99] == "slot-99");
+    assert(calls == 2);
+    assert(arr.is_initialized(7));
+    assert(*arr.try_get(99) == "slot-99");
+    assert(arr.initialized_count() == 2);
+    std::cout << "[OK] test_basic" << std::endl;
+}
+
+/**
+ * @brief 测试多个线程同时访问所有槽位。
+ *
+ * 验证：
+ * 1. 每个槽位只初始化一次。
+ * 2. 所有线程看到相同的值。
+ */
+void test_concurrent()
+{
+    constexpr std::size_t kSize = 1000;
+    std::vector<std::atomic<int>> calls(kSize);
+    LazyArray<std::size_t> arr(kSize, [&](std::size_t i) {
+        calls[i].fetch_add(1);
+        std::this_thread::yield();
+        return i * 3;
+    });
+
+    std::atomic<bool> ok{true};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([&, t] {
+            for (std::size_t k = 0; k < kSize; ++k)
+            {
+                const std::size_t i = (k * 7 + static_cast<std::size_t>(t)) % kSize;
+                if (arr.get(i) != i * 3)
+                    ok = false;
+            }
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    assert(ok);
+    for (const auto& c : calls)
+        assert(c.load() == 1);
+    assert(arr.initialized_count() == kSize);
+    std::cout << "[OK] test_concurrent" << std::endl;
+}
+
+/**
+ * @brief 测试初始化失败后重试。
+ *
+ * 验证：
+ * 1. 异常传播给调用者，槽位保持未初始化。
+ * 2. 下一次访问重新执行初始化。
+ */
+void test_failure_then_retry()
+{
+    int attempts = 0;
+    LazyArray<int> arr(4, [&](std::size_t i) {
+        if (++attempts == 1)
+            throw std::runtime_error("first attempt fails");
+        return static_cast<int>(i) + 10;
+    });
+
+    try
+    {
+        arr.get(2);
+        assert(false);
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+    assert(!arr.is_initialized(2));
+    assert(arr.get(2) == 12);
+    assert(attempts == 2);
+    std::cout << "[OK] test_failure_then_retry" << std::endl;
+}
+
+/**
+ * @brief 测试遍历已初始化的槽位。
+ *
+ * 验证：
+ * 1. 按下标顺序只访问已初始化的槽位，跨越多个位图字。
+ * 2. 析构时只析构已初始化的值。
+ */
+void test_for_each_initialized()
+{
+    static int live = 0;
+    struct Counted
+    {
+        explicit Counted(std::size_t i) : index(i) { ++live; }
+        Counted(Counted&& other) noexcept : index(other.index) { ++live; }
+        ~Counted() { --live; }
+        std::size_t index;
+    };
+
+    {
+        LazyArray<Counted> arr(300, [](std::size_t i) { return Counted(i); });
+        const std::vector<std::size_t> touched = {299, 0, 64, 63, 130};
+        for (std::size_t i : touched)
+            arr.get(i);
+        assert(live == 5);
+
+        std::vector<std::size_t> seen;
+        arr.for_each_initialized([&](std::size_t i, Counted& c) {
+            assert(c.index == i);
+            seen.push_back(i);
+        });
+        assert((seen == std::vector<std::size_t>{0, 63, 64, 130, 299}));
+        assert(arr.initialized_count() == 5);
+    }
+    assert(live == 0);
+    std::cout << "[OK] test_for_each_initialized" << std::endl;
+}
+
+/**
+ * @brief 测试具名数组的统计信息。
+ *
+ * 验证：
+ * 1. 每个槽位的初始化都计入同一份统计。
+ * 2. 析构后从登记表注销。
+ */
+void test_named_stats()
+{
+    {
+        LazyArray<int> arr("lazy_array_stats", 16, [](std::size_t i) { return static_cast<int>(i); });
+        arr.get(1);
+        arr.get(2);
+        arr.get(2);
+        auto s = arr.stats()->snapshot();
+        assert(s.name == "lazy_array_stats");
+        assert(s.init_count == 2);
+        assert(registered("lazy_array_stats"));
+    }
+    assert(!registered("lazy_array_stats"));
+    std::cout << "[OK] test_named_stats" << std::endl;
+}
+
+/**
+ * @brief 测试槽位之间共享统计信息时的记账。
+ *
+ * 验证：
+ * 1. 每个槽位的初始化计为一次初始化，不计为 reload。
+ * 2. 估算字节数是所有槽位之和，而不是最后一个槽位的值。
+ * 3. 一个槽位的初始化完成时，仍在初始化的其他槽位继续被报告为进行中。
+ */
+void test_named_slot_accounting()
+{
+    LazyArray<std::int64_t> arr("lazy_array_slots", 100, [](std::size_t i) { return static_cast<std::int64_t>(i); });
+    for (std::size_t i = 0; i < arr.size(); ++i)
+        arr.get(i);
+    auto s = arr.stats()->snapshot();
+    assert(s.init_count == 100);
+    assert(s.reload_count == 0);
+    assert(s.estimated_bytes == 100 * sizeof(std::int64_t));
+    assert(!s.initializing && s.initializing_count == 0);
+
+    std::promise<void> entered;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    LazyArray<int> blocking("lazy_array_in_flight", 2, [&](std::size_t i) {
+        if (i == 0)
+        {
+            entered.set_value();
+            released.wait();
+        }
+        return static_cast<int>(i);
+    });
+    std::thread stuck([&] { blocking.get(0); });
+    entered.get_future().wait();
+    blocking.get(1);
+    s = blocking.stats()->snapshot();
+    assert(s.init_count == 1);
+    assert(s.initializing && s.initializing_count == 1);
+
+    release.set_value();
+    stuck.join();
+    s = blocking.stats()->snapshot();
+    assert(s.init_count == 2);
+    assert(!s.initializing && s.initializing_count == 0);
+    assert(s.estimated_bytes == 2 * sizeof(int));
+    std::cout << "[OK] test_named_slot_accounting" << std::endl;
+}
+
+int main()
+{
+    test_basic();
+    test_concurrent();
+    test_failure_then_retry();
+    test_for_each_initialized();
+    test_named_stats();
+    test_named_slot_accounting();
+    return 0;
+}
@@ -0,0 +1,217 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/lazy_fields.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+namespace
+{
+    std::atomic<int> hash_calls{0};
+    std::atomic<int> upper_calls{0};
+    std::atomic<int> words_calls{0};
+
+    class Document;
+
+    std::size_t count_words(const Document& doc);
+
+    /// @brief 无状态可调用类型，值类型由 using type 指定
+    struct Flaky
+    {
+        using type = int;
+
+        static inline int attempts = 0;
+
+        int operator()(const Document&) const
+        {
+            if (++attempts == 1)
+                throw std::runtime_error("first attempt fails");
+            return attempts;
+        }
+    };
+
+    class Document
+    {
+    public:
+        explicit Document(std::string text) : text_(std::move(text))
+        {
+        }
+
+        std::size_t hash() const { return fields_.get<Hash>(*this); }
+
+        const std::string& upper() const { return fields_.get<Upper>(*this); }
+
+        std::size_t words() const { return fields_.get<2>(*this); }
+
+        int flaky() const { return fields_.get<Flaky>(*this); }
+
+        void set_text(std::string text)
+        {
+            text_ = std::move(text);
+            fields_.reset();
+        }
+
+        const std::string& text() const { return text_; }
+
+        std::size_t compute_hash() const
+        {
+            hash_calls++;
+            return std::hash<std::string>{}(text_);
+        }
+
+        std::string compute_upper() const
+        {
+            upper_calls++;
+            std::string s = text_;
+            std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::toupper(c); });
+            return s;
+        }
+
+        using Hash = LazyField<&Document::compute_hash>;
+        using Upper = LazyField<&Document::compute_upper>;
+        using Words = LazyField<&count_words>;
+        using Fields = LazyFields<Hash, Upper, Words, Flaky>;
+
+        const Fields& fields() const { return fields_; }
+
+    private:
+        std::string text_;
+        Fields fields_;
+    };
+
+    std::size_t count_words(const Document& doc)
+    {
+        words_calls++;
+        const std::string& t = doc.text();
+        return static_cast<std::size_t>(std::count(t.begin(), t.end(), ' ')) + (t.empty() ? 0 : 1);
+    }
+}
+
+// 只为值本身和一个状态字付费
+static_assert(sizeof(LazyFields<LazyField<&count_words>>) == sizeof(std::uint64_t) + sizeof(std::size_t));
+static_assert(sizeof(Document::Fields) <=
+              sizeof(std::uint64_t) + 3 * sizeof(std::size_t) + sizeof(std::string) + sizeof(int) + 4);
+
+/**
+ * @brief 测试字段按需计算。
+ *
+ * 验证：
+ * 1. 成员函数指针和自由函数指针都可以作为初始化函数，按类型或下标访问。
+ * 2. 每个字段只计算一次，未访问的字段不会计算。
+ */
+void test_on_demand()
+{
+    hash_calls = upper_calls = words_calls = 0;
+    Document doc("hello lazy world");
+    assert(doc.fields().initialized_count() == 0);
+
+    assert(doc.upper() == "HELLO LAZY WORLD");
+    assert(doc.upper() == "HELLO LAZY WORLD");
+    assert(doc.words() == 3);
+    assert(upper_calls == 1);
+    assert(words_calls == 1);
+    assert(hash_calls == 0);
+    assert(!doc.fields().is_initialized<Document::Hash>());
+    assert(doc.fields().is_initialized<Document::Upper>());
+    assert(doc.fields().initialized_count() == 2);
+
+    assert(doc.hash() == std::hash<std::string>{}("hello lazy world"));
+    assert(hash_calls == 1);
+    std::cout << "[OK] test_on_demand" << std::endl;
+}
+
+/**
+ * @brief 测试初始化失败后重试。
+ */
+void test_failure_then_retry()
+{
+    Document doc("x");
+    try
+    {
+        doc.flaky();
+        assert(false);
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+    assert(!doc.fields().is_initialized<Flaky>());
+    assert(doc.flaky() == 2);
+    assert(doc.flaky() == 2);
+    std::cout << "[OK] test_failure_then_retry" << std::endl;
+}
+
+/**
+ * @brief 测试复制和重置。
+ *
+ * 验证：
+ * 1. 复制得到未初始化的字段，副本按需重新计算。
+ * 2. reset 之后字段重新计算。
+ */
+void test_copy_and_reset()
+{
+    upper_calls = 0;
+    Document doc("abc");
+    assert(doc.upper() == "ABC");
+    Document copy = doc;
+    assert(copy.fields().initialized_count() == 0);
+    assert(copy.upper() == "ABC");
+    assert(upper_calls == 2);
+
+    doc.set_text("xyz");
+    assert(doc.fields().initialized_count() == 0);
+    assert(doc.upper() == "XYZ");
+    copy = doc;
+    assert(copy.fields().initialized_count() == 0);
+    std::cout << "[OK] test_copy_and_reset" << std::endl;
+}
+
+/**
+ * @brief 测试多个线程同时访问同一个对象的不同字段。
+ *
+ * 验证：每个字段只计算一次，所有线程看到相同的值。
+ */
+void test_concurrent()
+{
+    for (int round = 0; round < 50; ++round)
+    {
+        hash_calls = upper_calls = words_calls = 0;
+        Document doc("the quick brown fox");
+        std::atomic<bool> ok{true};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 6; ++t)
+        {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 3; ++i)
+                {
+                    if (doc.words() != 4 || doc.upper() != "THE QUICK BROWN FOX" ||
+                        doc.hash() != std::hash<std::string>{}("the quick brown fox"))
+                        ok = false;
+                }
+            });
+        }
+        for (auto& th : threads)
+            th.join();
+        assert(ok);
+        assert(hash_calls == 1 && upper_calls == 1 && words_calls == 1);
+    }
+    std::cout << "[OK] test_concurrent" << std::endl;
+}
+
+int main()
+{
+    test_on_demand();
+    test_failure_then_retry();
+    test_copy_and_reset();
+    test_concurrent();
+    return 0;
+}
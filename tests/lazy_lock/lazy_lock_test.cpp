@@ -0,0 +1,154 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/lazy_lock.h>
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+/**
+ * @brief 测试 LazyMutex 在第一次加锁时初始化，并串行化修改。
+ */
+void test_lazy_mutex()
+{
+    std::atomic<int> inits{0};
+    LazyMutex<std::vector<int>> values("lock.values", [&] {
+        ++inits;
+        return std::vector<int>{};
+    });
+    assert(!values.is_initialized());
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t)
+    {
+        workers.emplace_back([&] {
+            for (int i = 0; i < 1000; ++i)
+                values.lock()->push_back(i);
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+
+    assert(inits == 1);
+    assert(values.is_initialized());
+    assert(values.lock()->size() == 4000);
+    assert(values.stats() && values.stats()->snapshot().init_count == 1);
+    std::cout << "[OK] test_lazy_mutex" << std::endl;
+}
+
+/**
+ * @brief 测试 LazyRwLock 的读写互斥。
+ *
+ * 验证：
+ * 1. 第一次加锁（无论读写）时初始化，只初始化一次。
+ * 2. 读者永远看不到写到一半的值：写者在持有写锁期间先后修改两个字段，读者检查两者一致。
+ * 3. 多个读者可以同时持有读锁。
+ */
+void test_rwlock_consistency()
+{
+    struct Pair
+    {
+        long a = 0;
+        long b = 0;
+    };
+    std::atomic<int> inits{0};
+    LazyRwLock<Pair> pair([&] {
+        ++inits;
+        return Pair{};
+    });
+
+    {
+        auto r1 = pair.read();
+        auto r2 = pair.read();
+        assert(r1->a == 0 && r2->b == 0);
+    }
+    assert(inits == 1);
+
+    std::atomic<bool> done{false};
+    std::atomic<bool> ok{true};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t)
+    {
+        readers.emplace_back([&] {
+            while (!done.load())
+            {
+                auto r = pair.read();
+                if (r->a != r->b)
+                    ok = false;
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 2; ++t)
+    {
+        writers.emplace_back([&] {
+            for (int i = 0; i < 500; ++i)
+            {
+                auto w = pair.write();
+                w->a++;
+                std::this_thread::yield();
+                w->b++;
+            }
+        });
+    }
+    for (auto& w : writers)
+        w.join();
+    done = true;
+    for (auto& r : readers)
+        r.join();
+
+    assert(ok);
+    auto r = pair.read();
+    assert(r->a == 1000 && r->b == 1000);
+    std::cout << "[OK] test_rwlock_consistency" << std::endl;
+}
+
+/**
+ * @brief 测试初始化失败后下一次加锁重新初始化，以及守卫的移动。
+ */
+void test_rwlock_init_failure()
+{
+    int attempts = 0;
+    LazyRwLock<std::string> name([&] {
+        if (++attempts == 1)
+            throw std::runtime_error("boom");
+        return std::string("ready");
+    });
+    bool thrown = false;
+    try
+    {
+        (void)name.write();
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(!name.is_initialized());
+
+    {
+        auto w = name.write();
+        auto moved = std::move(w);
+        moved->append("!");
+    }
+    auto r = name.read();
+    auto moved = std::move(r);
+    assert(*moved == "ready!");
+    assert(attempts == 2);
+    std::cout << "[OK] test_rwlock_init_failure" << std::endl;
+}
+
+int main()
+{
+    test_lazy_mutex();
+    test_rwlock_consistency();
+    test_rwlock_init_failure();
+    return 0;
+}
@@ -0,0 +1,200 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/lazy_map.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+/**
+ * @brief 测试基本的按键计算。
+ *
+ * 验证：
+ * 1. 计算函数收到键，只在第一次访问时执行。
+ * 2. find / contains 不会触发计算。
+ */
+void test_basic()
+{
+    LazyMap<std::string, std::size_t> map;
+    int calls = 0;
+    auto length = [&](const std::string& key) {
+        ++calls;
+        return key.size();
+    };
+
+    assert(map.find("hello") == nullptr);
+    assert(map.get_or_compute("hello", length) == 5);
+    assert(map.get_or_compute("hello", length) == 5);
+    assert(map.get_or_compute("hi", [] { return std::size_t{42}; }) == 42);
+    assert(calls == 1);
+    assert(map.contains("hello"));
+    assert(*map.find("hi") == 42);
+    assert(!map.contains("absent"));
+    assert(map.size() == 2);
+    std::cout << "[OK] test_basic" << std::endl;
+}
+
+/**
+ * @brief 测试多个线程同时访问重叠的键。
+ *
+ * 验证：
+ * 1. 每个键只计算一次。
+ * 2. 所有线程看到相同的值（同一个对象）。
+ */
+void test_concurrent_single_flight()
+{
+    constexpr int kKeys = 2000;
+    LazyMap<int, int> map(4);
+    std::vector<std::atomic<int>> calls(kKeys);
+    std::vector<std::atomic<const int*>> seen(kKeys);
+    std::atomic<bool> ok{true};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([&, t] {
+            for (int k = 0; k < kKeys; ++k)
+            {
+                const int key = (k * 13 + t * 101) % kKeys;
+                const int& v = map.get_or_compute(key, [&](int x) {
+                    calls[static_cast<std::size_t>(x)].fetch_add(1);
+                    return x * 2;
+                });
+                const int* expected = nullptr;
+                if (v != key * 2 ||
+                    (!seen[static_cast<std::size_t>(key)].compare_exchange_strong(expected, &v) && expected != &v))
+                    ok = false;
+            }
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    assert(ok);
+    for (const auto& c : calls)
+        assert(c.load() == 1);
+    assert(map.size() == kKeys);
+    std::cout << "[OK] test_concurrent_single_flight" << std::endl;
+}
+
+/**
+ * @brief 测试扩容后引用仍然有效。
+ */
+void test_stable_references()
+{
+    LazyMap<int, std::string> map(1);
+    const std::string& first = map.get_or_compute(0, [](int) { return std::string("zero"); });
+    for (int i = 1; i < 10000; ++i)
+        map.get_or_compute(i, [](int x) { return std::to_string(x); });
+    assert(&first == map.find(0));
+    assert(first == "zero");
+    assert(*map.find(9999) == "9999");
+    std::cout << "[OK] test_stable_references" << std::endl;
+}
+
+/**
+ * @brief 测试计算失败后重试。
+ */
+void test_failure_then_retry()
+{
+    LazyMap<int, int> map;
+    int attempts = 0;
+    auto fn = [&](int x) {
+        if (++attempts == 1)
+            throw std::runtime_error("first attempt fails");
+        return x + 1;
+    };
+
+    try
+    {
+        map.get_or_compute(7, fn);
+        assert(false);
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+    assert(!map.contains(7));
+    assert(map.get_or_compute(7, fn) == 8);
+    assert(attempts == 2);
+    std::cout << "[OK] test_failure_then_retry" << std::endl;
+}
+
+/**
+ * @brief 测试一个键的慢计算不会阻塞其他键。
+ *
+ * 验证：
+ * 1. 计算进行中时，已存在的键可以读取，新键可以插入并计算。
+ * 2. 同一个键的其他调用者等待并共享结果。
+ */
+void test_slow_key_does_not_block_others()
+{
+    LazyMap<int, int> map(1);
+    map.get_or_compute(1, [](int) { return 10; });
+
+    std::promise<void> started;
+    std::promise<void> release;
+    auto slow = std::async(std::launch::async, [&] {
+        return map.get_or_compute(2, [&](int) {
+            started.set_value();
+            release.get_future().wait();
+            return 20;
+        });
+    });
+    started.get_future().wait();
+
+    assert(map.get_or_compute(1, [](int) { return -1; }) == 10);
+    assert(map.get_or_compute(3, [](int) { return 30; }) == 30);
+    assert(!map.contains(2));
+
+    auto waiter = std::async(std::launch::async, [&] { return map.get_or_compute(2, [](int) { return -1; }); });
+    assert(waiter.wait_for(std::chrono::milliseconds(20)) == std::future_status::timeout);
+    release.set_value();
+    assert(slow.get() == 20);
+    assert(waiter.get() == 20);
+    std::cout << "[OK] test_slow_key_does_not_block_others" << std::endl;
+}
+
+/**
+ * @brief 测试遍历已计算的键值。
+ */
+void test_for_each()
+{
+    LazyMap<int, int> map;
+    for (int i = 0; i < 100; ++i)
+        map.get_or_compute(i, [](int x) { return x * x; });
+    try
+    {
+        map.get_or_compute(1000, [](int) -> int { throw std::runtime_error("fails"); });
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+
+    std::map<int, int> seen;
+    map.for_each([&](const int& key, int& value) { seen[key] = value; });
+    assert(seen.size() == 100);
+    for (const auto& [key, value] : seen)
+        assert(value == key * key);
+    assert(map.size() == 101);
+    std::cout << "[OK] test_for_each" << std::endl;
+}
+
+int main()
+{
+    test_basic();
+    test_concurrent_single_flight();
+    test_stable_references();
+    test_failure_then_retry();
+    test_slow_key_does_not_block_others();
+    test_for_each();
+    return 0;
+}
@@ -78,9 +78,36 @@ void test_lazy_static_void() {
 }
 
 
+// 使用 LAZY_STATIC_NAMED / LAZY_STATIC_VOID_NAMED 定义登记到 LazyRegistry 的变量
+LAZY_STATIC_NAMED(int, named_lazy_value, 7);
+LAZY_STATIC_VOID_NAMED(named_lazy_void, side_effect_counter += 10);
+
+/**
+ * @brief 测试具名宏与匿名宏的登记行为。
+ *
+ * 验证：
+ * 1. LAZY_STATIC / LAZY_STATIC_VOID 不登记，没有统计信息。
+ * 2. LAZY_STATIC_NAMED / LAZY_STATIC_VOID_NAMED 以变量名登记。
+ */
+void test_lazy_static_named() {
+    assert(static_lazy_value.stats() == nullptr);
+    assert(lazy_void.stats() == nullptr);
+
+    assert(*named_lazy_value == 7);
+    assert(named_lazy_value.stats() != nullptr);
+    assert(named_lazy_value.stats()->name() == "named_lazy_value");
+    assert(named_lazy_value.stats()->snapshot().init_count == 1);
+
+    named_lazy_void.get();
+    assert(named_lazy_void.stats() != nullptr);
+    assert(named_lazy_void.stats()->name() == "named_lazy_void");
+    std::cout << "[OK] test_lazy_static_named" << std::endl;
+}
+
 int main() {
     test_lazy_static();
     test_thread_local_lazy();
     test_lazy_static_void();
+    test_lazy_static_named();
     return 0;
 }
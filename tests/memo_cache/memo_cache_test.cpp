@@ -0,0 +1,247 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/memo_cache.h>
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+/**
+ * @brief 测试命中、未命中和计数器。
+ */
+void test_hit_and_miss()
+{
+    MemoCache<int, std::string> cache(100);
+    int calls = 0;
+    auto fn = [&](int key) {
+        ++calls;
+        return std::to_string(key);
+    };
+
+    assert(!cache.get(1).has_value());
+    assert(cache.get_or_compute(1, fn) == "1");
+    assert(cache.get_or_compute(1, fn) == "1");
+    assert(cache.get_or_compute(2, [] { return std::string("two"); }) == "two");
+    assert(*cache.get(2) == "two");
+    assert(calls == 1);
+
+    auto s = cache.stats();
+    assert(s.hits == 2);
+    assert(s.misses == 2);
+    assert(s.evictions == 0);
+    assert(s.size == 2);
+    assert(s.weight == 2);
+    std::cout << "[OK] test_hit_and_miss" << std::endl;
+}
+
+/**
+ * @brief 测试容量上限。
+ *
+ * 验证：
+ * 1. 条目数量不超过容量，超出的部分被淘汰并计数。
+ * 2. 被淘汰的键再次访问时重新计算。
+ */
+void test_capacity_bound()
+{
+    MemoCache<int, int> cache(64, 4);
+    for (int i = 0; i < 1000; ++i)
+        assert(cache.get_or_compute(i, [](int k) { return k * 2; }) == i * 2);
+    auto s = cache.stats();
+    assert(s.size <= cache.capacity());
+    assert(s.evictions == 1000 - s.size);
+    assert(!cache.get(0).has_value());
+    assert(cache.get_or_compute(0, [](int) { return -1; }) == -1);
+    std::cout << "[OK] test_capacity_bound" << std::endl;
+}
+
+/**
+ * @brief 测试扫描抗性。
+ *
+ * 验证：一次性扫描大量新键之后，扫描之前被反复访问的热点键仍在缓存中。
+ */
+void test_scan_resistance()
+{
+    MemoCache<int, int> cache(100, 1);
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int k = 0; k < 50; ++k)
+            cache.get_or_compute(k, [](int x) { return x; });
+    }
+    for (int k = 1000; k < 3000; ++k)
+        cache.get_or_compute(k, [](int x) { return x; });
+
+    int survivors = 0;
+    for (int k = 0; k < 50; ++k)
+        survivors += cache.get(k).has_value();
+    assert(survivors == 50);
+    assert(cache.stats().size <= 100);
+    std::cout << "[OK] test_scan_resistance" << std::endl;
+}
+
+/**
+ * @brief 测试按权重计算容量。
+ */
+void test_weighted_entries()
+{
+    MemoCache<int, std::string> cache(100, 1, [](const int&, const std::string& v) { return v.size(); });
+    for (int i = 0; i < 10; ++i)
+        cache.get_or_compute(i, [](int) { return std::string(30, 'x'); });
+    auto s = cache.stats();
+    assert(s.weight <= 100);
+    assert(s.size == 3);
+    assert(s.evictions == 7);
+    std::cout << "[OK] test_weighted_entries" << std::endl;
+}
+
+/**
+ * @brief 测试计算失败和移除。
+ *
+ * 验证：
+ * 1. 计算失败时异常传播给调用者，键不留在缓存中，下一次调用重新计算。
+ * 2. erase 之后键重新计算。
+ */
+void test_failure_and_erase()
+{
+    MemoCache<int, int> cache(10);
+    int attempts = 0;
+    auto fn = [&](int key) {
+        if (++attempts == 1)
+            throw std::runtime_error("first attempt fails");
+        return key + attempts;
+    };
+    try
+    {
+        cache.get_or_compute(5, fn);
+        assert(false);
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+    assert(!cache.get(5).has_value());
+    assert(cache.get_or_compute(5, fn) == 7);
+
+    assert(cache.erase(5));
+    assert(!cache.erase(5));
+    assert(cache.stats().size == 0);
+    assert(cache.get_or_compute(5, fn) == 8);
+    std::cout << "[OK] test_failure_and_erase" << std::endl;
+}
+
+/**
+ * @brief 测试并发访问。
+ *
+ * 验证：
+ * 1. 容量足够时，每个键只计算一次。
+ * 2. 容量很小、频繁淘汰时，读到的值始终正确。
+ */
+void test_concurrent()
+{
+    {
+        constexpr int kKeys = 500;
+        MemoCache<int, int> cache(kKeys * 2);
+        std::vector<std::atomic<int>> calls(kKeys);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t)
+        {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < kKeys * 4; ++i)
+                {
+                    const int key = (i * 7 + t) % kKeys;
+                    const int v = cache.get_or_compute(key, [&](int k) {
+                        calls[static_cast<std::size_t>(k)]++;
+                        return k;
+                    });
+                    assert(v == key);
+                    (void)v;
+                }
+            });
+        }
+        for (auto& th : threads)
+            th.join();
+        for (const auto& c : calls)
+            assert(c.load() == 1);
+    }
+    {
+        MemoCache<int, std::string> cache(32, 2);
+        std::atomic<bool> ok{true};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t)
+        {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < 20000; ++i)
+                {
+                    const int key = (i * 31 + t * 17) % 200;
+                    if (cache.get_or_compute(key, [](int k) { return std::to_string(k); }) != std::to_string(key))
+                        ok = false;
+                    if (i % 97 == 0)
+                        cache.erase(key);
+                }
+            });
+        }
+        for (auto& th : threads)
+            th.join();
+        assert(ok);
+        assert(cache.stats().size <= cache.capacity());
+    }
+    std::cout << "[OK] test_concurrent" << std::endl;
+}
+
+/**
+ * @brief 测试无锁读取与淘汰并发时的内存回收。
+ *
+ * 验证：
+ * 1. 读取者持续调用 get() 时，写入方不断插入新键迫使条目被淘汰，读到的值始终完整。
+ * 2. 被淘汰的条目在读取者离开之前不会被释放（在 ASan / TSan 下运行时不报告释放后使用）。
+ */
+void test_reclaim_under_readers()
+{
+    // 超过短字符串优化的长度，值位于堆上，释放后被复用时内容会变化
+    auto value_of = [](int k) { return std::string(64, static_cast<char>('a' + k % 26)); };
+    MemoCache<int, std::string> cache(8, 1);
+    std::atomic<bool> stop{false};
+    std::atomic<bool> ok{true};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t)
+    {
+        readers.emplace_back([&, t] {
+            for (int i = 0; !stop.load(std::memory_order_relaxed); ++i)
+            {
+                const int key = (i + t) % 16;
+                if (auto v = cache.get(key); v && *v != value_of(key))
+                    ok = false;
+            }
+        });
+    }
+    for (int i = 0; i < 20000; ++i)
+    {
+        const int key = i % 16 < 8 ? i % 16 : 16 + i;
+        if (cache.get_or_compute(key, value_of) != value_of(key))
+            ok = false;
+        if (i % 64 == 0)
+            std::this_thread::yield();
+    }
+    stop = true;
+    for (auto& th : readers)
+        th.join();
+    assert(ok);
+    assert(cache.stats().evictions > 0);
+    std::cout << "[OK] test_reclaim_under_readers" << std::endl;
+}
+
+int main()
+{
+    test_hit_and_miss();
+    test_capacity_bound();
+    test_scan_resistance();
+    test_weighted_entries();
+    test_failure_and_erase();
+    test_concurrent();
+    test_reclaim_under_readers();
+    return 0;
+}
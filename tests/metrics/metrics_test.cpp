@@ -0,0 +1,130 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/macros.h>
+#include <cxxlazy/components/metrics.h>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+LAZY_STATIC_NAMED(std::string, greeting, std::string("hello"));
+
+/**
+ * @brief 判断渲染结果中是否包含某一行
+ */
+bool has_line(const std::string& text, const std::string& line)
+{
+    return text.find(line + "\n") != std::string::npos;
+}
+
+/**
+ * @brief 测试具名 Lazy 的统计信息。
+ *
+ * 验证：
+ * 1. 初始化、失败、重置、重新加载都会被计数。
+ * 2. 匿名 Lazy 不登记统计信息。
+ */
+void test_cell_stats()
+{
+    int attempts = 0;
+    Lazy<int> value("stats_value", [&] {
+        if (++attempts == 1)
+            throw std::runtime_error("first attempt fails");
+        return attempts;
+    });
+
+    try
+    {
+        value.get();
+        assert(false);
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+    assert(value.get() == 2);
+    value.reset();
+    assert(value.get() == 3);
+
+    auto s = value.stats()->snapshot();
+    assert(s.name == "stats_value");
+    assert(s.initialized);
+    assert(s.init_count == 2);
+    assert(s.failure_count == 1);
+    assert(s.reset_count == 1);
+    assert(s.reload_count == 1);
+    assert(s.estimated_bytes == sizeof(int));
+
+    Lazy<int> anonymous([] { return 1; });
+    assert(anonymous.stats() == nullptr);
+
+    std::cout << "[OK] test_cell_stats" << std::endl;
+}
+
+/**
+ * @brief 测试多线程竞争初始化时的等待计数。
+ */
+void test_wait_count()
+{
+    Lazy<int> slow("slow_value", [] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return 7;
+    });
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+        threads.emplace_back([&] { assert(*slow == 7); });
+    for (auto& t : threads)
+        t.join();
+
+    auto s = slow.stats()->snapshot();
+    assert(s.init_count == 1);
+    assert(s.wait_count >= 1);
+    assert(s.init_ns_max >= 100'000'000ULL);
+
+    std::cout << "[OK] test_wait_count" << std::endl;
+}
+
+/**
+ * @brief 测试 Prometheus 文本格式导出。
+ *
+ * 验证：
+ * 1. LAZY_STATIC_NAMED 以变量名登记。
+ * 2. 标签值被正确转义。
+ * 3. 单元析构后不再出现在导出结果中。
+ */
+void test_render_prometheus()
+{
+    assert(*greeting == "hello");
+    {
+        Lazy<int> quoted("say \"hi\"", [] { return 1; });
+        quoted.get();
+
+        std::string text = render_prometheus();
+        std::cout << text;
+        assert(has_line(text, "# TYPE cxxlazy_initializations_total counter"));
+        assert(has_line(text, "cxxlazy_initialized{lazy=\"greeting\"} 1"));
+        assert(has_line(text, "cxxlazy_initializations_total{lazy=\"greeting\"} 1"));
+        assert(has_line(text, "cxxlazy_init_duration_seconds_count{lazy=\"greeting\"} 1"));
+        assert(has_line(text, "cxxlazy_initialized{lazy=\"say \\\"hi\\\"\"} 1"));
+    }
+
+    std::string text = render_prometheus();
+    assert(text.find("say \\\"hi\\\"") == std::string::npos);
+    assert(has_line(text, "cxxlazy_cells 1"));
+    assert(has_line(text, "cxxlazy_cells_initialized 1"));
+
+    std::cout << "[OK] test_render_prometheus" << std::endl;
+}
+
+int main()
+{
+    test_cell_stats();
+    test_wait_count();
+    test_render_prometheus();
+    return 0;
+}
@@ -0,0 +1,122 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/numa_lazy.h>
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+/**
+ * @brief 测试内核 CPU 列表格式的解析。
+ */
+void test_parse_cpu_list()
+{
+    assert(detail::parse_cpu_list("").empty());
+    assert((detail::parse_cpu_list("0") == std::vector<std::size_t>{0}));
+    assert((detail::parse_cpu_list("0-3,8,10-11\n") == std::vector<std::size_t>{0, 1, 2, 3, 8, 10, 11}));
+    assert((detail::parse_cpu_list("x,2,5-4,7") == std::vector<std::size_t>{2, 7}));
+    std::cout << "[OK] test_parse_cpu_list" << std::endl;
+}
+
+/**
+ * @brief 测试拓扑查询的基本性质。
+ */
+void test_topology()
+{
+    const std::size_t nodes = detail::numa_node_count();
+    assert(nodes >= 1);
+    for (std::size_t cpu = 0; cpu < detail::cpu_count(); ++cpu)
+        assert(detail::numa_node_of(cpu) < nodes);
+    assert(detail::numa_node_of(detail::cpu_count() + 100) == 0);
+    assert(detail::current_numa_node() < nodes);
+    std::cout << "[OK] test_topology" << std::endl;
+}
+
+/**
+ * @brief 测试复制模式。
+ *
+ * 验证：
+ * 1. 构造时不创建任何副本，第一次读取只创建本节点的副本。
+ * 2. 复制模式下初始化函数只执行一次，其余节点的副本内容相同、地址不同。
+ * 3. 每个副本计为一次初始化，没有 reload，估算字节数为各副本之和，全部完成后不再报告进行中。
+ */
+void test_copy_mode()
+{
+    std::atomic<int> inits{0};
+    NumaLazy<std::map<std::string, int>> routes("numa.routes", [&] {
+        ++inits;
+        return std::map<std::string, int>{{"a", 1}, {"b", 2}};
+    });
+    assert(routes.replica_count() == detail::numa_node_count());
+    assert(!routes.is_initialized());
+
+    assert(routes->at("b") == 2);
+    assert(routes.is_initialized());
+    assert(routes.initialized_count() == 1);
+    assert(&*routes == &routes.get());
+
+    std::vector<std::thread> readers;
+    for (std::size_t node = 0; node < routes.replica_count(); ++node)
+        readers.emplace_back([&, node] { assert(routes.replica(node).size() == 2); });
+    for (auto& r : readers)
+        r.join();
+    assert(inits == 1);
+    assert(routes.initialized_count() == routes.replica_count());
+    for (std::size_t node = 1; node < routes.replica_count(); ++node)
+        assert(&routes.replica(node) != &routes.replica(0));
+    const auto s = routes.stats()->snapshot();
+    assert(s.init_count == routes.replica_count());
+    assert(s.reload_count == 0);
+    assert(s.estimated_bytes == routes.replica_count() * sizeof(std::map<std::string, int>));
+    assert(!s.initializing && s.initializing_count == 0);
+    std::cout << "[OK] test_copy_mode" << std::endl;
+}
+
+/**
+ * @brief 测试构建模式、不可复制的类型以及初始化失败后的重试。
+ */
+void test_build_mode()
+{
+    int inits = 0;
+    NumaLazy<int> built([&] { return ++inits; }, ReplicaMode::Build);
+    for (std::size_t node = 0; node < built.replica_count(); ++node)
+        assert(built.replica(node) == static_cast<int>(node) + 1);
+    assert(inits == static_cast<int>(built.replica_count()));
+
+    int attempts = 0;
+    NumaLazy<std::unique_ptr<int>> unique([&] {
+        if (++attempts == 1)
+            throw std::runtime_error("boom");
+        return std::make_unique<int>(5);
+    });
+    bool thrown = false;
+    try
+    {
+        (void)unique.get();
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(!unique.is_initialized());
+    assert(**unique == 5);
+    std::cout << "[OK] test_build_mode" << std::endl;
+}
+
+int main()
+{
+    test_parse_cpu_list();
+    test_topology();
+    test_copy_mode();
+    test_build_mode();
+    return 0;
+}
@@ -0,0 +1,127 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/per_cpu_lazy.h>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+/**
+ * @brief 测试分片按需初始化。
+ *
+ * 验证：
+ * 1. 构造时不初始化任何分片，分片数量等于 CPU 数量。
+ * 2. local() 只初始化当前 CPU 的分片，初始化函数收到分片的 CPU 编号。
+ * 3. 按 CPU 编号访问的分片彼此独立。
+ */
+void test_lazy_shards()
+{
+    std::atomic<int> inits{0};
+    PerCpuLazy<std::size_t> values([&](std::size_t cpu) {
+        ++inits;
+        return cpu;
+    });
+    assert(values.shard_count() == detail::cpu_count());
+    assert(values.initialized_count() == 0);
+    assert(values.try_get(0) == nullptr);
+
+    const std::size_t cpu = values.local();
+    assert(cpu < values.shard_count());
+    assert(inits == 1);
+    assert(values.initialized_count() == 1);
+    assert(values.try_get(cpu) && *values.try_get(cpu) == cpu);
+
+    for (std::size_t i = 0; i < values.shard_count(); ++i)
+        assert(values.get(i) == i);
+    assert(inits == static_cast<int>(values.shard_count()));
+    assert(values.initialized_count() == values.shard_count());
+    std::cout << "[OK] test_lazy_shards" << std::endl;
+}
+
+/**
+ * @brief 测试并发修改与汇总。
+ *
+ * 验证：
+ * 1. 多个线程通过 with_local() 累加计数，汇总结果等于总次数。
+ * 2. 每个分片只初始化一次。
+ * 3. 共享的统计信息按分片记账：没有 reload，估算字节数为各分片之和。
+ */
+void test_aggregate()
+{
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 50000;
+    std::atomic<int> inits{0};
+    PerCpuLazy<std::uint64_t> counter("per_cpu.counter", [&](std::size_t) {
+        ++inits;
+        return std::uint64_t{0};
+    });
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        workers.emplace_back([&] {
+            for (int i = 0; i < kPerThread; ++i)
+                counter.with_local([](std::uint64_t& n) { ++n; });
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+
+    std::uint64_t total = 0;
+    counter.aggregate([&](const std::uint64_t& n) { total += n; });
+    assert(total == static_cast<std::uint64_t>(kThreads) * kPerThread);
+    assert(inits == static_cast<int>(counter.initialized_count()));
+    assert(counter.stats() && counter.stats()->snapshot().init_count == counter.initialized_count());
+
+    // 所有分片初始化后：每个分片一次初始化，没有 reload，估算字节数按分片累加
+    for (std::size_t i = 0; i < counter.shard_count(); ++i)
+        counter.get(i);
+    const auto s = counter.stats()->snapshot();
+    assert(s.init_count == counter.shard_count());
+    assert(s.reload_count == 0);
+    assert(s.estimated_bytes % counter.shard_count() == 0);
+    assert(s.estimated_bytes / counter.shard_count() >= sizeof(std::uint64_t));
+    assert(!s.initializing);
+    std::cout << "[OK] test_aggregate" << std::endl;
+}
+
+/**
+ * @brief 测试初始化失败后分片保持未初始化，下一次访问重新尝试。
+ */
+void test_init_failure()
+{
+    int attempts = 0;
+    PerCpuLazy<int> values([&](std::size_t) -> int {
+        if (++attempts == 1)
+            throw std::runtime_error("boom");
+        return 7;
+    });
+    bool thrown = false;
+    try
+    {
+        values.get(0);
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(values.try_get(0) == nullptr);
+    assert(values.get(0) == 7);
+    assert(attempts == 2);
+    std::cout << "[OK] test_init_failure" << std::endl;
+}
+
+int main()
+{
+    test_lazy_shards();
+    test_aggregate();
+    test_init_failure();
+    return 0;
+}
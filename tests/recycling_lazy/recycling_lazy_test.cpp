@@ -0,0 +1,135 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/macros.h>
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+std::atomic<int> buffer_inits{0};
+
+// 线程退出时清空缓冲区并归还到池中，池最多保存 2 个
+THREAD_LOCAL_LAZY_RECYCLED_RESET(std::vector<int>, scratch, (++buffer_inits, std::vector<int>(1024)), 2,
+                                 [](std::vector<int>& v) { v.assign(v.size(), 0); });
+
+/**
+ * @brief 测试线程退出后值被下一个线程复用。
+ *
+ * 验证：
+ * 1. 第二个线程拿到的是第一个线程留下的值（地址相同），初始化表达式只执行一次。
+ * 2. 值在归还时被重置。
+ */
+void test_reuse_across_threads()
+{
+    const int* first = nullptr;
+    std::thread([&] {
+        assert(!scratch.is_recycled());
+        scratch->at(0) = 42;
+        first = scratch->data();
+    }).join();
+    assert(scratch_pool.size() == 1);
+
+    std::thread([&] {
+        assert(scratch->data() == first);
+        assert(scratch.is_recycled());
+        assert(scratch->at(0) == 0);
+    }).join();
+    assert(buffer_inits == 1);
+    assert(scratch_pool.reused_count() == 1);
+    std::cout << "[OK] test_reuse_across_threads" << std::endl;
+}
+
+/**
+ * @brief 测试对象池的容量上限。
+ *
+ * 验证：
+ * 1. 同时存活的线程多于容量时，多出来的值在线程退出时被销毁。
+ * 2. 未访问过值的线程不向池中归还任何东西。
+ */
+void test_bounded_pool()
+{
+    RecyclePool<int> pool(2);
+    {
+        RecyclingLazy<int> a(pool, [] { return 1; });
+        RecyclingLazy<int> b(pool, [] { return 2; });
+        RecyclingLazy<int> c(pool, [] { return 3; });
+        RecyclingLazy<int> unused(pool, [] { return 4; });
+        assert(*a + *b + *c == 6);
+    }
+    assert(pool.size() == 2);
+    assert(pool.discarded_count() == 1);
+
+    RecyclingLazy<int> d(pool, [] { return 5; });
+    RecyclingLazy<int> e(pool, [] { return 6; });
+    RecyclingLazy<int> f(pool, [] { return 7; });
+    assert(d.is_recycled() == false && !d.is_initialized());
+    assert(*d != 5 && *e != 6 && *f == 7);
+    assert(pool.size() == 0);
+    std::cout << "[OK] test_bounded_pool" << std::endl;
+}
+
+/**
+ * @brief 测试重置函数抛出异常时值不进入池。
+ */
+void test_reset_failure()
+{
+    RecyclePool<int> pool(4, [](int& v) {
+        if (v < 0)
+            throw std::runtime_error("cannot reset");
+        v = 0;
+    });
+    {
+        RecyclingLazy<int> bad(pool, [] { return -1; });
+        RecyclingLazy<int> good(pool, [] { return 9; });
+        assert(*bad == -1 && *good == 9);
+    }
+    assert(pool.size() == 1);
+    assert(pool.discarded_count() == 1);
+    RecyclingLazy<int> next(pool, [] { return 1; });
+    assert(*next == 0 && next.is_recycled());
+    std::cout << "[OK] test_reset_failure" << std::endl;
+}
+
+/**
+ * @brief 测试大量线程反复创建和退出。
+ */
+void test_thread_churn()
+{
+    RecyclePool<std::vector<int>> pool(4);
+    std::atomic<int> inits{0};
+    for (int round = 0; round < 20; ++round)
+    {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&] {
+                thread_local RecyclingLazy<std::vector<int>> buffer(pool, [&] {
+                    ++inits;
+                    return std::vector<int>(256);
+                });
+                assert(buffer->size() == 256);
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+    }
+    // 同时存活的线程不超过 4 个，池的容量也是 4：只有池为空时才新建，值的总数不会超过 4
+    assert(inits >= 1 && inits <= 4);
+    assert(pool.discarded_count() == 0);
+    assert(pool.reused_count() + static_cast<std::uint64_t>(inits) == 80);
+    std::cout << "[OK] test_thread_churn" << std::endl;
+}
+
+int main()
+{
+    test_reuse_across_threads();
+    test_bounded_pool();
+    test_reset_failure();
+    test_thread_churn();
+    return 0;
+}
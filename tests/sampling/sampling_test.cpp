@@ -0,0 +1,156 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/lazy.h>
+#include <cxxlazy/components/metrics.h>
+#include <cxxlazy/components/watchdog.h>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <cassert>
+
+using namespace components;
+
+/**
+ * @brief 反复重置并重新初始化一个单元
+ */
+void cycle(Lazy<int>& lazy, int times)
+{
+    for (int i = 0; i < times; ++i)
+    {
+        lazy.get();
+        lazy.reset();
+    }
+}
+
+/**
+ * @brief 测试全局 1/N 采样。
+ *
+ * 验证：
+ * 1. 计数器保持精确。
+ * 2. 被计时的次数大约是 1/N。
+ */
+void test_global_one_in_n()
+{
+    sampling::set_global(SamplingPolicy{4, std::chrono::nanoseconds(0)});
+    Lazy<int> lazy("one_in_four", [] { return 1; });
+    cycle(lazy, 4000);
+
+    auto s = lazy.stats()->snapshot();
+    assert(s.init_count == 4000);
+    assert(s.reset_count == 4000);
+    assert(s.init_sampled_count > 700 && s.init_sampled_count < 1300);
+
+    sampling::set_global(SamplingPolicy{});
+    std::cout << "[OK] test_global_one_in_n, sampled=" << s.init_sampled_count << std::endl;
+}
+
+/**
+ * @brief 测试按名称设置的采样策略覆盖全局策略。
+ */
+void test_per_cell_policy()
+{
+    sampling::set_global(SamplingPolicy{0, std::chrono::nanoseconds(0)});
+    LazyRegistry::instance().set_sampling("always", SamplingPolicy{});
+
+    Lazy<int> always("always", [] { return 1; });
+    Lazy<int> never("never", [] { return 1; });
+    cycle(always, 100);
+    cycle(never, 100);
+
+    assert(always.stats()->snapshot().init_sampled_count == 100);
+    assert(never.stats()->snapshot().init_sampled_count == 0);
+    assert(never.stats()->snapshot().init_count == 100);
+
+    sampling::set_global(SamplingPolicy{});
+    std::cout << "[OK] test_per_cell_policy" << std::endl;
+}
+
+/**
+ * @brief 测试按时间周期采样，每个单元在一个周期内最多计时一次。
+ *
+ * 验证：
+ * 1. 同一个单元在不同线程上初始化，周期内合计只计时一次。
+ * 2. 截止时间按单元保存：同一线程上的另一个单元不受前一个单元的周期影响。
+ */
+void test_time_based()
+{
+    Lazy<int> lazy("periodic", [] { return 1; });
+    Lazy<int> other("periodic.other", [] { return 2; });
+    LazyRegistry::instance().set_sampling("periodic", SamplingPolicy{1, std::chrono::hours(1)});
+    LazyRegistry::instance().set_sampling("periodic.other", SamplingPolicy{1, std::chrono::hours(1)});
+    cycle(lazy, 100);
+    std::thread([&] { cycle(lazy, 100); }).join();
+    cycle(other, 100);
+
+    assert(lazy.stats()->snapshot().init_sampled_count == 1);
+    assert(lazy.stats()->snapshot().init_count == 200);
+    assert(other.stats()->snapshot().init_sampled_count == 1);
+    std::cout << "[OK] test_time_based" << std::endl;
+}
+
+/**
+ * @brief 测试指标按采样比例放大，并导出采样比例。
+ */
+void test_scaled_metrics()
+{
+    Lazy<int> lazy("scaled", [] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        return 1;
+    });
+    LazyRegistry::instance().set_sampling("scaled", SamplingPolicy{2, std::chrono::nanoseconds(0)});
+    cycle(lazy, 100);
+
+    std::string text = render_prometheus();
+    auto key = std::string("cxxlazy_init_duration_seconds_sum{lazy=\"scaled\"} ");
+    auto pos = text.find(key);
+    assert(pos != std::string::npos);
+    double sum = std::stod(text.substr(pos + key.size()));
+    assert(sum >= 0.15);
+    assert(text.find("cxxlazy_init_duration_sample_ratio{lazy=\"scaled\"} ") != std::string::npos);
+    assert(text.find("cxxlazy_init_duration_seconds_count{lazy=\"scaled\"} 100\n") != std::string::npos);
+
+    std::cout << "[OK] test_scaled_metrics, sum=" << sum << std::endl;
+}
+
+/**
+ * @brief 测试未被计时的初始化仍然会被看门狗发现。
+ */
+void test_watchdog_without_timing()
+{
+    sampling::set_global(SamplingPolicy{0, std::chrono::nanoseconds(0)});
+    std::atomic<bool> release{false};
+    Lazy<int> stuck("untimed", [&] {
+        while (!release.load())
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        return 1;
+    });
+
+    InitWatchdog::Options options;
+    options.budget = std::chrono::milliseconds(30);
+    options.interval = std::chrono::hours(1);
+    InitWatchdog watchdog(options);
+
+    std::thread owner([&] { stuck.get(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    assert(watchdog.scan().empty());
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto found = watchdog.scan();
+    assert(found.size() == 1 && found[0].name == "untimed");
+
+    release = true;
+    owner.join();
+    sampling::set_global(SamplingPolicy{});
+    std::cout << "[OK] test_watchdog_without_timing" << std::endl;
+}
+
+int main()
+{
+    test_global_one_in_n();
+    test_per_cell_policy();
+    test_time_based();
+    test_scaled_metrics();
+    test_watchdog_without_timing();
+    return 0;
+}
@@ -0,0 +1,195 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/single_flight.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+/**
+ * @brief 启动一次被阻塞的执行，并让若干调用者加入
+ * @return 所有调用者（包括执行者）的 future
+ */
+template <typename Fn>
+std::vector<std::future<int>> join_flight(SingleFlight<std::string, int>& flight, std::shared_future<void> release,
+                                          std::atomic<int>& executions, Fn result, int joiners)
+{
+    std::promise<void> started;
+    std::vector<std::future<int>> futures;
+    futures.push_back(std::async(std::launch::async, [&, release, result] {
+        return flight.run("key", [&, release, result] {
+            executions++;
+            started.set_value();
+            release.wait();
+            return result();
+        });
+    }));
+    started.get_future().wait();
+
+    std::atomic<int> entered{0};
+    for (int i = 0; i < joiners; ++i)
+    {
+        futures.push_back(std::async(std::launch::async, [&] {
+            entered++;
+            return flight.run("key", [&] {
+                executions++;
+                return -1;
+            });
+        }));
+    }
+    while (entered.load() < joiners)
+        std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    return futures;
+}
+
+/**
+ * @brief 测试并发调用共享一次执行。
+ *
+ * 验证：
+ * 1. 执行期间到达的调用者不会再次执行，而是拿到同一个结果。
+ * 2. 执行结束后键被移除，下一次调用重新执行。
+ */
+void test_shared_execution()
+{
+    SingleFlight<std::string, int> flight;
+    std::atomic<int> executions{0};
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+
+    auto futures = join_flight(flight, released, executions, [] { return 7; }, 4);
+    assert(flight.in_flight() == 1);
+    release.set_value();
+    for (auto& f : futures)
+        assert(f.get() == 7);
+    assert(executions == 1);
+    assert(flight.in_flight() == 0);
+
+    assert(flight.run("key", [](const std::string& key) { return static_cast<int>(key.size()); }) == 3);
+    assert(flight.run("key", [] { return 8; }) == 8);
+    std::cout << "[OK] test_shared_execution" << std::endl;
+}
+
+/**
+ * @brief 测试异常在共享调用者之间传播。
+ *
+ * 验证：
+ * 1. 所有共享这次执行的调用者都收到同一个异常，没有调用者接手重新执行。
+ * 2. 失败之后键被移除，下一次调用重新执行。
+ */
+void test_shared_exception()
+{
+    SingleFlight<std::string, int> flight;
+    std::atomic<int> executions{0};
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+
+    auto futures = join_flight(flight, released, executions,
+                               []() -> int { throw std::runtime_error("backend down"); }, 3);
+    release.set_value();
+    for (auto& f : futures)
+    {
+        try
+        {
+            f.get();
+            assert(false);
+        }
+        catch (const std::runtime_error& e)
+        {
+            assert(std::string(e.what()) == "backend down");
+        }
+    }
+    assert(executions == 1);
+    assert(flight.in_flight() == 0);
+    assert(flight.run("key", [] { return 1; }) == 1);
+    std::cout << "[OK] test_shared_exception" << std::endl;
+}
+
+/**
+ * @brief 第二次移动时抛出异常的值：第一次移动发生在执行函数内部，第二次发生在 OnceCell 存储结果时
+ */
+struct FlakyMove
+{
+    explicit FlakyMove(int v) : value(v)
+    {
+    }
+
+    FlakyMove(const FlakyMove&) = default;
+
+    FlakyMove(FlakyMove&& other) : value(other.value)
+    {
+        if (++moves == 2)
+            throw std::runtime_error("move failed");
+    }
+
+    static inline int moves = 0;
+    int value;
+};
+
+/**
+ * @brief 测试 get_or_init 本身抛出异常时键仍被移除。
+ *
+ * 验证：
+ * 1. 异常传播给执行者。
+ * 2. 进行中表里不会留下这次调用，下一次调用重新执行并得到新的结果。
+ */
+void test_owner_exception_erases_key()
+{
+    SingleFlight<std::string, FlakyMove> flight;
+    try
+    {
+        flight.run("key", [] { return FlakyMove(1); });
+        assert(false);
+    }
+    catch (const std::runtime_error& e)
+    {
+        assert(std::string(e.what()) == "move failed");
+    }
+    assert(flight.in_flight() == 0);
+    assert(flight.run("key", [] { return FlakyMove(2); }).value == 2);
+    assert(flight.in_flight() == 0);
+    std::cout << "[OK] test_owner_exception_erases_key" << std::endl;
+}
+
+/**
+ * @brief 测试不同的键互不影响。
+ */
+void test_independent_keys()
+{
+    SingleFlight<int, int> flight;
+    std::vector<std::thread> threads;
+    std::atomic<bool> ok{true};
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 1000; ++i)
+            {
+                const int key = (i + t) % 16;
+                if (flight.run(key, [](int k) { return k * 10; }) != key * 10)
+                    ok = false;
+            }
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+    assert(ok);
+    assert(flight.in_flight() == 0);
+    std::cout << "[OK] test_independent_keys" << std::endl;
+}
+
+int main()
+{
+    test_shared_execution();
+    test_shared_exception();
+    test_owner_exception_erases_key();
+    test_independent_keys();
+    return 0;
+}
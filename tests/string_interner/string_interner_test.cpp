@@ -0,0 +1,144 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/string_interner.h>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+// 默认构造是 constexpr，全局驻留表常量初始化
+static StringInterner global_symbols;
+
+/**
+ * @brief 测试基本的驻留与查找。
+ *
+ * 验证：
+ * 1. 相同内容的字符串得到相同的 id，id 从 0 开始连续分配。
+ * 2. find 不会插入新字符串。
+ * 3. 返回的 string_view 不指向调用方的缓冲区，在后续大量插入之后仍然有效。
+ */
+void test_basic()
+{
+    StringInterner interner;
+    assert(interner.size() == 0);
+    assert(!interner.find("alpha"));
+
+    std::string buffer = "alpha";
+    const auto alpha = interner.intern(buffer);
+    assert(alpha == 0);
+    assert(interner.intern("beta") == 1);
+    assert(interner.intern(std::string("alpha")) == alpha);
+    assert(interner.find("alpha") == alpha);
+    assert(!interner.find("gamma"));
+    assert(interner.size() == 2);
+
+    const std::string_view view = interner.view(alpha);
+    assert(view.data() != buffer.data());
+    buffer = "changed";
+
+    for (int i = 0; i < 20000; ++i)
+        assert(interner.intern("key-" + std::to_string(i)) == static_cast<StringInterner::Id>(i + 2));
+    assert(interner.size() == 20002);
+    assert(interner.view(alpha).data() == view.data());
+    assert(view == "alpha");
+    assert(interner.view(12345 + 2) == "key-12345");
+    assert(interner.find("key-19999") == 20001u);
+    assert(interner.arena_bytes() > 0);
+    std::cout << "[OK] test_basic" << std::endl;
+}
+
+/**
+ * @brief 测试空字符串、长字符串和包含 '\0' 的字符串。
+ */
+void test_edge_cases()
+{
+    StringInterner interner;
+    const auto empty = interner.intern("");
+    assert(interner.intern(std::string_view{}) == empty);
+    assert(interner.view(empty).empty());
+
+    const std::string large(200000, 'x');
+    const auto big = interner.intern(large);
+    assert(interner.view(big) == large);
+    assert(interner.arena_bytes() >= large.size());
+
+    const std::string_view with_nul("a\0b", 3);
+    const auto nul = interner.intern(with_nul);
+    assert(nul != interner.intern("a"));
+    assert(interner.view(nul) == with_nul);
+
+    const std::string_view stable = global_symbols.intern_view("global");
+    assert(global_symbols.intern_view("global").data() == stable.data());
+    assert(&StringInterner::global() == &StringInterner::global());
+    std::cout << "[OK] test_edge_cases" << std::endl;
+}
+
+/**
+ * @brief 测试并发驻留。
+ *
+ * 验证：
+ * 1. 多个线程同时驻留同一组字符串，每个字符串只分配一个 id。
+ * 2. 并发的 find 要么找不到，要么返回与最终一致的 id。
+ */
+void test_concurrent()
+{
+    constexpr int kThreads = 8;
+    constexpr int kKeys = 5000;
+    StringInterner interner;
+    std::vector<std::vector<StringInterner::Id>> ids(kThreads, std::vector<StringInterner::Id>(kKeys));
+    std::atomic<bool> done{false};
+    std::atomic<bool> ok{true};
+
+    std::thread reader([&] {
+        while (!done.load())
+        {
+            for (int i = 0; i < kKeys; i += 97)
+            {
+                const std::string key = "k" + std::to_string(i);
+                if (auto id = interner.find(key); id && interner.view(*id) != key)
+                    ok = false;
+            }
+        }
+    });
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        workers.emplace_back([&, t] {
+            // 每个线程以不同的顺序驻留同一组字符串
+            for (int n = 0; n < kKeys; ++n)
+            {
+                const int i = (n * 7 + t * 613) % kKeys;
+                ids[static_cast<std::size_t>(t)][static_cast<std::size_t>(i)] = interner.intern("k" + std::to_string(i));
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    done = true;
+    reader.join();
+
+    assert(ok);
+    assert(interner.size() == static_cast<std::size_t>(kKeys));
+    for (int i = 0; i < kKeys; ++i)
+    {
+        const auto id = ids[0][static_cast<std::size_t>(i)];
+        assert(interner.view(id) == "k" + std::to_string(i));
+        for (int t = 1; t < kThreads; ++t)
+            assert(ids[static_cast<std::size_t>(t)][static_cast<std::size_t>(i)] == id);
+    }
+    std::cout << "[OK] test_concurrent" << std::endl;
+}
+
+int main()
+{
+    test_basic();
+    test_edge_cases();
+    test_concurrent();
+    return 0;
+}
@@ -0,0 +1,109 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/thread_specific_lazy.h>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+/**
+ * @brief 测试每个线程一份实例，且线程退出后实例仍可汇总。
+ *
+ * 验证：
+ * 1. 同一线程多次访问得到同一个实例，初始化函数每个线程只调用一次。
+ * 2. 线程结束后，combine 和 for_each 仍能访问它们的实例。
+ */
+void test_per_thread_combine()
+{
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 10000;
+    std::atomic<int> inits{0};
+    ThreadSpecificLazy<std::uint64_t> counter([&] {
+        ++inits;
+        return std::uint64_t{0};
+    });
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        workers.emplace_back([&] {
+            std::uint64_t* first = &counter.local();
+            for (int i = 0; i < kPerThread; ++i)
+                ++*counter;
+            assert(&counter.local() == first);
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+
+    assert(inits == kThreads);
+    assert(counter.size() == static_cast<std::size_t>(kThreads));
+    assert(counter.combine([](std::uint64_t a, std::uint64_t b) { return a + b; }) ==
+        static_cast<std::uint64_t>(kThreads) * kPerThread);
+
+    int visited = 0;
+    counter.for_each([&](const std::uint64_t& n) {
+        assert(n == kPerThread);
+        ++visited;
+    });
+    assert(visited == kThreads);
+    std::cout << "[OK] test_per_thread_combine" << std::endl;
+}
+
+/**
+ * @brief 测试 clear 之后各线程重新初始化，以及空对象的 combine。
+ */
+void test_clear()
+{
+    int inits = 0;
+    ThreadSpecificLazy<int> value([&] { return ++inits * 10; });
+    assert(value.combine([](int a, int b) { return a + b; }) == 10);
+    assert(value.size() == 0);
+
+    assert(value.local() == 20);
+    assert(value.local() == 20);
+    value.clear();
+    assert(value.size() == 0);
+    assert(value.local() == 30);
+    assert(value.size() == 1);
+    std::cout << "[OK] test_clear" << std::endl;
+}
+
+/**
+ * @brief 测试对象析构后槽位下标被复用时，线程不会拿到旧对象的实例。
+ */
+void test_index_reuse()
+{
+    for (int round = 0; round < 100; ++round)
+    {
+        auto a = std::make_unique<ThreadSpecificLazy<int>>([round] { return round; });
+        assert(a->local() == round);
+        a.reset();
+        ThreadSpecificLazy<int> b([] { return -1; });
+        assert(b.local() == -1);
+    }
+
+    // 同时存在大量对象，槽位表需要多次扩容
+    std::vector<std::unique_ptr<ThreadSpecificLazy<int>>> many;
+    for (int i = 0; i < 200; ++i)
+        many.push_back(std::make_unique<ThreadSpecificLazy<int>>([i] { return i; }));
+    for (int i = 199; i >= 0; --i)
+        assert(many[static_cast<std::size_t>(i)]->local() == i);
+    for (int i = 0; i < 200; ++i)
+        assert(many[static_cast<std::size_t>(i)]->local() == i);
+    std::cout << "[OK] test_index_reuse" << std::endl;
+}
+
+int main()
+{
+    test_per_thread_combine();
+    test_clear();
+    test_index_reuse();
+    return 0;
+}
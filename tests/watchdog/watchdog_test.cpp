@@ -0,0 +1,103 @@
+//
+// Created by uyplayer on 2026/10/17.
+//
+#include <cxxlazy/components/lazy.h>
+#include <cxxlazy/components/watchdog.h>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+using namespace components;
+
+/**
+ * @brief 测试看门狗报告卡住的初始化。
+ *
+ * 验证：
+ * 1. 超出预算的初始化被报告，且只报告一次。
+ * 2. 报告包含名称、初始化线程和等待线程数。
+ * 3. 没有超出预算的单元不会被报告。
+ */
+void test_stuck_initializer()
+{
+    std::mutex reports_mtx;
+    std::vector<StuckInit> reports;
+
+    std::atomic<bool> release{false};
+    std::thread::id init_thread;
+    Lazy<int> stuck("stuck", [&] {
+        init_thread = std::this_thread::get_id();
+        while (!release.load())
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        return 1;
+    });
+
+    InitWatchdog::Options options;
+    options.budget = std::chrono::milliseconds(50);
+    options.interval = std::chrono::milliseconds(10);
+    options.on_stuck = [&](const StuckInit& s) {
+        std::lock_guard<std::mutex> lock(reports_mtx);
+        reports.push_back(s);
+    };
+    InitWatchdog watchdog(options);
+
+    std::thread owner([&] { stuck.get(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::thread waiter([&] { stuck.get(); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    {
+        std::lock_guard<std::mutex> lock(reports_mtx);
+        assert(reports.size() == 1);
+        assert(reports[0].name == "stuck");
+        assert(reports[0].thread == owner.get_id());
+        assert(reports[0].elapsed >= std::chrono::milliseconds(50));
+        assert(reports[0].waiters == 1);
+    }
+
+    release = true;
+    owner.join();
+    waiter.join();
+    assert(init_thread == reports[0].thread);
+    assert(watchdog.scan().empty());
+
+    std::cout << "[OK] test_stuck_initializer" << std::endl;
+}
+
+/**
+ * @brief 测试按名称覆盖预算。
+ */
+void test_per_cell_budget()
+{
+    std::atomic<bool> release{false};
+    Lazy<int> patient("patient", [&] {
+        while (!release.load())
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        return 1;
+    });
+
+    InitWatchdog::Options options;
+    options.budget = std::chrono::milliseconds(10);
+    options.budgets["patient"] = std::chrono::hours(1);
+    options.on_stuck = [](const StuckInit&) { assert(false); };
+    InitWatchdog watchdog(options);
+
+    std::thread owner([&] { patient.get(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    assert(watchdog.scan().empty());
+
+    release = true;
+    owner.join();
+    watchdog.stop();
+
+    std::cout << "[OK] test_per_cell_budget" << std::endl;
+}
+
+int main()
+{
+    test_stuck_initializer();
+    test_per_cell_budget();
+    return 0;
+}